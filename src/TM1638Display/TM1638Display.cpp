@@ -3,6 +3,8 @@
 #include "TM1638Display.h"
 #include "../dataClass/dataClass.h"
 #include "../config.h"
+#include "../binLog/binLog.h"
+#include "../keyScan/keyScan.h"
 
 //#define LSBFIRST 1
 #define SMARTCONFIG_WAIT "SC__0000"   // SmartConfig 대기 표시
@@ -41,76 +43,52 @@ const uint8_t TM1638Display::DIGITS_TABLE[] = {
   0x76, /* x */   0x6E, /* y */   0x5B, /* z */
 };
 
+uint8_t TM1638Display::_glyph[256];
+
 TM1638Display::TM1638Display(uint8_t pinSTB, uint8_t pinCLK, uint8_t pinDIO, uint8_t brightness)
   : _pinSTB(pinSTB), _pinCLK(pinCLK), _pinDIO(pinDIO), _brightness(brightness) {
   memset(_displaySegment, 0, sizeof(_displaySegment));
+  memset(_sentGrid, 0, sizeof(_sentGrid));
 }
 
 void TM1638Display::begin() {
-  pinMode(_pinSTB, OUTPUT);
-  pinMode(_pinCLK, OUTPUT);
-  pinMode(_pinDIO, OUTPUT);
+  _bus.begin(_pinSTB, _pinCLK, _pinDIO);
 
-  digitalWrite(_pinSTB, HIGH);
-  digitalWrite(_pinCLK, HIGH);
-  digitalWrite(_pinDIO, LOW);
+  // 글리프 테이블: ASCII 0x30('0') ~ 0x7a('z') → DIGITS_TABLE[c - 48]
+  for (int c = 0; c < 256; c++) {
+    _glyph[c] = (c >= 0x30 && c <= 0x7a) ? DIGITS_TABLE[c - 48] : 0;
+  }
   
   delay(100);  // 충분한 대기
 
   Serial.printf("TM1638 init: STB=%d CLK=%d DIO=%d Brightness=%d\n", _pinSTB, _pinCLK, _pinDIO, _brightness);
 
   // 1. 데이터 설정: 자동 증가 모드(0x40)
-  sendCommand(0x40);
+  _bus.command(TM_WRITE_INC);
   delay(1);
   
   // 2. 디스플레이 클리어
   displayClear();
   
   // 3. 디스플레이 ON + 설정된 밝기
-  sendCommand(0x88 | _brightness);
+  _bus.command(0x88 | _brightness);
   
   Serial.println("TM1638 initialized");
 }
 
-void TM1638Display::shiftOut(uint8_t bitOrder, uint8_t val)
-{
-    uint8_t i;
-
-    for (i = 0; i < 8; i++)  {
-        if (bitOrder == LSBFIRST)
-            digitalWrite(_pinDIO, !!(val & (1 << i)));
-        else
-            digitalWrite(_pinDIO, !!(val & (1 << (7 - i))));
-
-        digitalWrite(_pinCLK, HIGH);
-        digitalWrite(_pinCLK, LOW);
-    }
-}
-
-
-void TM1638Display::sendData(uint8_t data)
-{
-  shiftOut(LSBFIRST, data);
-}
-
 void TM1638Display::displayClear() {
-  sendCommand(0x40); // 자동 증가 모드
-  
-  digitalWrite(_pinSTB, LOW);
-  writeByte(0xC0);   // 시작 주소 0
-  
-  for (uint8_t position = 0; position < 16; position++) {
-    writeByte(0x00); // 모든 세그먼트 클리어
-  }
-  
-  digitalWrite(_pinSTB, HIGH);
+  static const uint8_t blank[16] = {0};
+  _bus.writeBurst(0, blank, sizeof(blank));  // 자동 증가 모드로 16바이트 클리어
+  memcpy(_sentGrid, blank, sizeof(_sentGrid));
+  _sentValid = true;
+  _lastFullMs = millis();
 }
 
 void TM1638Display::brightness(uint8_t brightness)
 {
   uint8_t  value = 0;
   value = TM_BRIGHT_ADR + (TM_BRIGHT_MASK & brightness);
-  sendCommand(value);
+  _bus.command(value);
 }
 
 void TM1638Display::clear() {
@@ -172,17 +150,9 @@ void TM1638Display::setNumber(uint8_t pos, int num, uint8_t len) {
 //   }
 // }
 void TM1638Display::setString(uint8_t pos, const char* string, uint8_t len) {
+  // 범위 밖(0x30 미만, 0x7a 초과)은 _glyph에서 0 → 공백
   for (int i = 0; i < len; i++) {
-    // ASCII 범위 체크: 0x30('0') ~ 0x7a('z')
-    if (string[i] < 0x30 || string[i] > 0x7a) {
-      _displaySegment[pos + i] = 0;  // 범위 밖이면 공백
-    } else {
-      // 테이블 인덱스 = ASCII 코드 - 48
-      // '0'(0x30) → 0, '9'(0x39) → 9
-      // 'A'(0x41) → 17, 'Z'(0x5A) → 42
-      // 'a'(0x61) → 49, 'z'(0x7a) → 74
-      _displaySegment[pos + i] = DIGITS_TABLE[string[i] - 48];
-    }
+    _displaySegment[pos + i] = _glyph[(uint8_t)string[i]];
   }
 }
 
@@ -218,78 +188,29 @@ void TM1638Display::displayDualTemp(uint16_t temp, uint16_t setTemp) {
 }
 
 void TM1638Display::setDigitRaw(uint8_t pos, uint8_t segments) {
-  sendCommand(0x44); // 고정 주소 모드
-  
-  digitalWrite(_pinSTB, LOW);
-  writeByte(0xC0 + (pos * 2));  // 주소는 2씩 증가 (C0, C2, C4, ...)
-  writeByte(segments);
-  digitalWrite(_pinSTB, HIGH);
+  _bus.writeFixed(pos * 2, segments);  // 고정 주소 모드, 주소는 2씩 증가 (C0, C2, C4, ...)
+  _sentGrid[(pos * 2) & 0x0F] = segments;  // 칩 내용과 front 버퍼 일치 유지
 }
 
 void TM1638Display::setBrightness(uint8_t brightness) {
   _brightness = brightness & 0x0F;
-  sendCommand(0x80 | _brightness);
-}
-
-void TM1638Display::writeBit(bool bitVal) {
-  //digitalWrite(_pinCLK, LOW);
-  digitalWrite(_pinDIO, bitVal ? HIGH : LOW);
-  digitalWrite(_pinCLK, HIGH);
-  digitalWrite(_pinCLK, LOW);
+  _bus.command(0x80 | _brightness);
 }
 
-void TM1638Display::writeByte(uint8_t data) {
-  for (int i = 0; i < 8; i++) {
-    digitalWrite(_pinCLK, LOW);
-    digitalWrite(_pinDIO, (data & 0x01) ? HIGH : LOW);
-    data >>= 1;
-    digitalWrite(_pinCLK, HIGH);
-  }
-}
-
-void TM1638Display::sendCommand(uint8_t cmd) {
-  digitalWrite(_pinSTB, LOW);
-  writeByte(cmd);
-  digitalWrite(_pinSTB, HIGH);
-}
-
-// uint8_t TM1638Display::receiveByte() {
-//   uint8_t temp = 0;
-//   pinMode(_pinDIO, INPUT);
-  
-//   for (int i = 0; i < 8; i++) {
-//     temp >>= 1;
-//     digitalWrite(_pinCLK, LOW);
-//     if (digitalRead(_pinDIO)) {
-//       temp |= 0x80;
-//     }
-//     digitalWrite(_pinCLK, HIGH);
-//   }
-  
-//   pinMode(_pinDIO, OUTPUT);
-//   return temp;
-// }
-
-uint8_t TM1638Display::receive()
-{
-  uint8_t temp = 0;
-  
-  for (int i = 0; i < 8; i++) {
-    temp >>= 1;
-    digitalWrite(_pinCLK, LOW);
-    
-    if (digitalRead(_pinDIO)) {
-      temp |= 0x80;
-    }
-    
-    digitalWrite(_pinCLK, HIGH);
-  }
-  
-  return temp;
-}
-
-bool TM1638Display::getBit(uint8_t pos, uint8_t bit) {
-  return (_displaySegment[pos] >> bit) & 0x01;
+// 8x8 비트 전치: in[s]의 bit k → out[k]의 bit s
+// 32비트 워드 2개로 delta swap 3단계 (7/14/4비트), 분기 없음
+void TM1638Display::transpose8(const uint8_t in[8], uint8_t out[8]) {
+  uint32_t x, y, t;
+  memcpy(&x, in, 4);
+  memcpy(&y, in + 4, 4);
+  t = (x ^ (x >> 7)) & 0x00AA00AAUL;  x ^= t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AAUL;  y ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCCUL; x ^= t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCCUL; y ^= t ^ (t << 14);
+  t = (x & 0x0F0F0F0FUL) | ((y << 4) & 0xF0F0F0F0UL);
+  y = ((x >> 4) & 0x0F0F0F0FUL) | (y & 0xF0F0F0F0UL);
+  memcpy(out, &t, 4);
+  memcpy(out + 4, &y, 4);
 }
 
 // void TM1638Display::sendToDisplay() {
@@ -320,27 +241,10 @@ void TM1638Display::setLED() {
 }
 
 
-void TM1638Display::displaySegments(uint8_t segment, uint16_t digit)
-{
-  // sendCommand()는 begin()에서 한 번만 호출됨
-  // 여기서는 STB 제어와 데이터 전송만
-  digitalWrite(_pinSTB, LOW);
-  writeByte(TM_SEG_ADR | segment);  // 주소 0xC0-0xCE
-  writeByte(digit);  // 데이터
-  digitalWrite(_pinSTB, HIGH);
-}
-
 void TM1638Display::sendToDisplay() {
-  static bool sec_bling_flag = false;
-  static unsigned long last_blink_ms = 0;
-  static uint8_t debug_cnt = 0;
-  
-  // 1초마다 깜빡임 플래그 토글
+  // 1초 위상 깜빡임 - 시각에서 직접 계산해 갱신 주기와 무관하게 일정
   unsigned long now = millis();
-  if (now - last_blink_ms >= 1000) {
-    last_blink_ms = now;
-    sec_bling_flag = !sec_bling_flag;
-  }
+  bool sec_bling_flag = (now / 1000) & 1;
   
   char string[3];
   memset(_displaySegment,0,sizeof(_displaySegment));
@@ -414,41 +318,35 @@ void TM1638Display::sendToDisplay() {
     _displaySegment[8]=gCUR.led.data&0x02;
   }
 
-  uint8_t displayGrid[16] = {
-    0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0
-  };
-
-  // for (i = 0; i < 16; i++) Serial.printf("%0.2x ", displaySegment[i]);
-  // Serial.print("\n");
-  bool right = 0;
-  for (int seg = 0; seg < 16; seg++) {
-    if (seg >= 8) right = 1; //checking if we're on the left or right half of the table
-    else right = 0;
-    for (int grid = 0 + right; grid < 16; grid += 2) {
-      displayGrid[grid] |= getBit(seg, grid/2) << seg % 8;
-    }
+  // 세그먼트 → 그리드: 짝수 그리드 = seg[0..7] 전치, 홀수 그리드 = seg[8..15] 전치
+  uint8_t left[8], right[8];
+  uint8_t displayGrid[16];
+  transpose8(&_displaySegment[0], left);
+  transpose8(&_displaySegment[8], right);
+  for (int k = 0; k < 8; k++) {
+    displayGrid[2 * k] = left[k];
+    displayGrid[2 * k + 1] = right[k];
   }
-  // Serial.print("\n");
-  // for (i = 0; i < 16; i++) Serial.printf("%0.2x ", displayGrid[i]);
-  
-  // 디버그: 세그먼트와 그리드 데이터 출력
-  // if (debug_cnt == 0) {
-  //   Serial.print("Segment: ");
-  //   for (int i = 0; i < 8; i++) {
-  //     Serial.printf("%02X ", _displaySegment[i]);
-  //   }
-  //   Serial.print("\nGrid: ");
-  //   for (int i = 0; i < 16; i++) {
-  //     Serial.printf("%02X ", displayGrid[i]);
-  //   }
-  //   Serial.println();
-  // }
-  
-  for (int i=0; i < 16; i++) {
-    //tm.DisplaySegments(i, displayGrid[i]);
-    displaySegments(i, displayGrid[i]);
+
+  // 주기적으로 전체 재전송 (노이즈로 칩 RAM이 깨졌을 때 복구)
+  if (now - _lastFullMs >= FND_FULL_REFRESH_MS) {
+    _sentValid = false;
+  }
+
+  // front 버퍼와 비교해 변경된 구간 [first, last]만 전송
+  int first = 0, last = 15;
+  if (_sentValid) {
+    while (first < 16 && displayGrid[first] == _sentGrid[first]) first++;
+    if (first == 16) return;  // 변경 없음 → 버스 전송 생략
+    while (displayGrid[last] == _sentGrid[last]) last--;
+  } else {
+    _lastFullMs = now;
   }
+
+  // 자동 증가 모드 버스트 1회 (0x40 + 0xC0|first + 변경 구간)
+  _bus.writeBurst(first, &displayGrid[first], last - first + 1);
+  memcpy(&_sentGrid[first], &displayGrid[first], last - first + 1);
+  _sentValid = true;
 }
 
 //=============================================
@@ -461,270 +359,177 @@ void TM1638Display::beep() {
 
 //=============================================
 void  TM1638Display::key_process(){
-  static uint8_t ex_key=0;
-  static uint16_t key_press_cnt=0;
-  static unsigned long last_key_time = 0;  // 키 디바운싱용
   static unsigned long last_save_time = 0; // Flash 저장용
   static bool need_save = false;
-  static unsigned long pwr_press_start = 0;  // KEY_PWR long-press 타이머
-  static bool pwr_long_handled = false;      // long-press 처리 완료 플래그
-  uint8_t beef_on=0;
+  extern dataClass gData;
+  extern bool smartconfig_running;
+  extern bool smartconfig_request;
+  extern bool smartconfig_stop_request;
   uint8_t idamper;
-  uint8_t key = getButtons();
   int lval;
-  int max_temp=1000;//MAX_TEMP;
+  KEY_EVENT evt;
+
   // 3초 경과 후 Flash 저장
   if (need_save && (millis() - last_save_time >= 3000)) {
-    extern dataClass gData;
     gData.saveToFlash();
     need_save = false;
-    printf("Settings saved to flash\n");
+    LOGI("Settings saved to flash\n");
   }
-  // SmartConfig 모드 중에도 일반 키 처리 (soft_off 전환 시 리부팅)
-  extern bool smartconfig_running;
-  
-  if(gCUR.flg.soft_off){
-    // Power OFF 상태에서는 KEY_PWR만 처리 (다른 키는 무시)
-    if(key == KEY_PWR && ex_key == 0) {
-      // KEY_PWR을 처음 눌렀을 때
-      pwr_press_start = millis();
-      pwr_long_handled = false;
-      ex_key = key;
-    } else if(key == KEY_PWR && ex_key == KEY_PWR) {
-      // KEY_PWR을 계속 누르고 있을 때: 3초 체크
-      if (!pwr_long_handled && (millis() - pwr_press_start >= 3000)) {
-        // 3초 long-press: 즉시 SmartConfig 진입
-        extern bool smartconfig_request;
-        smartconfig_request = true;
-        pwr_long_handled = true;
-        beep();  // 즉시 피드백
-        printf("KEY_PWR Long Press (Power OFF) - SmartConfig Request\n");
-      }
-    } else if(key == KEY_NULL && ex_key == KEY_PWR) {
-      // KEY_PWR을 뗐을 때
-      if (!pwr_long_handled) {
-        // Long press 처리 안된 경우 = Short press: Power ON
-        extern dataClass gData;
-        gCUR.flg.soft_off = 0;
-        gCUR.error_info.data = 0;  // 에러 클리어
-        
-        // 남은 시간 체크: 00:00이면 DRY_FINISH, 아니면 DRY_RUN
-        if (gCUR.remaining_minute == 0) {
-          gCUR.dry_state = DRY_FINISH;
-          printf("KEY_PWR Short Press - Power ON, Time is 00:00, DRY_STATE: DRY_FINISH\n");
-        } else {
-          gCUR.dry_state = DRY_RUN;
-          printf("KEY_PWR Short Press - Power ON, DRY_STATE: DRY_RUN\n");
+
+  // 디바운스/반복/길게 누름은 키 스캐너가 처리 → 여기서는 이벤트만 소비
+  while (gKeys.pop(evt)) {
+    uint8_t key = evt.key;
+    bool pwr_short = (key == KEY_PWR && evt.type == KEY_EVT_RELEASE && evt.held_ms < KEY_LONG_PRESS_MS);
+
+    // KEY_PWR 3초 long-press: 전원 상태와 관계없이 즉시 SmartConfig 진입
+    if (key == KEY_PWR && evt.type == KEY_EVT_LONG) {
+      smartconfig_request = true;
+      beep();  // 즉시 피드백
+      LOGI("KEY_PWR Long Press (Power %s) - SmartConfig Request\n", gCUR.flg.soft_off ? "OFF" : "ON");
+      continue;
+    }
+
+    if(gCUR.flg.soft_off){
+      // Power OFF 상태에서는 KEY_PWR만 처리 (다른 키는 무시)
+      if (pwr_short) {
+        // Short press: Power ON (재부팅 없이 즉시 전환)
+        LOGI("KEY_PWR Short Press - Power ON\n");
+        gData.powerOn();  // 제어 상태 재초기화 + 팬 즉시 기동 + Flash 저장
+
+        // SmartConfig 모드 중이면 함께 종료 (loop에서 WiFi 재연결)
+        if (smartconfig_running) {
+          smartconfig_stop_request = true;
         }
-        
         beep();
-        
-        // Flash에 즉시 저장 후 시스템 재시작
-        printf("Saving Power ON state and Rebooting...\n");
-        gData.saveToFlash();
-        delay(100);  // 저장 완료 대기
-        ESP.restart();
       }
-      ex_key = 0;
-      pwr_press_start = 0;
-      pwr_long_handled = false;
-    } else if(key == KEY_NULL) {
-      ex_key = 0;
-      pwr_press_start = 0;
-      pwr_long_handled = false;
+      continue;
     }
-    return;
-  }
-  if(key ==KEY_NULL) {
-    // Power ON 상태에서 키를 뗐을 때
-    if(ex_key == KEY_PWR && !pwr_long_handled) {
-      // Long press 처리 안된 경우 = Short press: Power OFF
-      gCUR.flg.soft_off = 1;
-      beep();
-      printf("KEY_PWR Short Press - Power OFF\n");
-      
-      // SmartConfig 모드 중이면 Power ON 상태로 Flash 저장 후 시스템 리부팅
+
+    if (pwr_short) {
+      // SmartConfig 모드 중이면 Power ON 상태 유지, SmartConfig만 종료 (재부팅 없음)
       if (smartconfig_running) {
-        extern dataClass gData;
-        printf("SmartConfig running - Saving Power ON state and Rebooting\n");
-        gCUR.flg.soft_off = 0;  // Power ON 상태로 설정
-        gData.saveToFlash();     // Flash에 즉시 저장
-        delay(100);  // 저장 완료 대기
-        ESP.restart();
+        LOGI("SmartConfig running - Stop SmartConfig, keep Power ON\n");
+        smartconfig_stop_request = true;
+        gData.powerOn();
+        beep();
+        continue;
       }
-      
+
+      // Short press: Power OFF
+      gCUR.flg.soft_off = 1;
+      beep();
+      LOGI("KEY_PWR Short Press - Power OFF\n");
+
       // Flash에 저장 예약
       last_save_time = millis();
       need_save = true;
       // 주의: DRY_RUN → DRY_COOL 전환은 onSecondElapsed()에서 처리됨
+      continue;
     }
-    ex_key=0; key_press_cnt=0;
-    pwr_press_start = 0;  // KEY_PWR 타이머 리셋
-    pwr_long_handled = false;
-    return;
-  }
-  
-  // 키 디바운싱: 같은 키를 누르고 있으면 일정 시간 대기
-  // 단, KEY_PWR은 long press 감지를 위해 예외 처리
-  if(ex_key == key) {
-    key_press_cnt++;
-    // KEY_PWR은 long press 감지를 위해 매번 체크
-    if(key == KEY_PWR) {
-      // KEY_PWR은 디바운싱 없이 바로 처리
-    } else {
-      // 다른 키들은 디바운싱 적용
-      // 처음 누른 후 300ms 대기, 이후 100ms마다 반복
-      if(key_press_cnt == 1) {
-        last_key_time = millis();
-        // 첫 입력은 바로 처리 (아래로 계속)
-      } else {
-        unsigned long elapsed = millis() - last_key_time;
-        if(elapsed < 300) {
-          return;  // 첫 입력 후 300ms 대기
-        } else if((elapsed - 300) % 100 < 20) {
-          // 300ms 이후부터 100ms마다 반복
-          last_key_time = millis();
-        } else {
-          return;  // 아직 반복 타이밍 아님
-        }
-      }
-    }
-  } else {
-    // 새로운 키 입력
-    key_press_cnt = 1;
-    last_key_time = millis();
-  }
+
+    // 나머지 키: 처음 누름 + 자동 반복(300ms 후 100ms마다)
+    if (evt.type != KEY_EVT_PRESS && evt.type != KEY_EVT_REPEAT) continue;
 
 #ifdef DEBUG
-    printf("###key[%d]\r\n",key);
-  // printf("[%d]err_release_key_buf[%d][%d][%d][%d]\r\n",key err_release_key_buf[0], err_release_key_buf[1], err_release_key_buf[2], err_release_key_buf[3]);
+    LOGD("###key[%d]\r\n",key);
 #endif
 
-  switch(key){
-    case KEY_123:
-      break;
-    case KEY_TEMP_UP:
-    case KEY_TEMP_DN:
-      pwr_press_start = 0;  // KEY_PWR 타이머 리셋
-      pwr_long_handled = false;
-      
-      // 온도 설정 변경
-      lval = gCUR.seljung_temp;
-      lval = (key == KEY_TEMP_UP) ? lval + 1 : lval - 1;
-      
-      // 범위 제한 (0~70도)
-      if (lval > MAX_TEMPERATURE) lval = MAX_TEMPERATURE;
-      if (lval < MIN_TEMPERATURE) lval = MIN_TEMPERATURE;
-      
-      gCUR.seljung_temp = lval;
-      
-      // 3초 후 Flash 저장 예약
-      last_save_time = millis();
-      need_save = true;
-      
-      beep();  // 부저 소리
-      printf("Temp set: %d C\n", gCUR.seljung_temp);
-      break;
+    switch(key){
+      case KEY_123:
+        break;
+      case KEY_TEMP_UP:
+      case KEY_TEMP_DN:
+        // 온도 설정 변경
+        lval = gCUR.seljung_temp;
+        lval = (key == KEY_TEMP_UP) ? lval + 1 : lval - 1;
 
-    case KEY_TIME_UP:
-    case KEY_TIME_DN:
-      pwr_press_start = 0;  // KEY_PWR 타이머 리셋
-      pwr_long_handled = false;
-      
-      {
-        // 시간 설정 변경 (30분 단위, 00분 또는 30분으로 정렬)
-        lval = gCUR.remaining_minute;
-        
-        // 현재 값을 30분 단위로 정렬 (올림)
-        int remainder = lval % 30;
-        if (remainder != 0) {
-          lval = lval - remainder + 30;  // 다음 30분 단위로 올림
-        }
-        
-        // 증가/감소
-        lval = (key == KEY_TIME_UP) ? lval + 30 : lval - 30;
-        
-        // 범위 제한 (0~12000분)
-        if (lval > MAX_SET_TIME) lval = MAX_SET_TIME;
-        if (lval < MIN_SET_TIME) lval = MIN_SET_TIME;
-        
-        gCUR.remaining_minute = lval;
-        
-        // 상태 전환: 시간이 0보다 크면 DRY_RUN, 0이면 DRY_FINISH
-        if (gCUR.remaining_minute > 0) {
-          if (gCUR.dry_state == DRY_FINISH) {
-            gCUR.dry_state = DRY_RUN;
-            printf("Time set > 0: DRY_FINISH -> DRY_RUN\n");
+        // 범위 제한 (0~70도)
+        if (lval > MAX_TEMPERATURE) lval = MAX_TEMPERATURE;
+        if (lval < MIN_TEMPERATURE) lval = MIN_TEMPERATURE;
+
+        gCUR.seljung_temp = lval;
+
+        // 3초 후 Flash 저장 예약
+        last_save_time = millis();
+        need_save = true;
+
+        beep();  // 부저 소리
+        LOGI("Temp set: %d C\n", gCUR.seljung_temp);
+        break;
+
+      case KEY_TIME_UP:
+      case KEY_TIME_DN:
+        {
+          // 시간 설정 변경 (30분 단위, 00분 또는 30분으로 정렬)
+          lval = gCUR.remaining_minute;
+
+          // 현재 값을 30분 단위로 정렬 (올림)
+          int remainder = lval % 30;
+          if (remainder != 0) {
+            lval = lval - remainder + 30;  // 다음 30분 단위로 올림
           }
-        } else {
-          if (gCUR.dry_state == DRY_RUN) {
-            gCUR.dry_state = DRY_FINISH;
-            printf("Time set = 0: DRY_RUN -> DRY_FINISH\n");
+
+          // 증가/감소
+          lval = (key == KEY_TIME_UP) ? lval + 30 : lval - 30;
+
+          // 범위 제한 (0~12000분)
+          if (lval > MAX_SET_TIME) lval = MAX_SET_TIME;
+          if (lval < MIN_SET_TIME) lval = MIN_SET_TIME;
+
+          gCUR.remaining_minute = lval;
+
+          // 상태 전환: 시간이 0보다 크면 DRY_RUN, 0이면 DRY_FINISH
+          if (gCUR.remaining_minute > 0) {
+            if (gCUR.dry_state == DRY_FINISH) {
+              gCUR.dry_state = DRY_RUN;
+              LOGI("Time set > 0: DRY_FINISH -> DRY_RUN\n");
+            }
+          } else {
+            if (gCUR.dry_state == DRY_RUN) {
+              gCUR.dry_state = DRY_FINISH;
+              LOGI("Time set = 0: DRY_RUN -> DRY_FINISH\n");
+            }
           }
+
+          // 3초 후 Flash 저장 예약
+          last_save_time = millis();
+          need_save = true;
+
+          beep();  // 부저 소리
+          LOGI("Time set: %d min\n", gCUR.remaining_minute);
+        }
+        break;
+      case KEY_DAMPER:
+        // 댐퍼 자동 모드 토글 (0: 수동, 1: 자동)
+        idamper = gCUR.auto_damper;
+        idamper++;
+        idamper %= 2;  // 0 또는 1로 토글
+        gCUR.auto_damper = idamper;
+
+        // LED 업데이트
+        if(gCUR.auto_damper) {
+          // 자동 모드: AUTO LED 켜짐, OPEN/CLOSE는 히터 상태에 따라 결정됨
+          gCUR.led.damper_auto = 1;
+          // 초기값으로 OPEN 설정 (실제 상태는 controlHeater()에서 업데이트)
+          gCUR.led.damper_open = 1;
+          gCUR.led.damper_close = 0;
+        } else {
+          // 수동 모드: 댐퍼 열림 표시
+          gCUR.led.damper_auto = 0;
+          gCUR.led.damper_open = 1;
+          gCUR.led.damper_close = 0;
+          digitalWrite(PIN_DAMP, LOW);  // 댐퍼 열림(0)
         }
-        
+
         // 3초 후 Flash 저장 예약
         last_save_time = millis();
         need_save = true;
-        
+
         beep();  // 부저 소리
-        printf("Time set: %d min\n", gCUR.remaining_minute);
-      }
-      break;
-    case KEY_PWR:
-      // 키를 처음 눌렀을 때 타이머 시작
-      if (pwr_press_start == 0) {
-        pwr_press_start = millis();
-        pwr_long_handled = false;
-      } else if (!pwr_long_handled && (millis() - pwr_press_start >= 3000)) {
-        // 3초 long-press: 즉시 SmartConfig 진입
-        extern bool smartconfig_request;
-        smartconfig_request = true;
-        pwr_long_handled = true;
-        beep();  // 즉시 피드백
-        printf("KEY_PWR Long Press (Power ON) - SmartConfig Request\n");
-      }
-      // Short press는 키를 뗄 때 처리 (위의 KEY_NULL 블록)
-      break;
-    case KEY_DAMPER:
-      pwr_press_start = 0;  // KEY_PWR 타이머 리셋
-      pwr_long_handled = false;
-      
-      // 댐퍼 자동 모드 토글 (0: 수동, 1: 자동)
-      idamper = gCUR.auto_damper;
-      idamper++;
-      idamper %= 2;  // 0 또는 1로 토글
-      gCUR.auto_damper = idamper;
-      
-      // LED 업데이트
-      if(gCUR.auto_damper) {
-        // 자동 모드: AUTO LED 켜짐, OPEN/CLOSE는 히터 상태에 따라 결정됨
-        gCUR.led.damper_auto = 1;
-        // 초기값으로 OPEN 설정 (실제 상태는 controlHeater()에서 업데이트)
-        gCUR.led.damper_open = 1;
-        gCUR.led.damper_close = 0;
-      } else {
-        // 수동 모드: 댐퍼 열림 표시
-        gCUR.led.damper_auto = 0;
-        gCUR.led.damper_open = 1;
-        gCUR.led.damper_close = 0;
-        digitalWrite(PIN_DAMP, LOW);  // 댐퍼 열림(0)
-      }
-      
-      // 3초 후 Flash 저장 예약
-      last_save_time = millis();
-      need_save = true;
-      
-      beep();  // 부저 소리
-      printf("DAMPER mode: %s\n", gCUR.auto_damper ? "AUTO" : "MANUAL");
-      break;
+        LOGI("DAMPER mode: %s\n", gCUR.auto_damper ? "AUTO" : "MANUAL");
+        break;
+    }
   }
-  //one_ms_tick=0;
- // if(beef_on && Beep_flag==0) beep_on();
-  ex_key=(uint8_t)key;
-#ifdef DEBUG
- // printf("--key_process key[%d] key_press[%d]\r\n", key, key_press);
-#endif
 }
 
 
@@ -733,17 +538,7 @@ uint8_t TM1638Display::getButtons(void)
   KEY_BUF key_buf;
   uint8_t key=KEY_NULL;
 ///////////////////////////////////
-  digitalWrite(_pinSTB, LOW);
-  writeByte(0x42);
-  pinMode(_pinDIO, INPUT);  // 외부 풀업 사용
-  delayMicroseconds(50);
-  
-  for (int i = 0; i < 4; i++) {
-    key_buf.data[i] = receive();
-  }
-  
-  pinMode(_pinDIO, OUTPUT);
-  digitalWrite(_pinSTB, HIGH);
+  _bus.readKeys(key_buf.data);  // 0x42 + 4바이트 (DIO 외부 풀업)
 ///////////////////////////////////
   // 각 바이트의 비트를 확인하여 키 결정
   uint32_t all_bits = (key_buf.data[3] << 24) | (key_buf.data[2] << 16) | (key_buf.data[1] << 8) | key_buf.data[0];
@@ -753,12 +548,7 @@ uint8_t TM1638Display::getButtons(void)
   if(key_buf.data[0] != last_key0 || key_buf.data[1] != last_key1 || 
      key_buf.data[2] != last_key2 || key_buf.data[3] != last_key3) {
     if(key_buf.data[0] || key_buf.data[1] || key_buf.data[2] || key_buf.data[3]) {
-      printf(">>> KEY: %02X %02X %02X %02X (bits: ", key_buf.data[0], key_buf.data[1], key_buf.data[2], key_buf.data[3]);
-      // 어떤 비트가 켜졌는지 출력
-      for(int i=0; i<32; i++) {
-        if(all_bits & (1 << i)) printf("b%d ", i);
-      }
-      printf(")\r\n");
+      LOGD(">>> KEY: %02X %02X %02X %02X (bits: %08lX)\n", key_buf.data[0], key_buf.data[1], key_buf.data[2], key_buf.data[3], all_bits);
     }
     last_key0 = key_buf.data[0];
     last_key1 = key_buf.data[1];
@@ -793,7 +583,6 @@ uint8_t TM1638Display::getButtons(void)
   //tempup/tempdn/timedn
   if(key_buf.b.b6 && key_buf.b.b2 && key_buf.b.b18){
     key=KEY_123;
-    printf("#KEY_123\r\n");
   }
  #endif 
   return key;
@@ -2,21 +2,12 @@
 
 #pragma once
 #include <Arduino.h>
+#include "tm1638Bus.h"
+#include "keyMap.h"
 
 // 전역 변수 extern 선언
 extern bool system_start_flag;
 
-typedef enum _KEY_MAP{
-  KEY_NULL=0,
-  KEY_PWR,
-  KEY_TEMP_UP,
-  KEY_TEMP_DN,
-  KEY_TIME_UP,
-  KEY_TIME_DN,
-  KEY_DAMPER,
-  KEY_123,
-}KEY_MAP;
-
 typedef struct {
   uint8_t b0:1;
   uint8_t b1:1;
@@ -98,8 +89,8 @@ public:
   // LED 설정 (ledData: 8비트 LED 데이터)
  // void setLED(uint8_t ledData);
   
-  // 키 입력 읽기 (4바이트 키 데이터 반환)
-  //uint32_t getButtons();
+  // 키 스캔 1회 → KEY_MAP (키 스캐너 타이머에서 호출)
+  uint8_t getButtons(void);
   
 
   
@@ -107,7 +98,7 @@ public:
   void displayTime(uint16_t minute);
   // 온도 2개 표시 (현재온도, 설정온도)
   void displayDualTemp(uint16_t temp, uint16_t setTemp);
-  void key_process();
+  void key_process();  // 키 이벤트 큐 처리 (UI Task)
   void sendToDisplay();// 전체 디스플레이 업데이트
   void beep();  // 부저 소리 (50ms)
   
@@ -120,22 +111,22 @@ private:
   uint8_t _pinDIO;
   uint8_t _brightness;
   
-  // 디스플레이 세그먼트 버퍼 (8자리 + LED)
+  // 디스플레이 세그먼트 버퍼 (8자리 + LED) - 렌더링 대상 (back)
   uint8_t _displaySegment[16];
+  // 마지막으로 칩에 전송한 그리드 (front) - 변경된 바이트만 전송
+  uint8_t _sentGrid[16];
+  bool _sentValid = false;        // false면 다음 프레임 전체 전송
+  unsigned long _lastFullMs = 0;  // 마지막 전체 전송 시각
+
+  // ASCII → 세그먼트 (begin()에서 DIGITS_TABLE로 생성, 범위 밖은 0)
+  static uint8_t _glyph[256];
   
-  // Low-level 함수
-  void writeBit(bool bitVal);
-  void writeByte(uint8_t data);
-  void sendCommand(uint8_t cmd);
-  //uint8_t receiveByte();
-  uint8_t receive();
-  bool getBit(uint8_t pos, uint8_t bit);
+  // 버스 (GPIO 레지스터 직접 제어)
+  TM1638Bus _bus;
+
+  static void transpose8(const uint8_t in[8], uint8_t out[8]);
   void brightness(uint8_t brightness);
   void displayClear(void);
-  void sendData(uint8_t data);
-  void shiftOut(uint8_t bitOrder, uint8_t val);
   void setLED();
-  void displaySegments(uint8_t segment, uint16_t digit);
   void setString(uint8_t pos, const char* string, uint8_t len);
-  uint8_t getButtons(void);
 };
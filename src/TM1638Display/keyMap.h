@@ -0,0 +1,14 @@
+// keyMap.h - TM1638 키 코드 (Arduino 의존성 없음 - 호스트 테스트에서도 사용)
+
+#pragma once
+
+typedef enum _KEY_MAP{
+  KEY_NULL=0,
+  KEY_PWR,
+  KEY_TEMP_UP,
+  KEY_TEMP_DN,
+  KEY_TIME_UP,
+  KEY_TIME_DN,
+  KEY_DAMPER,
+  KEY_123,
+}KEY_MAP;
@@ -0,0 +1,156 @@
+// tm1638Bus.cpp - TM1638 버스 비트 전송 (LSB 먼저, CLK 상승 에지에서 래치)
+
+#include "tm1638Bus.h"
+#include "soc/gpio_struct.h"
+#include "driver/gpio.h"
+
+#define TM_CMD_WRITE_INC  0x40  // 자동 증가 쓰기
+#define TM_CMD_WRITE_FIX  0x44  // 고정 주소 쓰기
+#define TM_CMD_READ_KEY   0x42  // 키 스캔 읽기
+#define TM_ADDR_BASE      0xC0
+
+// ========== GPIO 레지스터 ==========
+inline void TM1638Bus::pinHigh(uint8_t pin) {
+  if (pin < 32) GPIO.out_w1ts = (1UL << pin);
+  else GPIO.out1_w1ts.val = (1UL << (pin - 32));
+}
+
+inline void TM1638Bus::pinLow(uint8_t pin) {
+  if (pin < 32) GPIO.out_w1tc = (1UL << pin);
+  else GPIO.out1_w1tc.val = (1UL << (pin - 32));
+}
+
+inline bool TM1638Bus::pinRead(uint8_t pin) {
+  if (pin < 32) return (GPIO.in >> pin) & 0x1;
+  return (GPIO.in1.data >> (pin - 32)) & 0x1;
+}
+
+// 출력 활성/해제만 바꿈 (pinMode의 IO MUX 재설정 생략) - 해제 시 외부 풀업으로 HIGH
+inline void TM1638Bus::pinOutput(uint8_t pin, bool enable) {
+  if (pin < 32) {
+    if (enable) GPIO.enable_w1ts = (1UL << pin);
+    else GPIO.enable_w1tc = (1UL << pin);
+  } else {
+    if (enable) GPIO.enable1_w1ts.val = (1UL << (pin - 32));
+    else GPIO.enable1_w1tc.val = (1UL << (pin - 32));
+  }
+}
+
+// 사이클 카운터 대기 (ns 단위, 최소 한 번은 확인)
+inline void TM1638Bus::waitNs(uint32_t ns) const {
+  uint32_t start = ESP.getCycleCount();
+  uint32_t cycles = (ns * _cyclesPerUs + 999) / 1000;
+  while (ESP.getCycleCount() - start < cycles) {
+  }
+}
+
+// ========== 버스 ==========
+void TM1638Bus::begin(uint8_t pinSTB, uint8_t pinCLK, uint8_t pinDIO) {
+  _stb = pinSTB;
+  _clk = pinCLK;
+  _dio = pinDIO;
+  _cyclesPerUs = getCpuFrequencyMhz();
+  if (_mutex == nullptr) _mutex = xSemaphoreCreateMutex();
+  // IO MUX/방향은 한 번만 설정, 이후에는 레지스터만 사용
+  pinMode(_stb, OUTPUT);
+  pinMode(_clk, OUTPUT);
+  gpio_set_direction((gpio_num_t)_dio, GPIO_MODE_INPUT_OUTPUT);  // 읽기 때 출력만 끄고 입력 유지
+  pinHigh(_stb);
+  pinHigh(_clk);
+  pinLow(_dio);
+}
+
+// 0x40/0x44/0x42 모드 명령과 뒤따르는 데이터 사이에 다른 트랜잭션이 끼면
+// 칩 모드가 바뀌므로 공개 메서드 전체를 잠근다
+void TM1638Bus::lock() {
+  if (_mutex) xSemaphoreTake(_mutex, portMAX_DELAY);
+}
+
+void TM1638Bus::unlock() {
+  if (_mutex) xSemaphoreGive(_mutex);
+}
+
+void TM1638Bus::strobeLow() {
+  pinLow(_stb);
+  waitNs(TM1638_CLK_HALF_NS);
+}
+
+void TM1638Bus::strobeHigh() {
+  waitNs(TM1638_CLK_HALF_NS);
+  pinHigh(_stb);
+  waitNs(TM1638_STB_HIGH_NS);
+}
+
+void TM1638Bus::writeByte(uint8_t data) {
+  for (uint8_t i = 0; i < 8; i++) {
+    pinLow(_clk);
+    if (data & 0x01) pinHigh(_dio);
+    else pinLow(_dio);
+    data >>= 1;
+    waitNs(TM1638_CLK_HALF_NS);
+    pinHigh(_clk);
+    waitNs(TM1638_CLK_HALF_NS);
+  }
+}
+
+// TM1638은 CLK 하강 에지에서 DIO를 내보냄 → LOW 구간 끝에서 샘플
+uint8_t TM1638Bus::readByte() {
+  uint8_t value = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    value >>= 1;
+    pinLow(_clk);
+    waitNs(TM1638_CLK_HALF_NS);
+    if (pinRead(_dio)) value |= 0x80;
+    pinHigh(_clk);
+    waitNs(TM1638_CLK_HALF_NS);
+  }
+  return value;
+}
+
+void TM1638Bus::sendCommand(uint8_t cmd) {
+  strobeLow();
+  writeByte(cmd);
+  strobeHigh();
+}
+
+void TM1638Bus::command(uint8_t cmd) {
+  lock();
+  sendCommand(cmd);
+  unlock();
+}
+
+void TM1638Bus::writeBurst(uint8_t addr, const uint8_t* data, uint8_t len) {
+  lock();
+  sendCommand(TM_CMD_WRITE_INC);
+  strobeLow();
+  writeByte(TM_ADDR_BASE | (addr & 0x0F));
+  for (uint8_t i = 0; i < len; i++) {
+    writeByte(data[i]);
+  }
+  strobeHigh();
+  unlock();
+}
+
+void TM1638Bus::writeFixed(uint8_t addr, uint8_t data) {
+  lock();
+  sendCommand(TM_CMD_WRITE_FIX);
+  strobeLow();
+  writeByte(TM_ADDR_BASE | (addr & 0x0F));
+  writeByte(data);
+  strobeHigh();
+  unlock();
+}
+
+void TM1638Bus::readKeys(uint8_t out[4]) {
+  lock();
+  strobeLow();
+  writeByte(TM_CMD_READ_KEY);
+  pinOutput(_dio, false);  // 외부 풀업 사용
+  waitNs(TM1638_READ_WAIT_US * 1000UL);
+  for (uint8_t i = 0; i < 4; i++) {
+    out[i] = readByte();
+  }
+  pinOutput(_dio, true);
+  strobeHigh();
+  unlock();
+}
@@ -0,0 +1,47 @@
+// tm1638Bus.h - TM1638 3선 버스 드라이버 (GPIO 레지스터 직접 제어)
+//
+// digitalWrite/digitalRead 대신 GPIO.out_w1ts/out_w1tc/in 레지스터로 핀을 바꾸고,
+// 데이터시트 타이밍을 사이클 카운터 대기로 보장한다.
+//  - CLK 최대 1MHz: LOW/HIGH 각 TM1638_CLK_HALF_NS 이상
+//  - DIO 설정/유지: CLK 상승 전 TM1638_SETUP_NS 이상
+//  - STB: 명령 사이 HIGH 유지 TM1638_STB_HIGH_NS 이상
+//  - 키 읽기: 0x42 전송 후 첫 CLK까지 TM1638_READ_WAIT_US (Twait ≥ 1us + 풀업 상승 여유)
+// 전체 화면은 자동 증가 모드(0x40) 한 번 + 주소 0xC0 + 16바이트 연속 전송.
+// 키 스캐너(esp_timer Task)와 UI Task가 공유 → 트랜잭션 단위 뮤텍스.
+
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/semphr.h>
+#include "../config.h"
+
+class TM1638Bus {
+public:
+  void begin(uint8_t pinSTB, uint8_t pinCLK, uint8_t pinDIO);
+  void command(uint8_t cmd);                                  // 단일 명령 바이트
+  void writeBurst(uint8_t addr, const uint8_t* data, uint8_t len);  // 0x40 + 주소 + 연속 데이터
+  void writeFixed(uint8_t addr, uint8_t data);                // 0x44 + 주소 + 1바이트
+  void readKeys(uint8_t out[4]);                              // 0x42 + 4바이트 키 스캔
+
+private:
+  void lock();
+  void unlock();
+  void sendCommand(uint8_t cmd);   // 잠금 없이 (트랜잭션 내부용)
+  void writeByte(uint8_t data);
+  uint8_t readByte();
+  void strobeLow();
+  void strobeHigh();
+
+  // 핀 번호 → 레지스터 뱅크 (0~31: out/in, 32~39: out1/in1)
+  static inline void pinHigh(uint8_t pin);
+  static inline void pinLow(uint8_t pin);
+  static inline bool pinRead(uint8_t pin);
+  static inline void pinOutput(uint8_t pin, bool enable);
+  inline void waitNs(uint32_t ns) const;
+
+  uint8_t _stb = 0;
+  uint8_t _clk = 0;
+  uint8_t _dio = 0;
+  SemaphoreHandle_t _mutex = nullptr;
+  uint32_t _cyclesPerUs = 240;  // begin()에서 CPU 클럭으로 갱신
+};
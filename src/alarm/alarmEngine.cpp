@@ -0,0 +1,114 @@
+// alarmEngine.cpp - 알람/이벤트 판정 구현
+
+#include "alarmEngine.h"
+#include "../mqtt/mqttClient.h"
+#include "../binLog/binLog.h"
+
+AlarmEngine gAlarm;
+
+extern CURRENT_DATA gCUR;
+
+// UNION_EVENT 비트 위치 (typedef.h 선언 순서)
+#define EVT_POWER_ON                (1u << 0)
+#define EVT_HIGH_TEMPER_ALARM       (1u << 2)
+#define EVT_LOW_TEMPER_ALARM        (1u << 3)
+#define EVT_LOW_HUMIDITY_ALARM      (1u << 4)
+#define EVT_TEMPERATURE_SENSOR      (1u << 5)
+#define EVT_EVAFAN_CURRENT_ALARM    (1u << 7)
+#define EVT_EVAHEATER_CURRENT_ALARM (1u << 8)
+#define EVT_NO_SENSOR_EVENT         (1u << 15)
+
+// ========== 규칙 조건 ==========
+static bool condSensor() {
+  return gCUR.error_info.thermist_short || gCUR.error_info.thermist_open;
+}
+
+static bool condHighTemp() {
+  return gCUR.error_info.HiT_error || gCUR.error_info.thermo_state ||
+         gCUR.measure_ntc_temp >= ALARM_HIGH_TEMP_C;
+}
+
+// 건조 중 설정 온도에 한참 못 미치는 상태가 오래 지속 (히터 불량 등)
+static bool condLowTemp() {
+  return gCUR.dry_state == DRY_RUN && gCUR.relay_state.RY2 &&
+         gCUR.measure_ntc_temp < gCUR.seljung_temp - ALARM_LOW_TEMP_MARGIN_C;
+}
+
+static bool condLowHumidity() {
+  return gCUR.sht30_temp > ALARM_SHT30_MISSING_C && gCUR.sht30_humidity < ALARM_LOW_HUMIDITY_PCT;
+}
+
+static bool condFan() {
+  return gCUR.error_info.fan_error;
+}
+
+static bool condHeater() {
+  return gCUR.error_info.heater1_error || gCUR.error_info.heater2_error;
+}
+
+// SHT30 미연결: 아날로그 입력이 0V 근처 → 하한(-20℃)에 고정
+static bool condNoSensor() {
+  return gCUR.sht30_temp <= ALARM_SHT30_MISSING_C;
+}
+
+static constexpr ALARM_RULE s_rules[] = {
+  { EVT_TEMPERATURE_SENSOR,      2,  5,  condSensor,      "SENSOR" },
+  { EVT_HIGH_TEMPER_ALARM,       3,  10, condHighTemp,    "HIGH_TEMP" },
+  { EVT_LOW_TEMPER_ALARM,        ALARM_LOW_TEMP_HOLD_S, 10, condLowTemp, "LOW_TEMP" },
+  { EVT_LOW_HUMIDITY_ALARM,      30, 30, condLowHumidity, "LOW_HUMIDITY" },
+  { EVT_EVAFAN_CURRENT_ALARM,    0,  5,  condFan,         "FAN" },
+  { EVT_EVAHEATER_CURRENT_ALARM, 0,  5,  condHeater,      "HEATER" },
+  { EVT_NO_SENSOR_EVENT,         5,  5,  condNoSensor,    "NO_SENSOR" },
+};
+
+static constexpr uint8_t NUM_RULES = sizeof(s_rules) / sizeof(s_rules[0]);
+
+// 카운터는 최댓값에서 포화하므로 유지 시간이 그 이하여야 ">= hold" 판정이 성립
+static constexpr bool holdsFit(uint8_t i = 0) {
+  return i >= NUM_RULES ||
+         (s_rules[i].set_hold_s <= (ALARM_HOLD_COUNT)~0u &&
+          s_rules[i].clear_hold_s <= (ALARM_HOLD_COUNT)~0u &&
+          holdsFit(i + 1));
+}
+static_assert(NUM_RULES <= ALARM_MAX_RULES, "too many alarm rules for _hold[]");
+static_assert(sizeof(ALARM_HOLD_COUNT) >= sizeof(s_rules[0].set_hold_s), "hold counter narrower than hold time");
+static_assert(holdsFit(), "alarm hold time does not fit the _hold[] counter");
+
+void AlarmEngine::evaluate() {
+  // 디바운스: 현재 비트와 다른 조건이 유지 시간(초)을 채우면 전환 - 0은 그 틱에 바로 전환
+  for (uint8_t i = 0; i < NUM_RULES; i++) {
+    const ALARM_RULE& r = s_rules[i];
+    bool active = (_state & r.bit) != 0;
+    bool cond = r.condition();
+    if (cond == active) {
+      _hold[i] = 0;
+      continue;
+    }
+    uint16_t hold = cond ? r.set_hold_s : r.clear_hold_s;
+    if (_hold[i] < (ALARM_HOLD_COUNT)~0u) _hold[i]++;
+    if (_hold[i] >= hold) {
+      _state ^= r.bit;
+      _hold[i] = 0;
+      LOGI("[Alarm] %s %s\n", r.name, cond ? "SET" : "CLEAR");
+    }
+  }
+
+  // 발행 상태와 비교 (POWER_ON은 setup()에서 설정한 값 유지)
+  PUBLISH_EVENT& ev = gCUR.pubEvent;
+  uint16_t next = (ev.uEvent.u16 & EVT_POWER_ON) | _state;
+  if (next == ev.ex_uEvent.u16) return;
+
+  uint32_t now = millis();
+  if (_lastPublish != 0 && now - _lastPublish < ALARM_PUBLISH_MIN_INTERVAL_MS) {
+    return;  // 다음 틱에 누적된 에지로 발행
+  }
+
+  ev.uEvent.u16 = next;
+  ev.xor_uEvent.u16 = next ^ ev.ex_uEvent.u16;
+  if (gMQTTClient.publishEvent(ev.xor_uEvent.u16, ev.uEvent.u16)) {
+    ev.ex_uEvent.u16 = next;
+    ev.event_state = next;
+    _lastPublish = now;
+  }
+  // 큐 생성 전/가득 참: ex_uEvent를 유지해 다음 틱에 재시도
+}
@@ -0,0 +1,38 @@
+// alarmEngine.h - 알람/이벤트 판정 (ERROR_INFO + 임계값 → UNION_EVENT, 에지 검출 후 publishEvent)
+//
+// 제어 틱(1초)마다 evaluate()를 호출한다.
+// 규칙마다 조건이 set_hold 초 동안 유지되면 비트를 세우고, clear_hold 초 동안 해제되면 내린다 (0 = 즉시).
+// 마지막으로 발행한 상태와 다르면 XOR 에지 마스크와 함께 publishEvent()를 호출한다
+// (ALARM_PUBLISH_MIN_INTERVAL_MS 안의 연속 변화는 한 번에 묶음 - 틱 지터로 당겨진 틱만 해당).
+// POWER_ON 비트는 setup()에서 세우며, 첫 발행(MQTT 큐 생성 후)에 에지로 함께 나간다.
+
+#pragma once
+
+#include <Arduino.h>
+#include "../config.h"
+#include "../typedef.h"
+
+#define ALARM_MAX_RULES 16    // UNION_EVENT 비트 수
+typedef uint16_t ALARM_HOLD_COUNT;  // 규칙별 유지 시간 카운터 (초, 포화)
+
+// 알람 규칙 (조건 함수 + 유지 시간)
+typedef struct {
+  uint16_t bit;               // UNION_EVENT 비트 마스크
+  uint16_t set_hold_s;        // 조건이 이 시간 유지되면 발생 (0 = 첫 틱에 즉시)
+  uint16_t clear_hold_s;      // 조건이 이 시간 해제되면 복귀 (0 = 첫 틱에 즉시)
+  bool (*condition)();
+  const char* name;
+} ALARM_RULE;
+
+class AlarmEngine {
+public:
+  void evaluate();            // 제어 틱(1초)마다 호출 - loop() 컨텍스트
+  uint16_t active() const { return _state; }
+
+private:
+  uint16_t _state = 0;        // 디바운스된 알람 비트
+  ALARM_HOLD_COUNT _hold[ALARM_MAX_RULES] = {0};  // 규칙별 조건 변화 유지 시간(초)
+  uint32_t _lastPublish = 0;
+};
+
+extern AlarmEngine gAlarm;
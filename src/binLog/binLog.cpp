@@ -0,0 +1,183 @@
+// binLog.cpp - Vyukov 다중 생산자 링 + LogTask 서식화/출력
+
+#include "binLog.h"
+#include "../diag/diag.h"
+
+BinLog gBinLog;
+
+static_assert((BINLOG_RING_LEN & (BINLOG_RING_LEN - 1)) == 0, "BINLOG_RING_LEN must be a power of two");
+
+#define BINLOG_MASK   (BINLOG_RING_LEN - 1)
+#define BINLOG_SYNC0  0xA5
+#define BINLOG_SYNC1  0x5A
+
+BinLog::BinLog() : _enqueuePos(0), _dequeuePos(0), _dropped(0) {
+  for (uint32_t i = 0; i < BINLOG_RING_LEN; i++) {
+    _cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+void BinLog::begin() {
+  if (_taskHandle) return;
+  // Core 0, 낮은 우선순위: UART 대기가 제어 루프(Core 1)를 막지 않도록
+  BaseType_t ret = xTaskCreatePinnedToCore(
+    logTask,            // Task 함수
+    "LogTask",          // Task 이름
+    BINLOG_TASK_STACK,  // Stack 크기 (서식화)
+    this,               // Parameter (this 포인터)
+    1,                  // Priority (1 = 낮음)
+    &_taskHandle,       // Task Handle
+    0                   // Core 0
+  );
+  if (ret != pdPASS) {
+    _taskHandle = nullptr;
+    Serial.println("[Log] Failed to create task");
+  } else {
+    gDiag.registerTask(_taskHandle, "LogTask", BINLOG_TASK_STACK);
+  }
+}
+
+// 생산자: 칸 예약(CAS) → 기록 → seq 공개. 가득 차면 버림
+bool BinLog::write(uint8_t level, const char* fmt, uint8_t nargs, const uint32_t* args) {
+  Cell* cell;
+  uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &_cells[pos & BINLOG_MASK];
+    uint32_t seq = cell->seq.load(std::memory_order_acquire);
+    int32_t diff = (int32_t)seq - (int32_t)pos;
+    if (diff == 0) {
+      if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = _enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  BINLOG_RECORD& r = cell->rec;
+  r.ts_ms = millis();
+  r.fmt = (uint32_t)(uintptr_t)fmt;
+  r.level = level;
+  r.nargs = nargs;
+  r.reserved = 0;
+  memcpy(r.args, args, nargs * sizeof(uint32_t));
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool BinLog::pop(BINLOG_RECORD& rec) {
+  Cell* cell;
+  uint32_t pos = _dequeuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &_cells[pos & BINLOG_MASK];
+    uint32_t seq = cell->seq.load(std::memory_order_acquire);
+    int32_t diff = (int32_t)seq - (int32_t)(pos + 1);
+    if (diff == 0) {
+      if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      return false;  // 비었음
+    } else {
+      pos = _dequeuePos.load(std::memory_order_relaxed);
+    }
+  }
+  rec = cell->rec;
+  cell->seq.store(pos + BINLOG_MASK + 1, std::memory_order_release);
+  return true;
+}
+
+// 서식 문자열을 변환 지정자 단위로 나눠 인자 타입에 맞게 snprintf
+size_t BinLog::format(const BINLOG_RECORD& rec, char* out, size_t size) {
+  const char* f = (const char*)(uintptr_t)rec.fmt;
+  size_t len = 0;
+  uint8_t ai = 0;
+  char spec[16];
+
+  while (*f && len + 1 < size) {
+    if (*f != '%') {
+      out[len++] = *f++;
+      continue;
+    }
+    if (f[1] == '%') {
+      out[len++] = '%';
+      f += 2;
+      continue;
+    }
+
+    // 지정자 수집 (길이 수정자 l/h/z는 버림 - 모든 인자는 32비트)
+    size_t sn = 0;
+    int star = -1;
+    spec[sn++] = *f++;
+    while (*f && !strchr("diouxXcsfFeEgGp", *f) && sn < sizeof(spec) - 2) {
+      if (*f == '*') {
+        star = (ai < rec.nargs) ? (int32_t)rec.args[ai++] : 0;
+      }
+      if (*f != 'l' && *f != 'h' && *f != 'z') spec[sn++] = *f;
+      f++;
+    }
+    if (!*f) break;
+    char conv = *f++;
+    spec[sn++] = conv;
+    spec[sn] = '\0';
+
+    uint32_t a = (ai < rec.nargs) ? rec.args[ai++] : 0;
+    int n;
+    if (strchr("fFeEgG", conv)) {
+      float v;
+      memcpy(&v, &a, sizeof(v));
+      n = (star >= 0) ? snprintf(out + len, size - len, spec, star, (double)v)
+                      : snprintf(out + len, size - len, spec, (double)v);
+    } else if (conv == 's') {
+      const char* s = a ? (const char*)(uintptr_t)a : "(null)";
+      n = (star >= 0) ? snprintf(out + len, size - len, spec, star, s)
+                      : snprintf(out + len, size - len, spec, s);
+    } else if (conv == 'p') {
+      n = snprintf(out + len, size - len, "0x%08lx", (unsigned long)a);
+    } else if (conv == 'd' || conv == 'i') {
+      n = (star >= 0) ? snprintf(out + len, size - len, spec, star, (int)(int32_t)a)
+                      : snprintf(out + len, size - len, spec, (int)(int32_t)a);
+    } else {
+      n = (star >= 0) ? snprintf(out + len, size - len, spec, star, (unsigned)a)
+                      : snprintf(out + len, size - len, spec, (unsigned)a);
+    }
+    if (n < 0) break;
+    len += ((size_t)n < size - len) ? (size_t)n : size - len - 1;
+  }
+  out[len] = '\0';
+  return len;
+}
+
+void BinLog::emit(const BINLOG_RECORD& rec) {
+#if BINLOG_OUTPUT_BINARY
+  uint8_t sync[2] = { BINLOG_SYNC0, BINLOG_SYNC1 };
+  Serial.write(sync, sizeof(sync));
+  Serial.write((const uint8_t*)&rec, sizeof(rec));
+#else
+  char line[BINLOG_LINE_MAX];
+  size_t n = 0;
+#if BINLOG_TIMESTAMP
+  n = snprintf(line, sizeof(line), "%6lu.%03lu ",
+               (unsigned long)(rec.ts_ms / 1000), (unsigned long)(rec.ts_ms % 1000));
+#endif
+  n += format(rec, line + n, sizeof(line) - n);
+  Serial.write((const uint8_t*)line, n);
+#endif
+}
+
+void BinLog::logTask(void* parameter) {
+  BinLog* self = static_cast<BinLog*>(parameter);
+  BINLOG_RECORD rec;
+  for (;;) {
+    while (self->pop(rec)) {
+      self->emit(rec);
+    }
+#if !BINLOG_OUTPUT_BINARY
+    uint32_t dropped = self->dropped();
+    if (dropped != self->_reportedDropped) {
+      Serial.printf("[Log] %lu records dropped (ring full)\n", (unsigned long)(dropped - self->_reportedDropped));
+      self->_reportedDropped = dropped;
+    }
+#endif
+    vTaskDelay(pdMS_TO_TICKS(BINLOG_DRAIN_PERIOD_MS));
+  }
+}
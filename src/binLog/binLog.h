@@ -0,0 +1,113 @@
+// binLog.h - 지연 바이너리 로그 (잠금 없는 링 + 출력 Task)
+//
+// printf는 115200bps UART로 호출자를 수 ms 동안 막는다. LOGx()는 서식 문자열 포인터와
+// 인자(32비트 값)만 링에 기록하고 바로 돌아오며, 우선순위 낮은 LogTask가 꺼내서
+// 문자열로 만들어 출력한다. 레벨은 컴파일 시 걸러져 꺼진 로그는 코드가 남지 않는다.
+//
+// 제약:
+//  - %s 인자는 문자열 리터럴/정적 문자열만 (출력 시점에 포인터를 따라감)
+//    변경 가능한 버퍼(char 배열, char*)를 넘기면 컴파일 오류 - 즉시 서식화(Serial)하거나 리터럴로 바꿀 것
+//  - 인자는 최대 BINLOG_MAX_ARGS개, 64비트 정수(%lld)는 지원하지 않음
+//  - 링이 가득 차면 기록을 버리고 dropped를 센다 (호출자는 절대 대기하지 않음)
+// BINLOG_OUTPUT_BINARY=1이면 서식 없이 레코드를 그대로 내보내고, 호스트에서
+// tools/binlog_decode.py가 펌웨어 ELF로 서식 문자열을 찾아 복원한다.
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "../config.h"
+
+#define LOG_LEVEL_NONE     0
+#define LOG_LEVEL_ERROR    1
+#define LOG_LEVEL_WARN     2
+#define LOG_LEVEL_INFO     3
+#define LOG_LEVEL_DEBUG    4
+#define LOG_LEVEL_VERBOSE  5
+
+// 링 레코드 (바이너리 출력 시 이 배치 그대로 - 리틀 엔디언 36바이트)
+typedef struct {
+  uint32_t ts_ms;                   // 기록 시각 (millis)
+  uint32_t fmt;                     // 서식 문자열 주소 (= 서식 ID)
+  uint8_t level;
+  uint8_t nargs;
+  uint16_t reserved;
+  uint32_t args[BINLOG_MAX_ARGS];
+} BINLOG_RECORD;
+
+class BinLog {
+public:
+  BinLog();
+  void begin();                     // LogTask 시작 (begin 전 기록은 링에 보관)
+  bool write(uint8_t level, const char* fmt, uint8_t nargs, const uint32_t* args);
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    BINLOG_RECORD rec;
+  };
+  static void logTask(void* parameter);
+  bool pop(BINLOG_RECORD& rec);
+  size_t format(const BINLOG_RECORD& rec, char* out, size_t size);
+  void emit(const BINLOG_RECORD& rec);
+
+  Cell _cells[BINLOG_RING_LEN];
+  std::atomic<uint32_t> _enqueuePos;
+  std::atomic<uint32_t> _dequeuePos;
+  std::atomic<uint32_t> _dropped;
+  uint32_t _reportedDropped = 0;
+  TaskHandle_t _taskHandle = nullptr;
+};
+
+extern BinLog gBinLog;
+
+// ========== 인자 → 32비트 ==========
+static inline uint32_t binlogArg(float v) { uint32_t u; memcpy(&u, &v, sizeof(u)); return u; }
+static inline uint32_t binlogArg(double v) { return binlogArg((float)v); }
+static inline uint32_t binlogArg(const char* s) { return (uint32_t)(uintptr_t)s; }
+static inline uint32_t binlogArg(const void* p) { return (uint32_t)(uintptr_t)p; }
+template<typename T> static inline uint32_t binlogArg(T v) { return (uint32_t)v; }
+
+// 인자는 값으로 받으므로 char 배열은 char*로 붕괴 - 리터럴만 const char*로 남음
+template<typename... A> struct binlogHasMutableStr { static const bool value = false; };
+template<typename T, typename... R> struct binlogHasMutableStr<T, R...> {
+  static const bool value = binlogHasMutableStr<R...>::value;
+};
+template<typename... R> struct binlogHasMutableStr<char*, R...> { static const bool value = true; };
+
+template<typename... A>
+static inline void binlog(uint8_t level, const char* fmt, A... a) {
+  static_assert(sizeof...(A) <= BINLOG_MAX_ARGS, "too many log arguments");
+  static_assert(!binlogHasMutableStr<A...>::value,
+                "LOGx %s argument must be a string literal (mutable buffers change before LogTask formats them)");
+  const uint32_t args[sizeof...(A) + 1] = { binlogArg(a)..., 0 };
+  gBinLog.write(level, fmt, sizeof...(A), args);
+}
+
+// ========== 레벨별 매크로 (LOG_LEVEL 미만은 컴파일에서 제거) ==========
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOGE(fmt, ...) binlog(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOGE(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOGW(fmt, ...) binlog(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOGW(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOGI(fmt, ...) binlog(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOGI(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOGD(fmt, ...) binlog(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOGD(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define LOGV(fmt, ...) binlog(LOG_LEVEL_VERBOSE, fmt, ##__VA_ARGS__)
+#else
+#define LOGV(fmt, ...) do {} while (0)
+#endif
@@ -0,0 +1,72 @@
+// bootSeq.cpp - 단계별 부팅 파이프라인 이벤트 + 부팅 타임라인 기록 구현
+
+#include "bootSeq.h"
+#include <esp_timer.h>
+#include <esp_system.h>
+
+BootSeq gBoot;
+
+static const char* const BOOT_STAGE_NAME[BOOT_STAGE_MAX] = {
+  "START", "PINS", "STATE", "CONTROL", "UI", "WIFI", "OTA", "MQTT"
+};
+
+// 단계별 이벤트 비트 (0 = 이벤트 없음)
+static const EventBits_t BOOT_STAGE_EVENT[BOOT_STAGE_MAX] = {
+  0, 0, 0, BOOT_EVT_CONTROL, 0, BOOT_EVT_WIFI, BOOT_EVT_OTA, BOOT_EVT_MQTT
+};
+
+void BootSeq::begin() {
+  if (_events == nullptr) {
+    _events = xEventGroupCreate();
+  }
+  mark(BOOT_STAGE_START);
+}
+
+void BootSeq::mark(BOOT_STAGE stage) {
+  if (stage >= BOOT_STAGE_MAX) return;
+
+  if (BOOT_STAGE_EVENT[stage]) {
+    setEvent(BOOT_STAGE_EVENT[stage]);
+  }
+  // 첫 완료 시각만 기록 (재연결은 타임라인에 포함하지 않음)
+  if (_stamp_us[stage] != 0) return;
+  uint32_t now_us = (uint32_t)esp_timer_get_time();
+  _stamp_us[stage] = now_us;
+  Serial.printf("[Boot] %-7s %6lu ms\n", BOOT_STAGE_NAME[stage], (unsigned long)(now_us / 1000));
+}
+
+void BootSeq::setEvent(EventBits_t bits) {
+  if (_events) {
+    xEventGroupSetBits(_events, bits);
+  }
+}
+
+bool BootSeq::isReady(EventBits_t bits) {
+  if (_events == nullptr) return false;
+  return (xEventGroupGetBits(_events) & bits) == bits;
+}
+
+bool BootSeq::waitFor(EventBits_t bits, uint32_t timeout_ms) {
+  if (_events == nullptr) return false;
+  EventBits_t got = xEventGroupWaitBits(_events, bits, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeout_ms));
+  return (got & bits) == bits;
+}
+
+uint32_t BootSeq::stageMs(BOOT_STAGE stage) {
+  if (stage >= BOOT_STAGE_MAX) return 0;
+  return _stamp_us[stage] / 1000;
+}
+
+int BootSeq::format(char* buf, size_t size) {
+  int len = snprintf(buf, size, "%d|", (int)esp_reset_reason());
+  for (int i = BOOT_STAGE_PINS; i < BOOT_STAGE_MAX && len > 0 && (size_t)len < size; i++) {
+    len += snprintf(buf + len, size - len, "%s:%lu|", BOOT_STAGE_NAME[i], (unsigned long)stageMs((BOOT_STAGE)i));
+  }
+  return len;
+}
+
+void BootSeq::print() {
+  char timeline[160];
+  format(timeline, sizeof(timeline));
+  Serial.printf("[Boot] Timeline: %s\n", timeline);
+}
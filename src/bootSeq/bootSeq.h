@@ -0,0 +1,45 @@
+// bootSeq.h - 단계별 부팅 파이프라인 이벤트 + 부팅 타임라인 기록
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+// 부팅 단계 (순서 = 타임라인 출력 순서)
+typedef enum _BOOT_STAGE {
+  BOOT_STAGE_START = 0,   // setup() 진입
+  BOOT_STAGE_PINS,        // 출력 핀 안전 상태 (전부 OFF)
+  BOOT_STAGE_STATE,       // 제어 상태 로드 (RTC 또는 Flash)
+  BOOT_STAGE_CONTROL,     // 타이머 인터럽트 시작 = 제어 루프 가동
+  BOOT_STAGE_UI,          // TM1638 초기화 + UI Task 시작
+  BOOT_STAGE_WIFI,        // WiFi 연결 (IP 획득)
+  BOOT_STAGE_OTA,         // OTA 서비스 시작
+  BOOT_STAGE_MQTT,        // AWS IoT MQTT 연결
+  BOOT_STAGE_MAX
+} BOOT_STAGE;
+
+// 부팅 준비 이벤트 비트 (EventGroup)
+#define BOOT_EVT_CONTROL   (1 << 0)  // 제어 루프 가동
+#define BOOT_EVT_WIFI      (1 << 1)  // WiFi 연결 완료
+#define BOOT_EVT_OTA       (1 << 2)  // OTA 준비 완료
+#define BOOT_EVT_MQTT      (1 << 3)  // MQTT 연결 완료
+#define BOOT_EVT_NET_DONE  (1 << 4)  // 네트워크 부팅 Task 종료 (성공/실패 무관)
+
+class BootSeq {
+public:
+  void begin();                               // setup() 첫 줄에서 호출
+  void mark(BOOT_STAGE stage);                // 단계 완료 시각 기록 + 이벤트 비트 설정
+  void setEvent(EventBits_t bits);            // 단계 기록 없이 이벤트만 설정
+  bool isReady(EventBits_t bits);             // 모든 비트가 설정되었는지 (대기 없음)
+  bool waitFor(EventBits_t bits, uint32_t timeout_ms);
+  uint32_t stageMs(BOOT_STAGE stage);         // 부팅 후 경과 시간(ms), 미완료 시 0
+  int format(char* buf, size_t size);         // "reason|PINS:ms|STATE:ms|...|" 형식
+  void print();                               // Serial로 타임라인 출력
+
+private:
+  EventGroupHandle_t _events = nullptr;
+  uint32_t _stamp_us[BOOT_STAGE_MAX] = {0};   // esp_timer 기준 (부팅 후 us)
+};
+
+extern BootSeq gBoot;
@@ -26,6 +26,25 @@
 #define PIN_FND_DIO     15    // DIO
 
 #define FND_BRIGHTNESS  0x0f  // 0x88~0x8f (밝기)
+#define TM1638_CLK_HALF_NS   500   // CLK LOW/HIGH 유지 (데이터시트 PW_CLK ≥ 400ns, 최대 1MHz)
+#define TM1638_STB_HIGH_NS   1000  // 명령 사이 STB HIGH 유지
+#define TM1638_READ_WAIT_US  2     // 0x42 전송 후 첫 읽기 CLK까지 (Twait ≥ 1us)
+#define FND_FULL_REFRESH_MS  5000  // 변경 없어도 전체 프레임 재전송 주기
+
+// ====== 키 스캐너 ======
+#define KEY_SCAN_PERIOD_MS     20    // esp_timer 샘플 주기 (50회/s - 버스 읽기 약 51us, 버스 뮤텍스 점유)
+#define KEY_DEBOUNCE_SAMPLES   2     // 연속 일치 샘플 수 (20ms x 2 = 40ms, 누름 후 40ms 안에 확정)
+#define KEY_REPEAT_DELAY_MS    300   // 첫 반복까지
+#define KEY_REPEAT_RATE_MS     100   // 반복 간격
+#define KEY_LONG_PRESS_MS      3000  // KEY_PWR 길게 누름 (SmartConfig)
+#define KEY_EVENT_QUEUE_LEN    16
+#define KEY_SCAN_IDLE_PERIOD_MS 250  // UI 유휴 시 샘플 주기 (4회/s, 첫 PRESS까지 최대 2주기 = 500ms)
+#define KEY_SCAN_TASK_STACK    2048  // KeyScanTask (버스 읽기 + 이벤트 큐)
+
+// ====== UI Task 주기 ======
+#define UI_ACTIVE_PERIOD_MS    50    // 활성: 키 이벤트 처리 주기 (키 이벤트 시 즉시 깨어남)
+#define UI_DISPLAY_PERIOD_MS   100   // 활성: 디스플레이 갱신 주기
+#define UI_IDLE_AFTER_MS       30000 // 입력/상태 변화 없이 이 시간 지나면 유휴 (soft-off / DRY_FINISH만)
 
 // ====== Wi-Fi / OTA 설정 ======
 // TODO: 실제 WiFi 정보로 변경하세요!
@@ -33,6 +52,14 @@
 #define WIFI_PASS       "898900898900"  // 실제 WiFi 비밀번호로 변경
 #define OTA_HOSTNAME    "DryerESP32"
 #define OTA_PASSWORD    "1234"    // OTA 접속 비밀번호 (보안을 위해 변경 권장)
+#define WIFI_MAX_NETWORKS       4         // 저장 가능한 WiFi 네트워크 수 (RSSI 순 연결)
+#define WIFI_MAX_SUBSCRIBERS    4         // 링크 상태 구독자 수
+#define WIFI_CONNECT_TIMEOUT_MS 10000UL   // 1회 연결 시도 제한 시간
+#define WIFI_SCAN_TIMEOUT_MS    8000UL    // 비동기 스캔 제한 시간
+#define WIFI_BACKOFF_MIN_MS     1000UL    // 재시도 백오프 최소
+#define WIFI_BACKOFF_MAX_MS     60000UL   // 재시도 백오프 최대
+#define WIFI_BOOT_WAIT_MS       15000UL   // 부팅 시 WiFi 대기 (NetBootTask 내부)
+#define WIFI_RSSI_SAMPLE_MS     10000UL   // 연결 중 RSSI 샘플 주기 (링크 품질 통계)
 
 // ====== 디버그 모드 ======
 #define DEBUG_MODE  // 이 줄을 주석 해제하면 디버그 모드 (타이머 기반 콜백)
@@ -45,6 +72,7 @@
 
 #define HEATER_HYSTERESIS   0.5f    // 히터 온도 히스테리시스 (네℃)
 #define CONTROL_PERIOD      1000UL  // 제어 주기 (ms)
+#define BOOT_CONTROL_BUDGET_MS  300   // 부팅 후 제어 루프 가동까지 허용 시간 (ms)
 
 // ====== NTC 측정용 기본값 ======
 // 5K NTC (Beta=3970), 5K pull-up, 3.3V
@@ -66,3 +94,89 @@
 #define API_RECORD_ID             "1055"              // 필요 시 서버 요구사항에 맞게 변경
 #define API_DEPARTURE_YN          "N"                 // 대문자 N (Postman과 동일)
 #define API_UPLOAD_INTERVAL_MS    (5UL * 60UL * 1000UL) // 1분 주기 (60초)
+#define API_BODY_MAX              256                   // 요청 body 버퍼 (미리 할당)
+#define API_RESPONSE_MAX          256                   // 응답 body 버퍼 (넘치면 나머지 버림)
+#define API_HTTP_TIMEOUT_MS       5000                  // HTTP 응답 대기
+#define API_DATA_BATCH            0                     // 1: 대기 중인 측정값을 한 요청에 묶어 전송 (서버 지원 시)
+#define API_DATA_BATCH_MAX        8                     // 한 요청당 최대 측정값 수
+#define API_BATCH_FIELD           "measure_values"      // 묶음 전송 필드 이름 (쉼표 구분)
+#define API_JOB_QUEUE_LEN         8                     // 업로드 작업 큐 (START/DATA/FINISH)
+#define API_RETRY_MIN_MS          2000UL                // 실패 후 첫 재시도 간격
+#define API_RETRY_MAX_MS          (5UL * 60UL * 1000UL) // 재시도 간격 상한 (지수 증가)
+#define API_DATA_MAX_ATTEMPTS     5                     // DATA 영구 오류(4xx) 시 포기 횟수
+#define API_IDEMPOTENCY_HEADER    "Idempotency-Key"     // START 재시도 시 같은 값 전송 (권고용 - 서버 지원 미확인, 중복 방지에 의존하지 않음)
+
+// ====== 알람 엔진 (alarmEngine) ======
+#define ALARM_HIGH_TEMP_C             (MAX_TEMPERATURE + 5) // 과열 알람 온도 (NTC)
+#define ALARM_LOW_TEMP_MARGIN_C       10                    // 건조 중 설정 온도보다 이만큼 낮으면
+#define ALARM_LOW_TEMP_HOLD_S         1800                  // ... 이 시간 지속 시 저온 알람
+#define ALARM_LOW_HUMIDITY_PCT        5.0f                  // 저습도 알람 (SHT30)
+#define ALARM_SHT30_MISSING_C         -20.0f                // SHT30 하한 고정 = 센서 없음
+#define ALARM_PUBLISH_MIN_INTERVAL_MS 900UL                 // 이벤트 발행 최소 간격 (1초 틱보다 짧게 - 정상 틱은 막지 않음)
+
+// ====== 텔레메트리 발행 정책 (publishPolicy) ======
+#define PUBLISH_CHECK_INTERVAL_MS     1000UL                // 정책 평가 주기
+#define PUBLISH_STATE_MIN_INTERVAL_MS 2000UL                // 상태 변화 발행 최소 간격
+#define PUBLISH_MIN_INTERVAL_MS       (30UL * 1000UL)       // 데드밴드 발행 최소 간격
+#define PUBLISH_MAX_INTERVAL_MS       API_UPLOAD_INTERVAL_MS // 변화 없어도 이 간격마다 발행
+#define PUBLISH_DEADBAND_TEMP_X10     5                     // 온도 ±0.5℃
+#define PUBLISH_DEADBAND_HUMI_X10     20                    // 습도 ±2.0%
+#define PUBLISH_DEADBAND_FAN_CURRENT  50                    // 팬 전류 (원시값)
+#define PUBLISH_DEADBAND_REMAIN_MIN   10                    // 남은 시간 10분
+
+// ====== MQTT Task 설정 ======
+#define MQTT_TASK_STACK           8192                  // MQTT Task 스택 (TLS 핸드셰이크)
+#define MQTT_TASK_PERIOD_MS       10                    // MQTT Task 처리 주기 (ms)
+#define MQTT_TX_QUEUE_LEN         8                     // 송신 큐 (텔레메트리/이벤트)
+#define MQTT_RX_QUEUE_LEN         4                     // 수신 명령 배치 큐 (메시지 단위)
+#define MQTT_BOOT_WAIT_MS         20000UL               // 부팅 타임라인 발행 전 MQTT 연결 대기
+
+// ====== MQTT 발행 엔진 (QoS1) ======
+#define MQTT_OUTBOX_LEN           8                     // 송신 대기 + 전송 중(PUBACK 대기) 메시지 수
+#define MQTT_INFLIGHT_WINDOW      4                     // 동시에 PUBACK을 기다리는 최대 메시지 수
+#define MQTT_PUBACK_TIMEOUT_MS    10000UL               // PUBACK 미수신 시 재전송 (DUP)
+#define MQTT_PAYLOAD_MAX          384                   // 메시지당 최대 페이로드 (bytes)
+#define MQTT_QOS_DATA             1                     // 텔레메트리 (과금)
+#define MQTT_QOS_EVENT            1                     // 이벤트 (알람)
+#define MQTT_QOS_BOOT             0                     // 부팅 타임라인
+#define TELEMETRY_BINARY          0                     // 1: 텔레메트리를 바이너리 프레임으로 전송 (telemetryCodec)
+#define TELEMETRY_KEYFRAME_INTERVAL 12                  // 바이너리: N 프레임마다 전체 필드 전송
+#define MQTT_STATS_INTERVAL_MS    (60UL * 1000UL)       // 발행 통계 출력 주기
+#define NET_HEALTH_INTERVAL_MS    (15UL * 60UL * 1000UL) // 링크 건강 메시지 주기 (재연결 직후에도 1회)
+
+// ====== 메모리 배치 정책 ======
+#define MEM_PLACEMENT             1                     // 1: TLS 레코드 풀 + mbedTLS 할당 훅
+#define MEM_TLS_POOL_BLOCKS       2                     // TLS 레코드 버퍼 블록 (입력/출력)
+#define MEM_TLS_POOL_BLOCK_SIZE   (16384 + 1024)        // 최대 레코드 + 헤더/MAC 여유
+#define MEM_TLS_POOL_MIN          4096                  // 이 크기 이상 mbedTLS 할당만 풀 사용
+#define MEM_TLS_PSRAM_MIN         1024                  // 풀 밖 mbedTLS 할당 중 PSRAM에 둘 최소 크기
+#define MEM_LOW_BLOCK_WARN        (16UL * 1024UL)       // 내부 RAM 최대 연속 블록 경고 기준
+
+// ====== 진단 (스택/힙) ======
+#define DIAG_MAX_TASKS            8                     // 스택 감시 Task 수
+#define DIAG_PUBLISH_INTERVAL_MS  (10UL * 60UL * 1000UL) // 진단 토픽 발행 주기 (0 = 발행 안 함)
+
+// ====== 지연 로그 (binLog) ======
+#define LOG_LEVEL                 4                     // 0 NONE, 1 ERROR, 2 WARN, 3 INFO, 4 DEBUG, 5 VERBOSE (미만은 컴파일 제거)
+#define BINLOG_RING_LEN           64                    // 링 레코드 수 (2의 거듭제곱, 36바이트/레코드)
+#define BINLOG_MAX_ARGS           6                     // 레코드당 최대 인자
+#define BINLOG_LINE_MAX           192                   // 출력 한 줄 최대 길이
+#define BINLOG_TASK_STACK         3072                  // LogTask 스택
+#define BINLOG_DRAIN_PERIOD_MS    20                    // LogTask 비우기 주기
+#define BINLOG_TIMESTAMP          1                     // 1: 줄 앞에 기록 시각(초.ms)
+#define BINLOG_OUTPUT_BINARY      0                     // 1: 레코드를 그대로 출력 (tools/binlog_decode.py로 복원)
+
+// ====== 프로파일러 (지연 히스토그램) ======
+#define ENABLE_PROFILER           0                     // 1: 사이클 카운터 계측 (0이면 코드 제거)
+#define PROFILER_BUCKETS          16                    // log2 히스토그램 버킷 (마지막 = 16ms 이상)
+#define PROFILER_TICK_DEADLINE_US 20000UL               // 1초 틱 처리 지연 허용치
+#define PROFILER_REPORT_INTERVAL_MS (5UL * 60UL * 1000UL) // MQTT 보고 주기
+
+// ====== 오프라인 보관 (store-and-forward) ======
+#define TELEMETRY_STORE_LEN       2048                  // PSRAM 링 항목 수 (5분 주기 약 7일)
+#define TELEMETRY_STORE_LEN_NO_PSRAM 64                 // PSRAM 없을 때 내부 RAM 링
+#define TELEMETRY_STORE_SPILL     1                     // 1: 링이 차면 SPIFFS 파일로 내보냄
+#define TELEMETRY_SPILL_MAX_BYTES (256UL * 1024UL)      // 스필 파일 최대 크기
+#define TELEMETRY_FLUSH_BURST     4                     // 간격당 발행할 보관 항목 수
+#define TELEMETRY_FLUSH_INTERVAL_MS 1000UL              // 보관분 발행 간격 (실시간 트래픽 우선)
+#define TELEMETRY_FLUSH_MAX_ATTEMPTS 5                  // 보관 항목 연속 발행 실패 시 버림 (한 항목이 보관분을 막지 않도록)
@@ -1,9 +1,13 @@
 // dataClass.cpp - 데이터 관리 클래스 구현
 
 #include "dataClass.h"
+#include <stddef.h>
+#include <esp_system.h>
+#include <esp32/rom/crc.h>
 #include "../config.h"  // DEBUG_MODE 매크로 정의
 #include "../TM1638Display/TM1638Display.h"
 #include "../updateAPI/updateAPI.h"
+#include "../binLog/binLog.h"
 
 // ADC 필터링 상수
 #define ADC_SENSITIVITY 0.01f
@@ -11,6 +15,10 @@
 // 전역 변수 정의
 CURRENT_DATA gCUR;
 extern TM1638Display gDisplay;
+extern volatile uint8_t second_counter;  // main.cpp 분 카운터 (0~59)
+
+// RTC slow memory 웜 리스타트 상태 (RTC_NOINIT: 리셋 시 초기화되지 않음)
+RTC_NOINIT_ATTR static RTC_STATE s_rtcState;
 
 dataClass::dataClass() {
     clear();
@@ -22,6 +30,10 @@ dataClass::dataClass() {
     _temp_initialized = false;
     memset(_temp_buffer, 0, sizeof(_temp_buffer));
     
+    // ADC 필터 / 히터 상태 초기화
+    _m0_value = 0.0f;
+    _heater_on = false;
+    
     // ADC raw 필터링 초기화
     _adc_buffer_idx = 0;
     _adc_initialized = false;
@@ -51,9 +63,8 @@ void dataClass::clear() {
 
 // ADC 필터링 함수 (지수 이동 평균)
 float dataClass::get_m0_filter(int adc) {
-    static float m0_value;
-    m0_value = (m0_value * (1 - ADC_SENSITIVITY)) + (adc * ADC_SENSITIVITY);
-    return m0_value;
+    _m0_value = (_m0_value * (1 - ADC_SENSITIVITY)) + (adc * ADC_SENSITIVITY);
+    return _m0_value;
 }
 
 // Flash에 데이터 저장
@@ -69,9 +80,94 @@ void dataClass::saveToFlash() {
     
     _preferences.end();
     const char* state_str[] = {"DRY_PREPARE", "DRY_RUN", "DRY_COOL", "DRY_FINISH"};
-    printf("Data saved to flash - Power: %s, State: %s\n", 
+    LOGI("Data saved to flash - Power: %s, State: %s\n", 
            gCUR.flg.soft_off ? "OFF" : "ON",
            state_str[gCUR.dry_state]);
+    
+    // Flash에 저장된 설정은 RTC 웜 상태에도 즉시 반영
+    saveToRtc();
+}
+
+// RTC slow memory에 제어 상태 저장 (매 제어 주기 / 재시작 직전 호출, 수 us 소요)
+void dataClass::saveToRtc() {
+    RTC_STATE st;
+    memset(&st, 0, sizeof(st));
+    st.magic = RTC_STATE_MAGIC;
+    st.version = RTC_STATE_VERSION;
+    st.auto_damper = gCUR.auto_damper;
+    st.soft_off = gCUR.flg.soft_off;
+    st.dry_state = (uint8_t)gCUR.dry_state;
+    st.seljung_temp = (int16_t)gCUR.seljung_temp;
+    st.remaining_minute = gCUR.remaining_minute;
+    st.relay_state = gCUR.relay_state.u8;
+    st.error_info = gCUR.error_info.data;
+    st.second_counter = second_counter;
+    st.prepare_seconds = _prepare_seconds;
+    st.m0_value = _m0_value;
+    st.cooling_minutes = _cooling_minutes;
+    st.fan_start_delay = _fan_start_delay;
+    st.fan_error_count = _fan_error_count;
+    st.cooling_mode = _cooling_mode;
+    st.fan_started = _fan_started;
+    st.heater_on = _heater_on;
+    st.crc = crc32_le(0, (const uint8_t*)&st, offsetof(RTC_STATE, crc));
+    s_rtcState = st;
+}
+
+// RTC slow memory에서 제어 상태 복원
+// 의도한 재시작(ESP_RST_SW: 원격 리셋/OTA)만 복원. 패닉/WDT 리셋은 리셋 직전 상태가 원인일 수 있어
+// (히터/팬 출력을 그대로 되살리면 같은 상태로 다시 죽음) 콜드 부트처럼 loadFromFlash() 사용
+bool dataClass::loadFromRtc() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    RTC_STATE st = s_rtcState;
+    
+    if (reason != ESP_RST_SW) {
+        printf("RTC state: not a software restart (reset reason %d), loading from flash\n", (int)reason);
+        return false;
+    }
+    if (st.magic != RTC_STATE_MAGIC || st.version != RTC_STATE_VERSION ||
+        st.crc != crc32_le(0, (const uint8_t*)&st, offsetof(RTC_STATE, crc)) ||
+        st.dry_state > DRY_FINISH) {
+        printf("RTC state: invalid (reset reason %d), loading from flash\n", (int)reason);
+        return false;
+    }
+    
+    gCUR.auto_damper = st.auto_damper;
+    gCUR.flg.soft_off = st.soft_off;
+    gCUR.dry_state = (DRY_STATE)st.dry_state;
+    gCUR.seljung_temp = st.seljung_temp;
+    gCUR.remaining_minute = st.remaining_minute;
+    gCUR.relay_state.u8 = st.relay_state;
+    gCUR.error_info.data = st.error_info;
+    second_counter = st.second_counter;
+    _prepare_seconds = st.prepare_seconds;
+    _m0_value = st.m0_value;
+    gCUR.avr_NTC1 = st.m0_value;
+    _cooling_minutes = st.cooling_minutes;
+    _fan_start_delay = st.fan_start_delay;
+    _fan_error_count = st.fan_error_count;
+    _cooling_mode = st.cooling_mode;
+    _fan_started = st.fan_started;
+    _heater_on = st.heater_on;
+    
+    // LED 상태 동기화
+    gCUR.led.damper_auto = gCUR.auto_damper ? 1 : 0;
+    gCUR.led.damper_open = gCUR.relay_state.RY4 ? 0 : 1;
+    gCUR.led.damper_close = gCUR.relay_state.RY4 ? 1 : 0;
+    
+    // 리셋 직전 출력 상태 즉시 복구 (다음 제어 주기까지 공백 없음)
+    if (!gCUR.flg.soft_off && gCUR.error_info.data == 0) {
+        heaterOn(gCUR.relay_state.RY2);
+        fanOn(gCUR.relay_state.RY3);
+        damperOpen(!gCUR.relay_state.RY4);
+    }
+    
+    const char* state_str[] = {"DRY_PREPARE", "DRY_RUN", "DRY_COOL", "DRY_FINISH"};
+    printf("RTC state restored (reset reason %d) - Time: %d min, Temp: %d C, Power: %s, State: %s, Relay: 0x%02X\n",
+           (int)reason, gCUR.remaining_minute, gCUR.seljung_temp,
+           gCUR.flg.soft_off ? "OFF" : "ON",
+           state_str[gCUR.dry_state], gCUR.relay_state.u8);
+    return true;
 }
 
 // Flash에서 데이터 로드
@@ -127,6 +223,43 @@ void dataClass::clearFlash() {
     printf("Flash data cleared\n");
 }
 
+// 재부팅 없는 Power ON 전환
+// 기존 ESP.restart() 경로(Flash 로드 → 상태 동기화)와 같은 결과를 제자리에서 만든다.
+void dataClass::powerOn() {
+    gCUR.flg.soft_off = 0;
+    gCUR.error_info.data = 0;  // 에러 클리어
+    gCUR.fnd_state = FND_DRY_STATE;
+    
+    // 제어 내부 상태 초기화
+    _cooling_mode = false;
+    _cooling_minutes = 0;
+    _prepare_seconds = 0;
+    _fan_error_count = 0;
+    _heater_on = false;
+    _fan_start_delay = 0;
+    
+    // 남은 시간 체크: 00:00이면 DRY_FINISH, 아니면 DRY_RUN (팬 즉시 시작)
+    if (gCUR.remaining_minute == 0) {
+        gCUR.dry_state = DRY_FINISH;
+        _fan_started = false;
+        heaterOn(0);
+        fanOn(0);
+    } else {
+        gCUR.dry_state = DRY_RUN;
+        fanOn(1);
+        _fan_started = true;
+        // 히터는 다음 제어 주기(controlHeater)에서 측정 온도 기준으로 결정
+    }
+    damperOpen(1);
+    gCUR.led.damper_auto = gCUR.auto_damper ? 1 : 0;
+    
+    const char* state_str[] = {"DRY_PREPARE", "DRY_RUN", "DRY_COOL", "DRY_FINISH"};
+    LOGI("Power ON (no reboot) - DRY_STATE: %s\n", state_str[gCUR.dry_state]);
+    
+    // 출력 반영 후 Flash 저장 (NVS 쓰기 시간이 팬 기동을 지연시키지 않도록)
+    saveToFlash();
+}
+
 // 온도 측정 및 필터링
 void dataClass::measureAndFilterTemp() {
     gCUR.measure_ntc_temp = readNTCtempC();
@@ -162,25 +295,22 @@ void dataClass::controlHeater() {
     float set_temp = (float)gCUR.seljung_temp;
     float measured_temp = gCUR.measure_ntc_temp;
     
-    // 히터 상태 읽기 (현재 ON/OFF)
-    static bool heater_on = false;
-    
     // 히스테리시스 제어 (HEATER_HYSTERESIS = 0.5도)
     if (measured_temp < set_temp - HEATER_HYSTERESIS) {
         // 온도가 설정값보다 히스테리시스 이상 낮으면 히터 켜기
-        heater_on = true;
+        _heater_on = true;
     } else if (measured_temp > set_temp + HEATER_HYSTERESIS) {
         // 온도가 설정값보다 히스테리시스 이상 높으면 히터 끄기
-        heater_on = false;
+        _heater_on = false;
     }
     // 설정값 녤HEATER_HYSTERESIS 범위 내에서는 현재 상태 유지 (히스테리시스)
     
     // 히터 릴레이 제어 (GPIO 5)
-    heaterOn(heater_on); // 히터 상태 캡슐화 함수 호출
+    heaterOn(_heater_on); // 히터 상태 캡슐화 함수 호출
 
     // 댓퍼 자동 모드일 때: 히터 연동 제어
     if (gCUR.auto_damper) {
-        if (heater_on) {
+        if (_heater_on) {
             // 히터 ON = 댓퍼 닫힘(1)
             digitalWrite(PIN_DAMP, HIGH);
             gCUR.relay_state.RY4 = 1;  // 댓퍼 닫힘
@@ -225,7 +355,7 @@ void dataClass::onSecondElapsed() {
         if (gCUR.dry_state == DRY_RUN) {
             gCUR.dry_state = DRY_FINISH;
             saveToFlash();  // Flash에 저장
-            printf("Power OFF: DRY_RUN -> DRY_FINISH\n");
+            LOGI("Power OFF: DRY_RUN -> DRY_FINISH\n");
         }
         heaterOn(0); // 히터 OFF
         fanOn(0);    // 팬 OFF
@@ -236,8 +366,8 @@ void dataClass::onSecondElapsed() {
     // 디버그 모드에서만 상태 출력    
     if(gCUR.fnd_state == FND_DRY_STATE){
         const char* state_str[] = {"DRY_PREPARE", "DRY_RUN", "DRY_COOL", "DRY_FINISH"};
-        printf("onSecondElapsed system_sec[%d] Remaining_minute[%d] DRY_STATE[%s]\n", gCUR.system_sec,gCUR.remaining_minute, state_str[gCUR.dry_state]);
-        printf("NTC: %.1f℃ | SHT30: %.1f℃, %.1f%%, fan current: %d\n", gCUR.measure_ntc_temp, gCUR.sht30_temp, gCUR.sht30_humidity,gCUR.fan_current);
+        LOGD("onSecondElapsed system_sec[%d] Remaining_minute[%d] DRY_STATE[%s]\n", gCUR.system_sec,gCUR.remaining_minute, state_str[gCUR.dry_state]);
+        LOGD("NTC: %.1f℃ | SHT30: %.1f℃, %.1f%%, fan current: %d\n", gCUR.measure_ntc_temp, gCUR.sht30_temp, gCUR.sht30_humidity,gCUR.fan_current);
     }
     // 상태 일관성 체크: remaining_minute과 dry_state 동기화
     if (gCUR.dry_state == DRY_FINISH && gCUR.remaining_minute > 0) {
@@ -246,12 +376,12 @@ void dataClass::onSecondElapsed() {
         // 팬 즉시 시작 (지연 없음)
         _fan_started = false;
         _fan_start_delay = 0;
-        printf("State sync: remaining_minute > 0, DRY_FINISH -> DRY_RUN (Fan will start immediately)\n");
+        LOGI("State sync: remaining_minute > 0, DRY_FINISH -> DRY_RUN (Fan will start immediately)\n");
     } else if (gCUR.dry_state == DRY_RUN && gCUR.remaining_minute == 0) {
         // DRY_RUN 상태에서 시간이 00:00이면 DRY_COOL로 즉시 전환
         gCUR.dry_state = DRY_COOL;
         _cooling_minutes = COOLING_TIME;
-        printf("Time is 00:00 - Immediate transition to DRY_COOL (%d min)\n", COOLING_TIME);
+        LOGI("Time is 00:00 - Immediate transition to DRY_COOL (%d min)\n", COOLING_TIME);
     }
    
     // 에러 발생 시 제어 루프 중단 (안전 동작 + 부저)
@@ -269,7 +399,7 @@ void dataClass::onSecondElapsed() {
     
         // 모든 에러에 대해 1초마다 부저 울림
         beep(50); // 50ms ON
-        printf("ERROR DETECTED - Control loop stopped (error_info: 0x%02X)\n", gCUR.error_info.data);
+        LOGE("ERROR DETECTED - Control loop stopped (error_info: 0x%02X)\n", gCUR.error_info.data);
         return;  // 에러 발생 시 제어 중단
     }
     
@@ -282,19 +412,19 @@ void dataClass::onSecondElapsed() {
                 // Ensure outputs in prepare state
                 heaterOn(0); // 히터 OFF
                 fanOn(1);    // 팬 ON
-                printf("DRY_PREPARE: starting 10s prepare\r\n");
+                LOGI("DRY_PREPARE: starting 10s prepare\r\n");
             }
             // 카운트다운
             if (_prepare_seconds > 0) {
                 _prepare_seconds--;
-                printf("DRY_PREPARE: %d seconds remaining\n", _prepare_seconds);
+                LOGD("DRY_PREPARE: %d seconds remaining\n", _prepare_seconds);
                 if (_prepare_seconds == 0) {
                     // 준비 완료 → RUN 상태로 전환
                     gCUR.dry_state = DRY_RUN;
                     // Reset fan start delay so fan starts immediately in RUN
                     _fan_started = false;
                     _fan_start_delay = 0;
-                    printf("DRY_PREPARE complete -> DRY_RUN\n");
+                    LOGI("DRY_PREPARE complete -> DRY_RUN\n");
                 }
             }
             break;
@@ -303,13 +433,13 @@ void dataClass::onSecondElapsed() {
             if (!_fan_started) {
                 if (_fan_start_delay > 0) {
                     _fan_start_delay--;
-                    printf("Fan start delay: %d seconds remaining\n", _fan_start_delay);
+                    LOGD("Fan start delay: %d seconds remaining\n", _fan_start_delay);
                 } else {
                     // 지연 완료 후 팬 켜기
                     digitalWrite(PIN_FAN, HIGH);
                     gCUR.relay_state.RY3 = 1;  // 팬 ON
                     _fan_started = true;
-                    printf("Fan started\n");
+                    LOGI("Fan started\n");
                 }
             } else {
                 // 팬이 이미 시작된 경우에도 계속 ON 유지
@@ -325,7 +455,7 @@ void dataClass::onSecondElapsed() {
             // 냉각 모드: 히터 OFF, 팬 ON 유지
             heaterOn(0); // 히터 OFF
             fanOn(1);    // 팬 ON
-            printf("DRY_COOL: Heater OFF, Fan ON (Remaining: %d min)\n", _cooling_minutes);
+            LOGI("DRY_COOL: Heater OFF, Fan ON (Remaining: %d min)\n", _cooling_minutes);
             break;
             
         case DRY_FINISH:
@@ -333,7 +463,7 @@ void dataClass::onSecondElapsed() {
             heaterOn(0); // 히터 OFF  
             fanOn(0);    // 팬 OFF  
             damperOpen(1); // 댐퍼 열림
-            printf("DRY_FINISH: Heater OFF, Fan OFF, Damper OPEN\r\n");
+            LOGI("DRY_FINISH: Heater OFF, Fan OFF, Damper OPEN\r\n");
             break;
     }
 }
@@ -358,7 +488,7 @@ void dataClass::checkFanCurrent() {
                 // 3초 연속 에러면 FAN 에러 플래그 설정
                 if (!gCUR.error_info.fan_error) {
                     gCUR.error_info.fan_error = 1;
-                    printf("FAN ERROR: Current too low (ADC=%d)\n", current_adc);
+                    LOGE("FAN ERROR: Current too low (ADC=%d)\n", current_adc);
                 }
             }
         } else {
@@ -381,7 +511,7 @@ void dataClass::checkOverheat() {
         // 과열 에러 발생
         if (!gCUR.error_info.thermo_state) {
             gCUR.error_info.thermo_state = 1;
-            printf("OVERHEAT ERROR (PIN_OH=1): Turning off FAN and HEATER\n");
+            LOGE("OVERHEAT ERROR (PIN_OH=1): Turning off FAN and HEATER\n");
         }
         
         // FAN과 HEATER 즉시 OFF
@@ -400,7 +530,7 @@ void dataClass::checkOverheat() {
         // 정상 상태
         if (gCUR.error_info.thermo_state) {
             gCUR.error_info.thermo_state = 0;
-            printf("Overheat cleared (PIN_OH=0)\n");
+            LOGI("Overheat cleared (PIN_OH=0)\n");
         }
     }
 }
@@ -413,13 +543,13 @@ void dataClass::onMinuteElapsed() {
             if (gCUR.remaining_minute > 0) {
                 gCUR.remaining_minute--;
                 saveToFlash();  // Flash에 저장
-                printf("DRY_RUN - Remaining: %d min\n", gCUR.remaining_minute);
+                LOGD("DRY_RUN - Remaining: %d min\n", gCUR.remaining_minute);
                 
                 // 시간이 00:00 도달 → DRY_COOL로 전환
                 if (gCUR.remaining_minute == 0) {
                     gCUR.dry_state = DRY_COOL;
                     _cooling_minutes = COOLING_TIME;
-                    printf("Time reached 00:00 - Transition to DRY_COOL (%d min)\n", COOLING_TIME);
+                    LOGI("Time reached 00:00 - Transition to DRY_COOL (%d min)\n", COOLING_TIME);
                 }
             }
             break;
@@ -428,12 +558,12 @@ void dataClass::onMinuteElapsed() {
             // 냉각 모드 - COOLING_TIME 카운트다운
             if (_cooling_minutes > 0) {
                 _cooling_minutes--;
-                printf("DRY_COOL - Remaining: %d min\n", _cooling_minutes);
+                LOGD("DRY_COOL - Remaining: %d min\n", _cooling_minutes);
                 
                 // 냉각 시간 종료 → DRY_FINISH로 전환
                 if (_cooling_minutes == 0) {
                     gCUR.dry_state = DRY_FINISH;
-                    printf("Cooling complete - Transition to DRY_FINISH\n");
+                    LOGI("Cooling complete - Transition to DRY_FINISH\n");
                 }
             }
             break;
@@ -468,7 +598,7 @@ float dataClass::readNTCtempC() {
         if (!gCUR.error_info.thermist_short) {
             gCUR.error_info.thermist_short = 1;
             gCUR.error_info.thermist_open = 0;
-            printf("NTC SHORT ERROR: Voltage too low (%.2fV)\n", vADC);
+            LOGE("NTC SHORT ERROR: Voltage too low (%.2fV)\n", vADC);
         }
         return 99.9f;  // 에러 온도값
     }
@@ -478,7 +608,7 @@ float dataClass::readNTCtempC() {
         if (!gCUR.error_info.thermist_open) {
             gCUR.error_info.thermist_open = 1;
             gCUR.error_info.thermist_short = 0;
-            printf("NTC OPEN ERROR: Voltage too high (%.2fV)\n", vADC);
+            LOGE("NTC OPEN ERROR: Voltage too high (%.2fV)\n", vADC);
         }
         return 99.9f;  // 에러 온도값
     }
@@ -36,6 +36,13 @@ public:
     void loadFromFlash();
     void clearFlash();
     
+    // RTC slow memory 웜 리스타트 상태 저장/복원
+    void saveToRtc();
+    bool loadFromRtc();   // 유효한 웜 상태 복원 시 true (false면 loadFromFlash() 사용)
+    
+    // 재부팅 없는 Power ON 전환 (제어 상태 재초기화 + 출력 즉시 반영)
+    void powerOn();
+    
     // 콜백 함수
     void onSecondElapsed();
     void onMinuteElapsed();
@@ -58,6 +65,12 @@ private:
     float _last_filtered_temp;
     bool _temp_initialized;
     
+    // ADC 지수 이동 평균 필터 상태
+    float _m0_value;
+    
+    // 히스테리시스 히터 상태
+    bool _heater_on;
+    
     // ADC raw 값 필터링용
     int _adc_buffer[10];     // ADC raw 이동 평균 버퍼
     uint8_t _adc_buffer_idx; // ADC 버퍼 인덱스
@@ -0,0 +1,90 @@
+// diag.cpp - Task 스택/힙 진단 구현
+
+#include "diag.h"
+#include "../memPool/memPool.h"
+#include "../profiler/profiler.h"
+
+Diag gDiag;
+
+// ESP32 FreeRTOS의 스택 단위는 바이트 (StackType_t = uint8_t)
+void Diag::registerTask(TaskHandle_t handle, const char* name, uint32_t stackBytes) {
+  if (handle == nullptr) return;
+  portENTER_CRITICAL(&_mux);
+  if (_taskCount < DIAG_MAX_TASKS) {
+    DIAG_TASK& t = _tasks[_taskCount++];
+    t.handle = handle;
+    t.name = name;
+    t.stack_bytes = stackBytes;
+    t.free_min = stackBytes;
+  }
+  portEXIT_CRITICAL(&_mux);
+}
+
+void Diag::registerCurrentTask(const char* name, uint32_t stackBytes) {
+  registerTask(xTaskGetCurrentTaskHandle(), name, stackBytes);
+}
+
+void Diag::sample() {
+  uint8_t n;
+  portENTER_CRITICAL(&_mux);
+  n = _taskCount;
+  portEXIT_CRITICAL(&_mux);
+  for (uint8_t i = 0; i < n; i++) {
+    _tasks[i].free_min = uxTaskGetStackHighWaterMark(_tasks[i].handle) * sizeof(StackType_t);
+  }
+}
+
+// {"idx":3,"up":초,"heap":[free,min,largest,frag%],"psram":[free,largest],"tls":[live,peak],"stk":{"이름":최저여유,...}}
+size_t Diag::format(char* buf, size_t size) {
+  sample();
+  const MEM_STATS& m = gMem.stats();
+  int n = snprintf(buf, size,
+    "{\"idx\":3,\"up\":%lu,\"heap\":[%lu,%lu,%lu,%u],\"psram\":[%lu,%lu],\"tls\":[%lu,%lu],\"stk\":{",
+    (unsigned long)(millis() / 1000),
+    (unsigned long)m.internal_free, (unsigned long)m.internal_min_free,
+    (unsigned long)m.internal_largest, m.internal_frag_pct,
+    (unsigned long)m.psram_free, (unsigned long)m.psram_largest,
+    (unsigned long)m.tls_live, (unsigned long)m.tls_peak);
+  if (n < 0 || (size_t)n >= size) return 0;
+  size_t len = n;
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    n = snprintf(buf + len, size - len, "%s\"%s\":%lu", i ? "," : "",
+                 _tasks[i].name, (unsigned long)_tasks[i].free_min);
+    if (n < 0 || (size_t)n >= size - len) return 0;
+    len += n;
+  }
+  if (len + 3 > size) return 0;
+  buf[len++] = '}';
+  buf[len++] = '}';
+  buf[len] = '\0';
+  return len;
+}
+
+void Diag::print() {
+  sample();
+  Serial.printf("[Diag] Uptime %lu s\n", (unsigned long)(millis() / 1000));
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    const DIAG_TASK& t = _tasks[i];
+    Serial.printf("[Diag] Stack %-14s %5lu / %5lu bytes free (used %lu%%)\n", t.name,
+                  (unsigned long)t.free_min, (unsigned long)t.stack_bytes,
+                  (unsigned long)((t.stack_bytes - t.free_min) * 100 / t.stack_bytes));
+  }
+  gMem.printStats();
+}
+
+void Diag::pollSerial() {
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c == '\r' || c == '\n') {
+      _line[_lineLen] = '\0';
+      if (_lineLen > 0 && strcmp(_line, "diag") == 0) print();
+#if ENABLE_PROFILER
+      else if (strcmp(_line, "prof") == 0) gProf.print();
+      else if (strcmp(_line, "prof reset") == 0) gProf.reset();
+#endif
+      _lineLen = 0;
+    } else if (_lineLen < sizeof(_line) - 1) {
+      _line[_lineLen++] = c;
+    }
+  }
+}
@@ -0,0 +1,40 @@
+// diag.h - 런타임 진단 (Task 스택 최저 여유 + 힙 상태)
+//
+// 생성 시점에 등록된 Task의 uxTaskGetStackHighWaterMark와 내부 RAM/PSRAM 힙 지표를 모아
+// MQTT 진단 토픽(MQTT Task가 DIAG_PUBLISH_INTERVAL_MS마다)과 시리얼("diag" 입력)로 보고한다.
+// 스택 크기를 실측 기반으로 줄이고, 누수를 장애 전에 발견하기 위한 용도.
+// 자체 삭제되는 Task(NetBootTask)는 핸들이 무효가 되므로 등록하지 않는다.
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "../config.h"
+
+// Task 스택 항목
+typedef struct {
+  TaskHandle_t handle;
+  const char* name;           // 정적 문자열
+  uint32_t stack_bytes;       // 생성 시 스택 크기
+  uint32_t free_min;          // 최저 여유 (바이트, 샘플 시 갱신)
+} DIAG_TASK;
+
+class Diag {
+public:
+  void registerTask(TaskHandle_t handle, const char* name, uint32_t stackBytes);
+  void registerCurrentTask(const char* name, uint32_t stackBytes);
+  void sample();                                   // 스택 최저 여유 갱신
+  size_t format(char* buf, size_t size);           // MQTT 진단 JSON (idx:3)
+  void print();                                    // 시리얼 보고서
+  void pollSerial();                               // loop()에서 호출 - "diag" 입력 시 print() ("prof"/"prof reset": 프로파일러)
+
+private:
+  DIAG_TASK _tasks[DIAG_MAX_TASKS];
+  uint8_t _taskCount = 0;
+  char _line[16];                                  // 시리얼 입력 줄
+  uint8_t _lineLen = 0;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern Diag gDiag;
@@ -0,0 +1,61 @@
+// keyGesture.cpp - 키 디바운스/제스처 분류
+
+#include "keyGesture.h"
+
+void KeyGesture::reset() {
+  _candidate = KEY_NULL;
+  _stableCnt = 0;
+  _key = KEY_NULL;
+  _pressAt = 0;
+  _nextRepeatAt = 0;
+  _longFired = false;
+}
+
+void KeyGesture::make(KEY_EVENT& e, uint8_t type, uint8_t key, uint32_t now, uint32_t held) {
+  e.ts_ms = now;
+  e.held_ms = (held > 0xFFFF) ? 0xFFFF : (uint16_t)held;
+  e.key = key;
+  e.type = type;
+}
+
+uint8_t KeyGesture::step(uint8_t raw, uint32_t nowMs, KEY_EVENT out[2]) {
+  uint8_t n = 0;
+
+  // 디바운스: 같은 값이 연속 KEY_DEBOUNCE_SAMPLES번
+  if (raw != _candidate) {
+    _candidate = raw;
+    _stableCnt = 1;
+  } else if (_stableCnt < KEY_DEBOUNCE_SAMPLES) {
+    _stableCnt++;
+  }
+
+  if (_stableCnt >= KEY_DEBOUNCE_SAMPLES && _candidate != _key) {
+    // 키 전환: 이전 키 RELEASE → 새 키 PRESS
+    if (_key != KEY_NULL) {
+      make(out[n++], KEY_EVT_RELEASE, _key, nowMs, nowMs - _pressAt);
+    }
+    _key = _candidate;
+    _longFired = false;
+    if (_key != KEY_NULL) {
+      _pressAt = nowMs;
+      _nextRepeatAt = nowMs + KEY_REPEAT_DELAY_MS;
+      make(out[n++], KEY_EVT_PRESS, _key, nowMs, 0);
+    }
+    return n;
+  }
+
+  if (_key == KEY_NULL) return n;
+
+  uint32_t held = nowMs - _pressAt;
+  if (repeats(_key)) {
+    // 기준 시각을 누적해서 샘플 지터가 있어도 반복이 빠지지 않음
+    if ((int32_t)(nowMs - _nextRepeatAt) >= 0) {
+      _nextRepeatAt += KEY_REPEAT_RATE_MS;
+      make(out[n++], KEY_EVT_REPEAT, _key, nowMs, held);
+    }
+  } else if (!_longFired && held >= KEY_LONG_PRESS_MS) {
+    _longFired = true;
+    make(out[n++], KEY_EVT_LONG, _key, nowMs, held);
+  }
+  return n;
+}
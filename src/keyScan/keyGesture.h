@@ -0,0 +1,48 @@
+// keyGesture.h - 키 디바운스/제스처 상태 기계 (Arduino/FreeRTOS 의존성 없음)
+//
+// 샘플(키 코드)과 시각을 받아 키 상태 변화를 이벤트(PRESS/RELEASE/REPEAT/LONG)로 바꾼다.
+//  - 디바운스: 같은 값이 KEY_DEBOUNCE_SAMPLES번 연속일 때 확정
+//  - 반복: 누른 뒤 KEY_REPEAT_DELAY_MS, 이후 KEY_REPEAT_RATE_MS 간격 (기준 시각 누적 → 누락 없음)
+//  - 길게: KEY_LONG_PRESS_MS 경과 시 LONG 1회 (KEY_PWR - 반복 없음)
+//  - 조합키(KEY_123)는 getButtons()가 단일 키 코드로 디코딩하므로 일반 키와 동일하게 처리
+// 짧게 누름 판정은 RELEASE의 held_ms < KEY_LONG_PRESS_MS로 한다.
+// 호스트 테스트: test/test_key_gesture (pio test -e native)
+
+#pragma once
+
+#include <stdint.h>
+#include "../config.h"
+#include "../TM1638Display/keyMap.h"
+
+typedef enum {
+  KEY_EVT_PRESS = 0,
+  KEY_EVT_RELEASE,
+  KEY_EVT_REPEAT,
+  KEY_EVT_LONG,
+} KEY_EVT_TYPE;
+
+typedef struct {
+  uint32_t ts_ms;       // 이벤트 시각 (millis)
+  uint16_t held_ms;     // 누른 뒤 경과 (PRESS는 0)
+  uint8_t key;          // KEY_MAP
+  uint8_t type;         // KEY_EVT_TYPE
+} KEY_EVENT;
+
+// ========== 제스처 상태 기계 ==========
+class KeyGesture {
+public:
+  // 샘플 1개 처리 → 생성된 이벤트 수 (최대 2: 키 전환 시 RELEASE + PRESS)
+  uint8_t step(uint8_t raw, uint32_t nowMs, KEY_EVENT out[2]);
+  void reset();
+
+private:
+  static bool repeats(uint8_t key) { return key != KEY_PWR && key != KEY_NULL; }
+  static void make(KEY_EVENT& e, uint8_t type, uint8_t key, uint32_t now, uint32_t held);
+
+  uint8_t _candidate = KEY_NULL;  // 디바운스 중인 값
+  uint8_t _stableCnt = 0;
+  uint8_t _key = KEY_NULL;        // 확정된 키
+  uint32_t _pressAt = 0;
+  uint32_t _nextRepeatAt = 0;
+  bool _longFired = false;
+};
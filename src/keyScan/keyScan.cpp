@@ -0,0 +1,89 @@
+// keyScan.cpp - esp_timer로 깨우는 키 스캔 Task와 이벤트 큐
+
+#include "keyScan.h"
+#include "../binLog/binLog.h"
+#include "../diag/diag.h"
+
+KeyScanner gKeys;
+
+// ========== KeyScanner ==========
+bool KeyScanner::begin(KEY_READ_FN readFn) {
+  _read = readFn;
+  _gesture.reset();
+
+  _queue = xQueueCreate(KEY_EVENT_QUEUE_LEN, sizeof(KEY_EVENT));
+  if (_queue == nullptr) {
+    Serial.println("[Key] queue create failed");
+    return false;
+  }
+
+  // 버스 읽기는 전용 Task에서 (UI Task의 디스플레이 버스트 동안 뮤텍스 대기 가능)
+  if (xTaskCreatePinnedToCore(scanTask, "KeyScanTask", KEY_SCAN_TASK_STACK, this, 3, &_task, 1) != pdPASS) {
+    Serial.println("[Key] task create failed");
+    return false;
+  }
+  gDiag.registerTask(_task, "KeyScanTask", KEY_SCAN_TASK_STACK);
+
+  esp_timer_create_args_t args = {};
+  args.callback = &KeyScanner::onTimer;
+  args.arg = this;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "keyScan";
+  if (esp_timer_create(&args, &_timer) != ESP_OK ||
+      esp_timer_start_periodic(_timer, KEY_SCAN_PERIOD_MS * 1000ULL) != ESP_OK) {
+    Serial.println("[Key] timer start failed");
+    return false;
+  }
+
+  Serial.printf("[Key] scanner started (%d ms, debounce %d)\n", KEY_SCAN_PERIOD_MS, KEY_DEBOUNCE_SAMPLES);
+  return true;
+}
+
+// esp_timer Task 컨텍스트 - 막히지 않도록 스캔 Task만 깨움
+void KeyScanner::onTimer(void* arg) {
+  KeyScanner* self = static_cast<KeyScanner*>(arg);
+  xTaskNotifyGive(self->_task);
+}
+
+void KeyScanner::scanTask(void* parameter) {
+  KeyScanner* self = static_cast<KeyScanner*>(parameter);
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // 밀린 알림은 한 번의 스캔으로 합침
+    self->scan();
+  }
+}
+
+void KeyScanner::scan() {
+  KEY_EVENT evt[2];
+  uint8_t n = _gesture.step(_read(), millis(), evt);
+
+  for (uint8_t i = 0; i < n; i++) {
+    if (xQueueSend(_queue, &evt[i], 0) != pdTRUE) {
+      _dropped++;
+      continue;
+    }
+    LOGD("[Key] evt %u key %u held %u\n", evt[i].type, evt[i].key, evt[i].held_ms);
+  }
+}
+
+bool KeyScanner::pop(KEY_EVENT& evt, TickType_t wait) {
+  if (_queue == nullptr) return false;
+  return xQueueReceive(_queue, &evt, wait) == pdTRUE;
+}
+
+bool KeyScanner::wait(TickType_t ticks) {
+  if (_queue == nullptr) {
+    vTaskDelay(ticks);
+    return false;
+  }
+  KEY_EVENT evt;
+  return xQueuePeek(_queue, &evt, ticks) == pdTRUE;
+}
+
+// 디바운스/반복은 ms 기준이라 주기가 바뀌어도 판정 시각만 샘플 간격만큼 늦어진다
+void KeyScanner::setIdle(bool idle) {
+  if (_timer == nullptr || idle == _idle) return;
+  _idle = idle;
+  esp_timer_stop(_timer);
+  esp_timer_start_periodic(_timer, (idle ? KEY_SCAN_IDLE_PERIOD_MS : KEY_SCAN_PERIOD_MS) * 1000ULL);
+}
@@ -0,0 +1,45 @@
+// keyScan.h - 타이머 기반 키 스캐너 + 제스처 이벤트 큐
+//
+// esp_timer가 KEY_SCAN_PERIOD_MS마다 KeyScanTask를 깨우고, Task가 TM1638 키 스캔을 읽어
+// KeyGesture(keyGesture.h)로 디바운스/제스처 판정 후 이벤트를 큐에 넣는다.
+// 버스 트랜잭션(뮤텍스 대기 포함)은 전용 Task에서 하므로 esp_timer Task를 막지 않는다.
+// 소비자(UI Task의 key_process)는 상태를 폴링하지 않고 이벤트만 꺼내 처리한다.
+// UI 유휴 시 setIdle(true)로 샘플 주기를 KEY_SCAN_IDLE_PERIOD_MS로 늦춘다.
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "../config.h"
+#include "keyGesture.h"
+
+// ========== 스캐너 ==========
+typedef uint8_t (*KEY_READ_FN)();
+
+class KeyScanner {
+public:
+  bool begin(KEY_READ_FN readFn);                   // 큐 생성 + 주기 타이머 시작
+  bool pop(KEY_EVENT& evt, TickType_t wait = 0);    // 이벤트 꺼내기
+  bool wait(TickType_t ticks);                      // 이벤트가 올 때까지 대기 (꺼내지 않음)
+  void setIdle(bool idle);                          // 샘플 주기 전환
+  bool pending() const { return _queue && uxQueueMessagesWaiting(_queue) > 0; }
+  uint32_t dropped() const { return _dropped; }
+
+private:
+  static void onTimer(void* arg);
+  static void scanTask(void* parameter);
+  void scan();
+
+  KEY_READ_FN _read = nullptr;
+  KeyGesture _gesture;
+  QueueHandle_t _queue = nullptr;
+  esp_timer_handle_t _timer = nullptr;
+  TaskHandle_t _task = nullptr;
+  uint32_t _dropped = 0;
+  bool _idle = false;
+};
+
+extern KeyScanner gKeys;
@@ -8,7 +8,16 @@
 #include "typedef.h"
 #include "dataClass/dataClass.h"
 #include "TM1638Display/TM1638Display.h"
+#include "keyScan/keyScan.h"
 #include "mqtt/mqttClient.h"
+#include "bootSeq/bootSeq.h"
+#include "wifiManager/wifiManager.h"
+#include "alarm/alarmEngine.h"
+#include "updateAPI/updateAPI.h"
+#include "memPool/memPool.h"
+#include "diag/diag.h"
+#include "profiler/profiler.h"
+#include "binLog/binLog.h"
 
 // ========== 전역 변수 ==========
 uint64_t gChipID = 0;            // ESP32 Chip ID (MAC 기반 고유 ID)
@@ -17,13 +26,15 @@ bool system_running = false;     // 운전 중 플래그
 uint16_t running_seconds = 0;    // 운전 경과 시간 (초)
 bool smartconfig_request = false;  // SmartConfig 요청 플래그
 bool smartconfig_running = false;  // SmartConfig 실행 중
+bool smartconfig_stop_request = false;  // SmartConfig 중단 요청 (KEY_PWR)
 unsigned long smartconfig_start_time = 0;  // SmartConfig 시작 시간
+bool restart_request = false;  // 원격 재시작 요청 (MQTT 명령 배치 - loop() 끝에서 처리)
 
 // ========== 전역 객체 ==========
 dataClass gData;
 TM1638Display gDisplay(PIN_FND_STB, PIN_FND_CLK, PIN_FND_DIO, FND_BRIGHTNESS);
 // MQTT 클라이언트는 mqttClient.cpp에서 정의됨
-Preferences preferences;
+// WiFi 관리자(gWiFi)는 wifiManager.cpp에서 정의됨 (Preferences "wifi" 담당)
 
 // ========== FreeRTOS Task 핸들 ==========
 TaskHandle_t uiTaskHandle = NULL;
@@ -47,6 +58,7 @@ void IRAM_ATTR onTimer() {
   portENTER_CRITICAL_ISR(&timerMux);
   
   // 1초 플래그 설정
+  PROF_TICK_ISR();
   flag_1sec = true;
   
   // 1분 카운터 증가
@@ -69,6 +81,7 @@ void IRAM_ATTR onZeroCross() {
   // 120번 카운트 = 1초
   if (zc_count >= 120) {
     zc_count = 0;
+    PROF_TICK_ISR();
     flag_1sec = true;
     
     // 1분 카운터 증가
@@ -84,65 +97,69 @@ void IRAM_ATTR onZeroCross() {
 #endif
 
 // ========== UI Task (Keyboard + Display) ==========
+// 표시 내용에 영향을 주는 상태 요약 - 바뀌면 활성 주기로 복귀
+static uint32_t uiStateSignature() {
+  uint32_t sig = (uint32_t)gCUR.fnd_state
+               | ((uint32_t)gCUR.dry_state << 4)
+               | ((uint32_t)(gCUR.flg.soft_off ? 1 : 0) << 8)
+               | ((uint32_t)gCUR.led.data << 16)
+               | ((uint32_t)gCUR.error_info.data << 24);
+  return sig ^ ((uint32_t)gCUR.seljung_temp << 9) ^ ((uint32_t)gCUR.remaining_minute << 12);
+}
+
+// 유휴 진입 허용: 전원 off 또는 건조 완료 상태에서 일반 화면일 때만
+static bool uiIdleAllowed() {
+  return gCUR.fnd_state == FND_DRY_STATE &&
+         (gCUR.flg.soft_off || gCUR.dry_state == DRY_FINISH);
+}
+
 void uiTask(void *parameter) {
-  TickType_t xLastWakeTime = xTaskGetTickCount();
-  const TickType_t xFrequency = pdMS_TO_TICKS(50);  // 50ms 주기
-  
-  uint8_t displayCounter = 0;  // Display 업데이트 카운터
+  uint32_t lastActivity = millis();
+  uint32_t lastDisplay = 0;
+  uint32_t lastSig = uiStateSignature();
+  bool idle = false;
   
   for (;;) {
-    // Keyboard 처리 (매 50ms)
+    // Keyboard 이벤트 처리 (샘플링은 키 스캐너 타이머)
+    bool keyed = gKeys.pending();
+    PROF_BEGIN(key_start);
     gDisplay.key_process();
+    PROF_END(PROF_KEY, key_start);
+
+    // 입력/상태 변화 → 활성, UI_IDLE_AFTER_MS 동안 없으면 유휴
+    uint32_t now = millis();
+    uint32_t sig = uiStateSignature();
+    if (keyed || sig != lastSig || !uiIdleAllowed()) {
+      lastActivity = now;
+      lastSig = sig;
+    }
+    bool wantIdle = (now - lastActivity >= UI_IDLE_AFTER_MS);
+    if (wantIdle != idle) {
+      idle = wantIdle;
+      gKeys.setIdle(idle);
+      LOGI("[UI] %s\n", idle ? "idle (1s refresh)" : "active");
+    }
     
-    // Display 처리 (매 100ms = 50ms x 2)
-    displayCounter++;
-    if (displayCounter >= 2) {
+    // Display 처리 (활성: 100ms, 유휴: 매 초 경계)
+    if (idle || now - lastDisplay >= UI_DISPLAY_PERIOD_MS) {
+      PROF_BEGIN(disp_start);
       gDisplay.sendToDisplay();
-      displayCounter = 0;
+      PROF_END(PROF_DISPLAY, disp_start);
+      lastDisplay = now;
     }
     
-    vTaskDelayUntil(&xLastWakeTime, xFrequency);
+    // 다음 주기까지 대기 - 키 이벤트가 오면 즉시 깨어남
+    // 유휴 시에는 깜빡임(1초 위상) 경계 직후에 깨어나 점 표시가 어긋나지 않게 함
+    uint32_t waitMs = idle ? (1000 - (millis() % 1000) + 2) : UI_ACTIVE_PERIOD_MS;
+    gKeys.wait(pdMS_TO_TICKS(waitMs));
   }
 }
 
-// ========== WiFi 연결 (ESPTouch SmartConfig 지원) ==========
-void connectWiFi() {
-  // Flash에서 저장된 WiFi 정보 읽기
-  preferences.begin("wifi", true);
-  String saved_ssid = preferences.getString("ssid", "");
-  String saved_pass = preferences.getString("password", "");
-  preferences.end();
-  
-  WiFi.mode(WIFI_STA);
-  
-  // 저장된 WiFi 정보가 있으면 사용
-  if (saved_ssid.length() > 0) {
-    Serial.println("Using saved WiFi credentials");
-    Serial.print("SSID: ");
-    Serial.println(saved_ssid);
-    WiFi.begin(saved_ssid.c_str(), saved_pass.c_str());
-  } else {
-    // 없으면 config.h의 기본값 사용
-    Serial.println("Using default WiFi credentials");
-    WiFi.begin(WIFI_SSID, WIFI_PASS);
-  }
-  
-  Serial.print("Connecting to WiFi");
-  int cnt = 0;
-  while (WiFi.status() != WL_CONNECTED && cnt < 20) {
-    delay(500);
-    Serial.print(".");
-    cnt++;
-  }
-  
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\nWiFi connected!");
-    Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
-    gCUR.led.network = 1;  // 네트워크 활성화 LED ON
-  } else {
-    Serial.println("\nWiFi connection failed. Continuing without WiFi.");
-    gCUR.led.network = 0;  // 네트워크 비활성화 LED OFF
+// ========== WiFi 링크 상태 구독 (WiFi 이벤트 Task 컨텍스트) ==========
+void onWiFiLink(WIFI_LINK_STATE state, void* arg) {
+  gCUR.led.network = (state == WIFI_LINK_UP) ? 1 : 0;
+  if (state == WIFI_LINK_UP) {
+    gBoot.mark(BOOT_STAGE_WIFI);  // 첫 연결 시각만 타임라인에 기록
   }
 }
 
@@ -153,6 +170,7 @@ void startSmartConfig() {
   // FND 상태 변경: SmartConfig 시작
   gCUR.fnd_state = FND_SMARTCONFIG_START;
   
+  gWiFi.pause(true);  // SmartConfig 중에는 WiFi 관리자 재시도 중지
   WiFi.mode(WIFI_STA);
   WiFi.beginSmartConfig();
   
@@ -174,8 +192,9 @@ void processSmartConfig() {
     Serial.println("\nSmartConfig Timeout (30 sec)");
     WiFi.stopSmartConfig();
     smartconfig_running = false;
-    gCUR.led.network = 0;
     gCUR.fnd_state = FND_DRY_STATE;
+    gWiFi.pause(false);
+    gWiFi.reconnect();  // 저장된 네트워크로 복귀
     return;
   }
   
@@ -190,20 +209,33 @@ void processSmartConfig() {
     // FND 상태: SmartConfig 완료
     gCUR.fnd_state = FND_SMARTCONFIG_DONE;
     
-    // WiFi 정보를 Flash에 저장
-    preferences.begin("wifi", false);
-    preferences.putString("ssid", WiFi.SSID());
-    preferences.putString("password", WiFi.psk());
-    preferences.end();
+    // WiFi 정보를 Flash에 저장 (저장 목록 맨 앞 slot 0)
+    gWiFi.addNetwork(WiFi.SSID().c_str(), WiFi.psk().c_str());
     
     Serial.println("WiFi credentials saved to Flash");
-    gCUR.led.network = 1;
+    gWiFi.pause(false);  // 연결 상태는 WiFi 이벤트로 반영
     
     // 2초 후 정상 모드로 복귀 (타이머로 처리)
     smartconfig_start_time = millis();  // 2초 대기용 재사용
   }
 }
 
+// ========== SmartConfig 중단 + 저장된 WiFi로 재연결 (재부팅 없음) ==========
+void stopSmartConfig() {
+  if (smartconfig_running) {
+    WiFi.stopSmartConfig();
+    smartconfig_running = false;
+    Serial.println("SmartConfig stopped by user");
+  }
+  if (gCUR.fnd_state == FND_SMARTCONFIG_START || gCUR.fnd_state == FND_SMARTCONFIG_WAIT) {
+    gCUR.fnd_state = FND_DRY_STATE;
+  }
+  
+  // 저장된 네트워크로 제자리 재연결 (WiFi 관리자가 비동기 처리)
+  gWiFi.pause(false);
+  gWiFi.reconnect();
+}
+
 // ========== SmartConfig DONE 후 대기 ==========
 void checkSmartConfigDone() {
   if (gCUR.fnd_state == FND_SMARTCONFIG_DONE) {
@@ -290,9 +322,41 @@ void initTimerInterrupt() {
 #endif
 }
 
+// ========== 네트워크 부팅 Task (WiFi → OTA → MQTT, 제어 루프와 병렬) ==========
+void netBootTask(void *parameter) {
+  // WiFi 연결 대기 (연결은 WiFi 관리자가 비동기 진행, 이 Task만 대기)
+  if (gBoot.waitFor(BOOT_EVT_WIFI, WIFI_BOOT_WAIT_MS)) {
+    // OTA 설정 (TLS 연결보다 먼저 - 빠르게 준비됨)
+    setupOTA();
+    gBoot.mark(BOOT_STAGE_OTA);
+  }
+  
+  // MQTT Task 시작 (연결/TLS 핸드셰이크는 MQTT Task에서 진행)
+  gMQTTClient.begin();
+  
+  // 공정 업로드 Task 시작 (작업은 제어 루프 tick()이 dry_state 전환으로 생성)
+  gUpdateAPI.begin();
+  
+  // 부팅 타임라인 발행 (펌웨어 버전별 콜드 스타트 시간 추적)
+  if (gBoot.waitFor(BOOT_EVT_MQTT, MQTT_BOOT_WAIT_MS)) {
+    gMQTTClient.publishBoot();
+  }
+  
+  gBoot.print();
+  gBoot.setEvent(BOOT_EVT_NET_DONE);  // 이후 loop()가 WiFi/MQTT/OTA 처리 담당
+  vTaskDelete(NULL);
+}
+
 // ========== setup ==========
 void setup() {
   Serial.begin(115200);
+  gBoot.begin();
+  gMem.begin();  // TLS 풀 + mbedTLS 할당 훅 (네트워크 시작 전)
+  gDiag.registerCurrentTask("loopTask", getArduinoLoopTaskStackSize());
+  gBinLog.begin();  // LOGx() 출력 Task (Core 0)
+#if ENABLE_PROFILER
+  gProf.begin();
+#endif
  // delay(2000);
   
   Serial.println("\n\n===========================================");
@@ -303,20 +367,47 @@ void setup() {
   gChipID = ESP.getEfuseMac();
   Serial.printf("ESP32 Chip ID: %04X%08X\n", (uint16_t)(gChipID >> 32), (uint32_t)gChipID);
   
-  // 핀 초기화
+  // ---- Stage 1: 출력 안전 상태 ----
   initPins();
+  gBoot.mark(BOOT_STAGE_PINS);
   
   // ADC 설정 (11dB 감쇠로 0-3.3V 범위 사용)
   analogSetAttenuation(ADC_11db);
   analogReadResolution(12);  // 12비트 해상도 (0-4095)
   Serial.println("ADC configured: 11dB attenuation, 12-bit resolution (0-3.3V)");
   
-  // TM1638 디스플레이 초기화
+  // ---- Stage 2: 제어 상태 로드 ----
+  // FND 부팅 화면 표시 (REVISION) - 웜 리스타트 시 loadFromRtc()에서 생략
+  gCUR.fnd_state = FND_BOOT;
+  
+  // dataClass 초기화
+  gData.begin();
+  
+  // 웜 리스타트: RTC 메모리에서 제어 상태 즉시 복원, 콜드 부트: Flash에서 설정값 로드 (온도, 시간, 댐퍼 모드)
+  bool warm_boot = gData.loadFromRtc();
+  if (!warm_boot) {
+    gData.loadFromFlash();
+  } else {
+    gCUR.fnd_state = FND_DRY_STATE;  // 웜 리스타트 시 부팅 화면 생략
+  }
+  gBoot.mark(BOOT_STAGE_STATE);
+  
+  // 시스템 시작 이벤트 (Power-On) - 알람 엔진이 MQTT 큐 생성 후 에지로 발행
+  gCUR.pubEvent.uEvent.u16 = 0x0001;  // POWER_ON 비트
+  gCUR.pubEvent.ex_uEvent.u16 = 0x0000;
+  
+  // ---- Stage 3: 제어 루프 가동 (타이머/인터럽트 시작) ----
+  initTimerInterrupt();
+  gBoot.mark(BOOT_STAGE_CONTROL);
+  if (gBoot.stageMs(BOOT_STAGE_CONTROL) > BOOT_CONTROL_BUDGET_MS) {
+    Serial.printf("[Boot] WARNING: control up at %lu ms (budget %d ms)\n",
+                  (unsigned long)gBoot.stageMs(BOOT_STAGE_CONTROL), BOOT_CONTROL_BUDGET_MS);
+  }
+  
+  // ---- Stage 4: 디스플레이 + UI Task ----
   gDisplay.begin();
   gDisplay.clear();
-  
-  // FND 부팅 화면 표시 (REVISION) - 즉시 시작
-  gCUR.fnd_state = FND_BOOT;
+  gKeys.begin([]() { return gDisplay.getButtons(); });  // 키 스캔 타이머 (KEY_SCAN_PERIOD_MS)
   
   // FreeRTOS UI Task 생성 (Keyboard + Display 통합) - 최우선 실행
   xTaskCreatePinnedToCore(
@@ -328,54 +419,46 @@ void setup() {
     &uiTaskHandle,      // Task 핸들
     1                   // Core 1에서 실행
   );
+  gDiag.registerTask(uiTaskHandle, "UITask", 4096);
+  gBoot.mark(BOOT_STAGE_UI);
   
-  // UI Task 시작 대기 (디스플레이가 업데이트되도록)
-  delay(100);
-  
-  // dataClass 초기화
-  gData.begin();
-  
-  // Flash에서 설정값 로드 (온도, 시간, 댐퍼 모드)
-  gData.loadFromFlash();
-  
-  // 타이머/인터럽트 시작
-  initTimerInterrupt();
-  
-  // WiFi 연결
-  connectWiFi();
-  
-  // MQTT 클라이언트 초기화
-  gMQTTClient.begin();
-  
-  // 시스템 시작 이벤트 발행 (Power-On)
-  //delay(2000);  // MQTT 연결 대기
-   delay(200);  // MQTT 연결 대기
-  if (gMQTTClient.isConnected()) {
-    // Power-On 이벤트 설정
-    gCUR.pubEvent.uEvent.u16 = 0x0001;  // POWER_ON 비트
-    gCUR.pubEvent.ex_uEvent.u16 = 0x0000;
-    gCUR.pubEvent.xor_uEvent.u16 = 0x0001;  // 변경된 비트
-    gMQTTClient.publishEvent(gCUR.pubEvent.xor_uEvent.u16, gCUR.pubEvent.uEvent.u16);
-  }
-  
-  // OTA 설정
-  if (WiFi.status() == WL_CONNECTED) {
-    setupOTA();
-  }
+  // ---- Stage 5: 네트워크 (WiFi/OTA/MQTT) - 별도 Task에서 병렬 진행 ----
+  gWiFi.subscribe(onWiFiLink);
+  gWiFi.begin();  // 비동기 연결 시작 (진행은 loop()의 gWiFi.loop())
+  xTaskCreatePinnedToCore(
+    netBootTask,        // Task 함수
+    "NetBootTask",      // Task 이름
+    4096,               // Stack 크기 (OTA/mDNS 시작)
+    NULL,               // Task 파라미터
+    1,                  // 우선순위 (1 = 낮음)
+    NULL,               // Task 핸들 (완료 후 자체 삭제)
+    0                   // Core 0 (WiFi 스택과 같은 코어)
+  );
   
-  Serial.println("Setup complete!");
+  Serial.println("Setup complete! (network continues in NetBootTask)");
   Serial.printf("Loaded: Temp=%d°C, Time=%dmin, Damper=%s\n", 
                 gCUR.seljung_temp, gCUR.remaining_minute, 
                 gCUR.auto_damper ? "AUTO" : "MANUAL");
-  Serial.println("FreeRTOS UITask created: Keyboard(50ms) + Display(100ms)");
-  Serial.println("Showing REVISION for 3 seconds...");
+  Serial.printf("FreeRTOS UITask created: key events from KeyScanTask (%d ms scan) + Display(%d ms), idle 1s / %d ms scan\n",
+                KEY_SCAN_PERIOD_MS, UI_DISPLAY_PERIOD_MS, KEY_SCAN_IDLE_PERIOD_MS);
+  if (!warm_boot) {
+    Serial.println("Showing REVISION for 3 seconds...");  // 웜 리스타트는 부팅 화면 생략
+  }
   Serial.println("===========================================\n");
 }
 
 // ========== loop ==========
 void loop() {
+  // 네트워크 부팅 Task 완료 전에는 OTA 시작을 loop()에서 하지 않음
+  bool net_ready = gBoot.isReady(BOOT_EVT_NET_DONE);
+  PROF_BEGIN(loop_start);
+
   // 1) Always handle OTA first so packets are processed frequently
-  ArduinoOTA.handle();
+  if (gBoot.isReady(BOOT_EVT_OTA)) {
+    PROF_BEGIN(ota_start);
+    ArduinoOTA.handle();
+    PROF_END(PROF_OTA, ota_start);
+  }
 
   // 2) Boot display handling (non-blocking)
   static unsigned long boot_display_start = millis();
@@ -388,16 +471,14 @@ void loop() {
     }
   }
 
-  // 3) Periodic WiFi check (every 5s) and LED state
-  static unsigned long lastWiFiCheck = 0;
-  if (millis() - lastWiFiCheck > 5000) {
-    lastWiFiCheck = millis();
-    if (WiFi.status() == WL_CONNECTED) {
-      gCUR.led.network = 1;
-    } else {
-      gCUR.led.network = 0;
-      connectWiFi();
-    }
+  // 3) WiFi connection manager (non-blocking: events + backoff)
+  PROF_BEGIN(wifi_start);
+  gWiFi.loop();
+  PROF_END(PROF_WIFI, wifi_start);
+  if (net_ready && !gBoot.isReady(BOOT_EVT_OTA) && gWiFi.isConnected()) {
+    // 부팅 시 WiFi가 없었던 경우: 첫 연결 시 OTA 시작
+    setupOTA();
+    gBoot.mark(BOOT_STAGE_OTA);
   }
 
   // 4) SmartConfig (triggered elsewhere via flag)
@@ -406,6 +487,10 @@ void loop() {
     Serial.println("KEY_PWR Long Press - Starting SmartConfig");
     startSmartConfig();
   }
+  if (smartconfig_stop_request) {
+    smartconfig_stop_request = false;
+    stopSmartConfig();
+  }
   processSmartConfig();
   checkSmartConfigDone();
 
@@ -417,42 +502,58 @@ void loop() {
     }
   }
 
-  // 6) Periodic flags (1s / 1min) handled quickly
+  // 6) Periodic flags (1s / 1min) handled quickly - remote command batches apply at the 1s tick
   if (flag_1sec) {
     portENTER_CRITICAL(&timerMux);
     flag_1sec = false;
     portEXIT_CRITICAL(&timerMux);
+    PROF_TICK_HANDLED();  // 인터럽트 → 제어 틱 지연
+    PROF_BEGIN(ctrl_start);
+    gMQTTClient.processCommands();  // 원격 설정 배치는 제어 틱 직전에 한 번에 적용
     gData.onSecondElapsed();
+    gAlarm.evaluate();   // 알람 디바운스 + 에지 발생 시 publishEvent
+    gUpdateAPI.tick();   // 공정 START/DATA/FINISH 업로드 작업 생성 (전송은 APIUploadTask)
+    gData.saveToRtc();  // 웜 리스타트용 제어 상태 갱신
+    PROF_END(PROF_CONTROL_TICK, ctrl_start);
   }
   if (flag_1min) {
     portENTER_CRITICAL(&timerMux);
     flag_1min = false;
     portEXIT_CRITICAL(&timerMux);
     gData.onMinuteElapsed();
+    gData.saveToRtc();
   }
 
   // 7) Fast ADC filter update (keep short)
   gCUR.avr_NTC1 = gData.get_m0_filter(analogReadMilliVolts(PIN_NTC1));
 
   // 8) Update network LED based on current WiFi status
-  gCUR.led.network = (WiFi.status() == WL_CONNECTED) ? 1 : 0;
-
-  // 9) MQTT background processing
-  gMQTTClient.loop();
+  gCUR.led.network = gWiFi.isConnected() ? 1 : 0;
 
-  // 10) Periodic API/MQTT publish (non-blocking)
+  // 9) Telemetry publish policy: state change / deadband / max interval (non-blocking)
 #if ENABLE_API_UPLOAD
-  static unsigned long lastPublishTime = 0;
+  static unsigned long lastPolicyCheck = 0;
   unsigned long currentTime = millis();
-  if (currentTime - lastPublishTime >= API_UPLOAD_INTERVAL_MS) {
-    lastPublishTime = currentTime;
-    float tempC = gData.readNTCtempC();
-    if (!isnan(tempC)) {
-      gMQTTClient.publishData();
-    }
+  if (currentTime - lastPolicyCheck >= PUBLISH_CHECK_INTERVAL_MS) {
+    lastPolicyCheck = currentTime;
+    PROF_BEGIN(pub_start);
+    gMQTTClient.publishIfDue();
+    PROF_END(PROF_PUBLISH, pub_start);
   }
 #endif
 
-  // 11) Keep loop fast — minimal delay
+  // 10) Serial diagnostics request ("diag" → stack/heap report)
+  gDiag.pollSerial();
+  PROF_END(PROF_LOOP, loop_start);
+
+  // 11) Deferred remote restart - outside the control tick, after this loop's work is done
+  if (restart_request) {
+    gData.saveToRtc();  // 재시작 후 제어 상태 즉시 복원
+    Serial.println("Remote restart");
+    Serial.flush();
+    ESP.restart();
+  }
+
+  // 12) Keep loop fast — minimal delay
   delay(1);
 }
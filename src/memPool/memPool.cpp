@@ -0,0 +1,220 @@
+// memPool.cpp - 고정 블록 풀, PSRAM 배치 정책, mbedTLS 할당 훅
+
+#include "memPool.h"
+#include "esp_heap_caps.h"
+#include "mbedtls/platform.h"
+
+MemManager gMem;
+
+// 풀 밖 mbedTLS 할당 앞에 붙는 크기 헤더 (8바이트 - 반환 포인터 정렬 유지)
+// heap_caps_get_allocated_size()는 IDF 4.4(Arduino 2.x)에 없으므로 계상 크기를 직접 기록
+#define TLS_HDR_MAGIC 0x544C5321UL  // "TLS!"
+typedef struct {
+  uint32_t magic;
+  uint32_t size;
+} TLS_HDR;
+
+static uint32_t capsFor(MEM_PLACE place) {
+  return (place == MEM_BULK) ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+// ========== MemPool ==========
+bool MemPool::begin(const char* name, size_t blockSize, uint16_t count, MEM_PLACE place) {
+  if (_slab) return true;
+  if (count == 0 || count > 32) return false;
+
+  _name = name;
+  _blockSize = (blockSize + 3) & ~(size_t)3;  // 4바이트 정렬
+  _slab = (uint8_t*)heap_caps_malloc(_blockSize * count, capsFor(place));
+  _psram = (_slab != nullptr && place == MEM_BULK);
+  if (_slab == nullptr) {
+    Serial.printf("[Mem] Pool %s: %u x %u bytes allocation failed\n", name, count, (unsigned)_blockSize);
+    return false;
+  }
+  _count = count;
+  _freeMask = (count == 32) ? 0xFFFFFFFFUL : ((1UL << count) - 1);
+  Serial.printf("[Mem] Pool %s: %u x %u bytes (%s)\n", name, count, (unsigned)_blockSize,
+                _psram ? "PSRAM" : "internal");
+  return true;
+}
+
+void* MemPool::alloc() {
+  void* p = nullptr;
+  portENTER_CRITICAL(&_mux);
+  if (_freeMask) {
+    int idx = __builtin_ctz(_freeMask);
+    _freeMask &= ~(1UL << idx);
+    _used++;
+    if (_used > _peak) _peak = _used;
+    p = _slab + (size_t)idx * _blockSize;
+  } else {
+    _misses++;
+  }
+  portEXIT_CRITICAL(&_mux);
+  return p;
+}
+
+bool MemPool::owns(const void* p) const {
+  return _slab && (const uint8_t*)p >= _slab && (const uint8_t*)p < _slab + _blockSize * _count;
+}
+
+bool MemPool::release(void* p) {
+  if (!owns(p)) return false;
+  uint32_t idx = ((uint8_t*)p - _slab) / _blockSize;
+  portENTER_CRITICAL(&_mux);
+  if (!(_freeMask & (1UL << idx))) {
+    _freeMask |= (1UL << idx);
+    _used--;
+  }
+  portEXIT_CRITICAL(&_mux);
+  return true;
+}
+
+// ========== MemManager ==========
+void MemManager::begin() {
+#if MEM_PLACEMENT
+  // TLS 레코드 버퍼 풀 (재연결마다 16KB x 2를 힙에서 잡았다 놓지 않도록)
+  // PSRAM이 없으면 생략: 내부 RAM에 상시 잡아두면 오히려 가용 힙이 줄어듦
+  if (heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) >=
+      (size_t)MEM_TLS_POOL_BLOCK_SIZE * MEM_TLS_POOL_BLOCKS) {
+    _tlsPool.begin("tls", MEM_TLS_POOL_BLOCK_SIZE, MEM_TLS_POOL_BLOCKS, MEM_BULK);
+  } else {
+    Serial.println("[Mem] No PSRAM - TLS record pool skipped (heap allocation)");
+  }
+
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+  // 인증서 파싱/핸드셰이크 이전에 설치해야 모든 mbedTLS 할당이 정책을 따름
+  _hooked = (mbedtls_platform_set_calloc_free(tlsCalloc, tlsFree) == 0);
+#endif
+  Serial.printf("[Mem] mbedTLS allocator hook %s\n", _hooked ? "installed" : "unavailable");
+#endif
+  sample();
+}
+
+void* MemManager::alloc(size_t size, MEM_PLACE place) {
+  void* p = heap_caps_malloc(size, capsFor(place));
+  if (p == nullptr && place == MEM_BULK) {
+    p = heap_caps_malloc(size, capsFor(MEM_FAST));  // PSRAM 없음/부족 → 내부 RAM
+  }
+  if (p == nullptr) {
+    portENTER_CRITICAL(&_mux);
+    _failures++;
+    portEXIT_CRITICAL(&_mux);
+  }
+  return p;
+}
+
+void* MemManager::calloc(size_t n, size_t size, MEM_PLACE place) {
+  if (size != 0 && n > SIZE_MAX / size) return nullptr;
+  void* p = alloc(n * size, place);
+  if (p) memset(p, 0, n * size);
+  return p;
+}
+
+void MemManager::free(void* p) {
+  if (p == nullptr) return;
+  if (_tlsPool.release(p)) return;
+  heap_caps_free(p);
+}
+
+// mbedTLS 할당: 레코드 버퍼급은 풀, MEM_TLS_PSRAM_MIN 이상은 PSRAM, 작은 것(bignum 등)은 내부 RAM
+void* MemManager::tlsCalloc(size_t n, size_t size) {
+  if (size != 0 && n > SIZE_MAX / size) return nullptr;
+  size_t total = n * size;
+  if (total == 0) return nullptr;
+
+  void* p = nullptr;
+  size_t charged = total;
+  if (total >= MEM_TLS_POOL_MIN && total <= gMem._tlsPool.blockSize()) {
+    p = gMem._tlsPool.alloc();
+    if (p) {
+      memset(p, 0, total);
+      charged = gMem._tlsPool.blockSize();
+    }
+  }
+  bool psram = false;
+  if (p == nullptr) {
+    if (total > SIZE_MAX - sizeof(TLS_HDR)) return nullptr;
+    MEM_PLACE place = (total >= MEM_TLS_PSRAM_MIN) ? MEM_BULK : MEM_FAST;
+    TLS_HDR* h = (TLS_HDR*)heap_caps_calloc(1, sizeof(TLS_HDR) + total, capsFor(place));
+    psram = (h != nullptr && place == MEM_BULK);
+    if (h == nullptr && place == MEM_BULK) h = (TLS_HDR*)heap_caps_calloc(1, sizeof(TLS_HDR) + total, capsFor(MEM_FAST));
+    if (h) {
+      h->magic = TLS_HDR_MAGIC;
+      h->size = (uint32_t)total;
+      p = h + 1;
+    }
+  }
+
+  portENTER_CRITICAL(&gMem._mux);
+  if (p) {
+    gMem._tlsLive += charged;
+    if (gMem._tlsLive > gMem._tlsPeak) gMem._tlsPeak = gMem._tlsLive;
+    if (psram) gMem._tlsPsram++;
+  } else {
+    gMem._failures++;
+  }
+  portEXIT_CRITICAL(&gMem._mux);
+  return p;
+}
+
+// 훅은 gMem.begin()에서 TLS 사용 전에 설치되므로 풀 밖 블록은 모두 tlsCalloc이 헤더를 붙인 것
+void MemManager::tlsFree(void* p) {
+  if (p == nullptr) return;
+  size_t charged;
+  if (gMem._tlsPool.owns(p)) {
+    charged = gMem._tlsPool.blockSize();
+    gMem._tlsPool.release(p);
+  } else {
+    TLS_HDR* h = (TLS_HDR*)p - 1;
+    configASSERT(h->magic == TLS_HDR_MAGIC);   // 훅 밖에서 잡힌 블록/손상된 헤더 - 즉시 중단 (지연 로그는 출력 전에 멈춤)
+    charged = h->size;
+    heap_caps_free(h);
+  }
+  portENTER_CRITICAL(&gMem._mux);
+  gMem._tlsLive -= charged;
+  portEXIT_CRITICAL(&gMem._mux);
+}
+
+// ========== 지표 ==========
+void MemManager::sample() {
+  _stats.internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  _stats.internal_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  _stats.internal_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  _stats.internal_frag_pct = _stats.internal_free
+      ? (uint8_t)(100 - (uint64_t)_stats.internal_largest * 100 / _stats.internal_free) : 0;
+  _stats.psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+  _stats.psram_largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+
+  portENTER_CRITICAL(&_mux);
+  _stats.tls_live = _tlsLive;
+  _stats.tls_peak = _tlsPeak;
+  _stats.tls_psram = _tlsPsram;
+  _stats.alloc_failures = _failures;
+  portEXIT_CRITICAL(&_mux);
+  _stats.tls_pool_used = _tlsPool.used();
+  _stats.tls_pool_peak = _tlsPool.peak();
+  _stats.tls_pool_misses = _tlsPool.misses();
+
+  if (_stats.internal_largest < MEM_LOW_BLOCK_WARN) {
+    Serial.printf("[Mem] Warning: largest internal block %lu bytes (free %lu)\n",
+                  (unsigned long)_stats.internal_largest, (unsigned long)_stats.internal_free);
+  }
+}
+
+const MEM_STATS& MemManager::stats() {
+  sample();
+  return _stats;
+}
+
+void MemManager::printStats() {
+  const MEM_STATS& st = stats();
+  Serial.printf("[Mem] Internal: free %lu, min %lu, largest %lu (frag %u%%) | PSRAM: free %lu, largest %lu\n",
+                (unsigned long)st.internal_free, (unsigned long)st.internal_min_free,
+                (unsigned long)st.internal_largest, st.internal_frag_pct,
+                (unsigned long)st.psram_free, (unsigned long)st.psram_largest);
+  Serial.printf("[Mem] TLS: live %lu, peak %lu, pool %u/%u (peak %u, miss %lu), psram allocs %lu, failures %lu\n",
+                (unsigned long)st.tls_live, (unsigned long)st.tls_peak,
+                st.tls_pool_used, _tlsPool.count(), st.tls_pool_peak, (unsigned long)st.tls_pool_misses,
+                (unsigned long)st.tls_psram, (unsigned long)st.alloc_failures);
+}
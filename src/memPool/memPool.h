@@ -0,0 +1,90 @@
+// memPool.h - 메모리 배치 정책 (고정 블록 풀 + PSRAM 배치) 및 힙 단편화 지표
+//
+// 네트워크 경로의 큰 버퍼가 재연결마다 내부 힙에 할당/해제되면서 수 일 운영 후
+// 가장 큰 연속 블록이 줄어든다 (단편화). 이를 막기 위해:
+//  - TLS 레코드 버퍼(약 16KB x 2)는 부팅 시 PSRAM에 잡아둔 고정 풀에서 재사용
+//    (PSRAM이 없으면 풀을 만들지 않음 - 내부 RAM 34KB를 상시 점유하지 않도록)
+//  - 크고 오래 사는 버퍼는 PSRAM에 배치 (MEM_BULK), 작고 자주 쓰는 것은 내부 RAM (MEM_FAST)
+//  - mbedTLS calloc/free를 가로채 위 정책을 적용
+//  - 내부 힙 최소 여유/최대 연속 블록을 주기적으로 기록해 진단에 노출
+
+#pragma once
+
+#include <Arduino.h>
+#include "../config.h"
+
+// 배치 정책
+typedef enum {
+  MEM_FAST = 0,   // 내부 RAM (DMA/ISR/짧게 쓰는 버퍼)
+  MEM_BULK,       // PSRAM 우선, 없으면 내부 RAM (크고 오래 사는 버퍼)
+} MEM_PLACE;
+
+// 고정 블록 풀 - 슬랩 하나를 블록 단위로 재사용 (실행 중 힙 할당 없음)
+class MemPool {
+public:
+  bool begin(const char* name, size_t blockSize, uint16_t count, MEM_PLACE place);  // place에 못 두면 실패
+  void* alloc();                    // 비면 nullptr (호출자가 힙으로 대체)
+  bool release(void* p);            // 풀 블록이 아니면 false
+  bool owns(const void* p) const;
+  size_t blockSize() const { return _blockSize; }
+  uint16_t count() const { return _count; }
+  uint16_t used() const { return _used; }
+  uint16_t peak() const { return _peak; }
+  uint32_t misses() const { return _misses; }
+  bool psram() const { return _psram; }
+
+private:
+  const char* _name = "";
+  uint8_t* _slab = nullptr;
+  size_t _blockSize = 0;
+  uint16_t _count = 0;
+  uint16_t _used = 0;
+  uint16_t _peak = 0;
+  uint32_t _misses = 0;             // 풀이 비어 힙으로 넘어간 횟수
+  uint32_t _freeMask = 0;           // 빈 블록 비트 (최대 32블록)
+  bool _psram = false;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+// 메모리 지표 (진단용)
+typedef struct {
+  uint32_t internal_free;           // 내부 힙 여유
+  uint32_t internal_min_free;       // 부팅 이후 최소 여유 (low-water mark)
+  uint32_t internal_largest;        // 최대 연속 블록
+  uint8_t  internal_frag_pct;       // 단편화 = 100 - largest*100/free
+  uint32_t psram_free;              // PSRAM 여유 (없으면 0)
+  uint32_t psram_largest;
+  uint32_t tls_live;                // mbedTLS 현재 사용량 (바이트)
+  uint32_t tls_peak;                // mbedTLS 최대 사용량
+  uint32_t tls_psram;               // PSRAM에 놓인 mbedTLS 할당 수 (누적)
+  uint16_t tls_pool_used;           // TLS 레코드 풀 사용 중 블록
+  uint16_t tls_pool_peak;
+  uint32_t tls_pool_misses;
+  uint32_t alloc_failures;          // 정책 할당 실패 수
+} MEM_STATS;
+
+class MemManager {
+public:
+  void begin();                                   // setup() 맨 처음 (TLS 사용 전)
+  void* alloc(size_t size, MEM_PLACE place);      // 정책 할당 (실패 시 nullptr)
+  void* calloc(size_t n, size_t size, MEM_PLACE place);
+  void free(void* p);
+  void sample();                                  // 지표 갱신 (단편화 추세 기록)
+  const MEM_STATS& stats();
+  void printStats();
+
+private:
+  static void* tlsCalloc(size_t n, size_t size);  // mbedTLS 훅
+  static void tlsFree(void* p);
+
+  MemPool _tlsPool;
+  MEM_STATS _stats = {};
+  uint32_t _tlsLive = 0;
+  uint32_t _tlsPeak = 0;
+  uint32_t _tlsPsram = 0;
+  uint32_t _failures = 0;
+  bool _hooked = false;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern MemManager gMem;
@@ -5,6 +5,12 @@
 #include "../typedef.h"
 #include "../dataClass/dataClass.h"
 #include "../TM1638Display/TM1638Display.h"
+#include "../bootSeq/bootSeq.h"
+#include "../telemetryStore/telemetryStore.h"
+#include "../memPool/memPool.h"
+#include "../diag/diag.h"
+#include "../profiler/profiler.h"
+#include "../binLog/binLog.h"
 
 MQTTClient gMQTTClient;
 
@@ -12,144 +18,27 @@ extern CURRENT_DATA gCUR;
 extern dataClass gData;
 extern TM1638Display gDisplay;
 
-// 문자열 파싱 헬퍼 함수
-void parseCommand(const char* cmd, const char* data) {
-  int iData = atoi(data);
-  
-  if (strcmp(cmd, "PWR") == 0) {
-    // 전원 ON/OFF - 소프트 오프 플래그 설정
-    Serial.printf("[MQTT] Power command: %d\n", iData);
-    if (iData == 0) {
-      gCUR.flg.soft_off = 1;  // 전원 OFF
-    } else {
-      gCUR.flg.soft_off = 0;  // 전원 ON
-    }
-  }
-  else if (strcmp(cmd, "TMP") == 0) {
-    // 설정 온도 //서버에서 보내는값 x10이 되어 건조기에서는  온도값으로 사용 (예 6.5도 -> 65)
-    Serial.printf("[MQTT] Temperature set: %d\n", iData);
-    if (iData >= 0 && iData <= 999) {
-      //Serial.printf("[MQTT] Before: gCUR.seljung_temp = %d\n", gCUR.seljung_temp);
-      gDisplay.beep();  
-      gCUR.seljung_temp = iData/10.0f;
-      //Serial.printf("[MQTT] After: gCUR.seljung_temp = %d\n", gCUR.seljung_temp);
-      gData.saveToFlash();  // Flash에 저장
-      Serial.println("[MQTT] Settings saved to flash");
-    }
-  }
-  else if (strcmp(cmd, "JSP") == 0) {
-    // 제상 주기 (분)를 건조기에서는 시간설정으로
-    Serial.printf("[MQTT] Timer set: %d min\n", iData);
-    if (iData >= 0 && iData <= 1440) {  // 0~24시간
-      gDisplay.beep();  
-      gCUR.remaining_minute = iData;
-      gData.saveToFlash();  // Flash에 저장
-      Serial.println("[MQTT] Settings saved to flash");
-    }
-  }
-  else if (strcmp(cmd, "JSD") == 0) {
-    // 제상 시간 (분)
-    Serial.printf("[MQTT] Defrost duration: %d min\n", iData);
-    if (iData >= 0 && iData <= 60) {
-      // 제상 시간 설정 로직 추가 필요
-    }
-  }
-  else if (strcmp(cmd, "JSF") == 0) {
-    // 강제 제상
-    Serial.printf("[MQTT] Force defrost: %d\n", iData);
-    // 강제 제상 로직 추가 필요
-  }
-  else if (strcmp(cmd, "RES") == 0) {
-    // 시스템 리셋
-    if (iData) {
-      Serial.println("[MQTT] System reset requested");
-      delay(100);
-      ESP.restart();
-    }
-  }
-  else if (strcmp(cmd, "CGI") == 0) {
-    // CGI@ 명령: "110124|espDRY" 형식에서 ID 추출하여 FND 표시
-    // data는 문자열 전체 ("110124|espDRY")
-    char id[16];
-    int i = 0;
-    // | 앞부분의 문자만 추출
-    while (data[i] && data[i] != '|' && i < 15) {
-      id[i] = data[i];
-      i++;
-    }
-    id[i] = '\0';
-    
-    if (i > 0) {
-      // gCUR에 ID 저장 및 FND 상태 변경
-      strncpy(gCUR.mqtt_recv_id, id, sizeof(gCUR.mqtt_recv_id) - 1);
-      gCUR.mqtt_recv_id[sizeof(gCUR.mqtt_recv_id) - 1] = '\0';
-      gCUR.mqtt_recv_time = millis();
-      gCUR.fnd_state = FND_MQTT_RECV_ID;
-      Serial.printf("[MQTT] CGI@ received: %s\n", id);
-    }
-  }
-  else {
-    Serial.printf("[MQTT] Unknown command: %s = %s\n", cmd, data);
-  }
-}
-
-// MQTT 메시지 수신 콜백
-void mqttCallback(char* topic, byte* payload, unsigned int length) {
-  Serial.printf("[MQTT] Message arrived [%s]: ", topic);
-  
-  // payload를 null-terminated 문자열로 변환
-  char message[256];
-  if (length >= sizeof(message)) {
-    length = sizeof(message) - 1;
+// MQTT 메시지 수신 콜백 (MQTT Task 컨텍스트 - 제자리 파싱 후 배치로 전달만 함)
+void MQTTClient::onMessage(char* topic, byte* payload, unsigned int length) {
+  LOGI("[MQTT] Message arrived (%u bytes)\n", length);
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+  Serial.printf("[MQTT] [%s]: %.*s\n", topic, (int)length, (const char*)payload);  // 내용은 수신 버퍼라 즉시 출력
+#endif
+  
+  // JSON 형식: {"PWR@":1, "TMP@":50, ...} - 명령 테이블(mqttCommand)로 타입/범위 검사
+  MQTT_CMD_BATCH batch;
+  MqttParseResult res = mqttParseCommands(payload, length, batch);
+  if (res != MQTT_PARSE_OK) {
+    gMQTTClient._rxRejected++;
+    LOGW("[MQTT] Message rejected (%d, %u bytes)\n", (int)res, length);
+    return;
   }
-  memcpy(message, payload, length);
-  message[length] = '\0';
-  
-  Serial.println(message);
-  
-  // JSON 형식 파싱: {"PWR@":1, "TMP@":50, ...}
-  // 간단한 파싱 (,로 분리하여 처리)
-  char* token = strtok(message, ",");
-  
-  while (token != NULL) {
-    // "CMD@":value 형식 파싱
-    char* cmdStart = strchr(token, '"');
-    if (cmdStart != NULL) {
-      cmdStart++;  // " 다음 문자
-      char* cmdEnd = strchr(cmdStart, '@');
-      if (cmdEnd != NULL) {
-        // 명령어 추출
-        int cmdLen = cmdEnd - cmdStart;
-        char cmd[8];
-        if (cmdLen < sizeof(cmd)) {
-          strncpy(cmd, cmdStart, cmdLen);
-          cmd[cmdLen] = '\0';
-          
-          // 값 추출
-          char* valueStart = strchr(cmdEnd, ':');
-          if (valueStart != NULL) {
-            valueStart++;
-            // 공백과 따옴표 제거
-            while (*valueStart == ' ' || *valueStart == '"') valueStart++;
-            
-            // 값 추출 (문자열 - 따옴표, }, 쉼표 전까지)
-            char value[32];
-            int i = 0;
-            while (valueStart[i] && valueStart[i] != '"' && valueStart[i] != '}' && valueStart[i] != ',' && i < 31) {
-              value[i] = valueStart[i];
-              i++;
-            }
-            value[i] = '\0';
-            
-            if (i > 0) {
-              parseCommand(cmd, value);
-            }
-          }
-        }
-      }
-    }
-    
-    token = strtok(NULL, ",");
+  if (batch.count == 0) return;
+  
+  // 제어 루프가 다음 틱 경계에서 한 번에 적용 (processCommands)
+  if (xQueueSend(gMQTTClient._rxQueue, &batch, 0) != pdTRUE) {
+    gMQTTClient._rxDropped++;
+    LOGW("[MQTT] Command queue full, dropped %u commands\n", batch.count);
   }
 }
 
@@ -158,35 +47,260 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
 #define AWS_IOT_PORT 8883
 #define AWS_IOT_CLIENT_ID "ESP32_Dryer_1008"
 #define AWS_IOT_PUBLISH_TOPIC "skb"  // 송신 토픽
+#define AWS_IOT_BINARY_TOPIC "skb/bin"  // 바이너리 텔레메트리 토픽 (TELEMETRY_BINARY)
+#define AWS_IOT_DIAG_TOPIC "skb/diag"   // 진단 토픽 (스택/힙, idx:3)
+#define AWS_IOT_PROF_TOPIC "skb/prof"   // 프로파일러 토픽 (idx:4, ENABLE_PROFILER)
+#define AWS_IOT_HEALTH_TOPIC "skb/health" // 링크 건강 토픽 (idx:5)
 // 수신 토픽: "Hskb/{CHIP_ID}" - connect()에서 동적 생성
 
 void MQTTClient::begin() {
 #if ENABLE_API_UPLOAD
   Serial.println("[MQTT] Initializing...");
   
-  // TLS 인증서 설정
-  _wifiClient.setCACert(AWS_CERT_CA);
-  _wifiClient.setCertificate(AWS_CERT_CRT);
-  _wifiClient.setPrivateKey(AWS_CERT_PRIVATE);
+  // TLS 인증서 파싱 (한 번만, 재연결 시 재사용)
+  if (!_tlsClient.begin(AWS_CERT_CA, AWS_CERT_CRT, AWS_CERT_PRIVATE)) {
+    Serial.println("[MQTT] TLS credentials invalid");
+  }
   
   // MQTT 클라이언트 설정
-  _mqttClient.setClient(_wifiClient);
+  _mqttClient.setClient(_tlsClient);
   _mqttClient.setServer(AWS_IOT_ENDPOINT, AWS_IOT_PORT);
-  _mqttClient.setCallback(mqttCallback);  // 메시지 수신 콜백 설정
+  _mqttClient.setCallback(onMessage);  // 메시지 수신 콜백 설정
   _mqttClient.setKeepAlive(60);
   _mqttClient.setBufferSize(512);  // 메모리 절약: 512 bytes
   
-  Serial.println("[MQTT] Configuration complete");
+  // QoS1 발행 엔진: PUBLISH는 직접 조립, PUBACK은 TLS 수신 탭으로 추적
+  _publisher.begin(&_mqttClient);
+  _tlsClient.setRxTap(MQTTPublisher::rxTap, &_publisher);
+  
+  // CPU ID (48비트 MAC을 24자리 HEX 문자열로, 부팅 시 한 번만)
+  uint64_t chipid = ESP.getEfuseMac();
+  uint8_t mac[6];
+  for (int i = 0; i < 6; i++) {
+    mac[i] = (chipid >> ((5 - i) * 8)) & 0xFF;
+  }
+  snprintf(_cpuid, sizeof(_cpuid), "%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
+    mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+    mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  
+  // zz 프레임 템플릿 (상수 필드 고정, 발행 시 변하는 필드만 덮어씀)
+  _frame.begin(_cpuid, 2511);
+  
+  // 바이너리 텔레메트리 인코더 (키프레임에 MAC + 펌웨어 버전 포함)
+  _encoder.begin(mac, 2511, TELEMETRY_KEYFRAME_INTERVAL);
+  
+  // 오프라인 보관소 (PSRAM 링 + SPIFFS 스필)
+  gTelemetryStore.begin();
+  
+  // 송신/수신 큐 생성 (가득 차면 생산자는 대기하지 않고 버림)
+  _txQueue = xQueueCreate(MQTT_TX_QUEUE_LEN, sizeof(MQTT_TX_ITEM));
+  _rxQueue = xQueueCreate(MQTT_RX_QUEUE_LEN, sizeof(MQTT_CMD_BATCH));
+  if (_txQueue == nullptr || _rxQueue == nullptr) {
+    Serial.println("[MQTT] Failed to create queues");
+    return;
+  }
   
-  // 초기 연결 시도
-  if (WiFi.status() == WL_CONNECTED) {
-    connect();
+  // MQTT Task 생성 (Core 0 - WiFi 스택과 같은 코어, TLS 핸드셰이크가 제어/UI를 막지 않도록)
+  BaseType_t ret = xTaskCreatePinnedToCore(
+    mqttTask,           // Task 함수
+    "MQTTTask",         // Task 이름
+    MQTT_TASK_STACK,    // Stack 크기 (TLS 핸드셰이크)
+    this,               // Parameter (this 포인터)
+    1,                  // Priority (1 = 낮음)
+    &_taskHandle,       // Task Handle
+    0                   // Core 0
+  );
+  if (ret != pdPASS) {
+    Serial.println("[MQTT] Failed to create task");
+    _taskHandle = nullptr;
+    return;
   }
+  gDiag.registerTask(_taskHandle, "MQTTTask", MQTT_TASK_STACK);
+  
+  // WiFi 링크 변화 시 Task 즉시 깨우기
+  gWiFi.subscribe(onWiFiLink, this);
+  
+  Serial.println("[MQTT] Configuration complete");
 #else
   Serial.println("[MQTT] Disabled (ENABLE_API_UPLOAD=0)");
 #endif
 }
 
+void MQTTClient::onWiFiLink(WIFI_LINK_STATE state, void* arg) {
+  MQTTClient* self = static_cast<MQTTClient*>(arg);
+  if (state != WIFI_LINK_CONNECTING && self->_taskHandle) {
+    xTaskNotifyGive(self->_taskHandle);
+  }
+}
+
+// ========== MQTT Task (연결 유지 + 송신 큐 처리) ==========
+void MQTTClient::mqttTask(void* parameter) {
+#if ENABLE_API_UPLOAD
+  MQTTClient* self = static_cast<MQTTClient*>(parameter);
+  MQTT_TX_ITEM item;
+  
+  Serial.printf("[MQTTTask] Started on Core %d\n", xPortGetCoreID());
+  
+  while (true) {
+    // WiFi 끊김: 송신 큐를 보관소로 옮기고 링크 이벤트 또는 주기 타임아웃까지 대기
+    if (!gWiFi.isConnected()) {
+      self->setConnected(false);
+      self->storeQueued();
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+      continue;
+    }
+    
+    if (!self->_mqttClient.connected()) {
+      self->setConnected(false);
+      self->storeQueued();
+      self->reconnect();  // TLS 핸드셰이크 (이 Task만 차단됨)
+      if (!self->_mqttClient.connected()) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_TASK_PERIOD_MS));
+        continue;
+      }
+    }
+    self->setConnected(true);
+    
+    PROF_BEGIN(mqtt_start);
+    self->_mqttClient.loop();  // MQTT 메시지 처리 (수신 콜백 → 명령 큐, PUBACK → 탭)
+    self->_publisher.service(); // 윈도우 안에서 전송 + PUBACK 타임아웃 재전송
+    PROF_END(PROF_MQTT_LOOP, mqtt_start);
+    
+    // 송신 큐 → 송신함 (최대 MQTT_TASK_PERIOD_MS 대기 → 주기 유지)
+    // 송신함이 가득 차면 (브로커 응답 지연) 보관소로 옮김 - 생산자는 차단되지 않음
+    if (!self->_publisher.hasRoom()) {
+      self->storeQueued();
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_TASK_PERIOD_MS));
+    } else if (xQueueReceive(self->_txQueue, &item, pdMS_TO_TICKS(MQTT_TASK_PERIOD_MS)) == pdTRUE) {
+      // 실시간 항목 우선 - 일시적 실패(송신함 가득 참, 연결 끊김)만 보관소로 넘겨 재발행
+      MQTTDispatchResult res = self->dispatch(item, 0);
+      if (res == MQTT_DISPATCH_RETRY) {
+        gTelemetryStore.push(item);
+      } else if (res == MQTT_DISPATCH_REJECTED) {
+        self->_txDropped++;
+        LOGW("[MQTT] Item type %u rejected, dropped (total %lu)\n", item.type, self->_txDropped);
+      }
+      self->_publisher.service();
+    } else {
+      self->flushStored();       // 송신 큐가 비었을 때만 보관분 발행
+    }
+    
+    if (millis() - self->_lastStatsTime >= MQTT_STATS_INTERVAL_MS) {
+      self->_lastStatsTime = millis();
+      self->printStats();
+    }
+    // 링크 건강: 주기 + 재연결 직후 (재연결 소요 시간 추적)
+    if ((self->_healthDue || millis() - self->_lastHealthTime >= NET_HEALTH_INTERVAL_MS) &&
+        self->_publisher.hasRoom()) {
+      self->_healthDue = false;
+      self->_lastHealthTime = millis();
+      self->sendHealth();
+    }
+#if DIAG_PUBLISH_INTERVAL_MS
+    // 진단은 보관하지 않음 (연결 중일 때만, 송신함 여유가 있을 때)
+    if (millis() - self->_lastDiagTime >= DIAG_PUBLISH_INTERVAL_MS && self->_publisher.hasRoom()) {
+      self->_lastDiagTime = millis();
+      self->sendDiag();
+    }
+#endif
+#if ENABLE_PROFILER
+    // 요약 1개 + 구간별 1개씩, 송신함 여유가 있을 때 한 메시지씩 나눠 발행
+    if (millis() - self->_lastProfTime >= PROFILER_REPORT_INTERVAL_MS) {
+      self->_lastProfTime = millis();
+      self->_profCursor = 0;
+    }
+    if (self->_profCursor <= PROF_SECTION_COUNT && self->_publisher.hasRoom()) {
+      self->sendProfile(self->_profCursor++);
+    }
+#endif
+  }
+#endif
+}
+
+// 실패 원인 구분: 송신함 여유가 있고 연결된 상태에서 제출이 거부되면 항목 자체의 문제 (재시도 무의미)
+MQTTDispatchResult MQTTClient::dispatch(const MQTT_TX_ITEM& item, uint32_t age_s) {
+  if (!_mqttClient.connected() || !_publisher.hasRoom()) return MQTT_DISPATCH_RETRY;
+  bool ok;
+  switch (item.type) {
+    case MQTT_TX_DATA:  ok = sendData(item.sample, age_s); break;
+    case MQTT_TX_EVENT: ok = sendEvent(item.xor_uEvent, item.uEvent, age_s); break;
+    case MQTT_TX_BOOT:  ok = sendBoot(); break;
+    default: return MQTT_DISPATCH_REJECTED;  // 알 수 없는 항목
+  }
+  if (ok) return MQTT_DISPATCH_SENT;
+  return (_mqttClient.connected() && _publisher.hasRoom()) ? MQTT_DISPATCH_REJECTED : MQTT_DISPATCH_RETRY;
+}
+
+// 송신 큐 항목을 보관소로 이동 (오프라인/송신함 포화)
+void MQTTClient::storeQueued() {
+  MQTT_TX_ITEM item;
+  while (xQueueReceive(_txQueue, &item, 0) == pdTRUE) {
+    gTelemetryStore.push(item);
+  }
+}
+
+// 보관 항목 발행: 간격당 TELEMETRY_FLUSH_BURST개, 송신함에 실시간용 여유 1칸 유지
+// 맨 앞 항목이 발행 불가이거나 TELEMETRY_FLUSH_MAX_ATTEMPTS번 연속 실패하면 버림
+// (한 항목이 보관분 전체를 막지 않도록 - 스필 파일에 남아 재부팅 후에도 막히는 경우 포함)
+void MQTTClient::flushStored() {
+  if (gTelemetryStore.depth() == 0) return;
+  if (millis() - _lastFlushTime < TELEMETRY_FLUSH_INTERVAL_MS) return;
+  _lastFlushTime = millis();
+  
+  MQTT_TX_ITEM item;
+  for (int i = 0; i < TELEMETRY_FLUSH_BURST; i++) {
+    if (_publisher.freeSlots() < 2) break;
+    if (!gTelemetryStore.peek(item)) break;
+    uint32_t age_s = item.queued_ms ? (millis() - item.queued_ms) / 1000 : TELEMETRY_AGE_UNKNOWN;
+    MQTTDispatchResult res = dispatch(item, age_s);
+    if (res == MQTT_DISPATCH_SENT) {
+      gTelemetryStore.pop();
+      _flushAttempts = 0;
+      continue;
+    }
+    if (res == MQTT_DISPATCH_REJECTED || ++_flushAttempts >= TELEMETRY_FLUSH_MAX_ATTEMPTS) {
+      LOGW("[MQTT] Stored item type %u undeliverable (%d, %u tries), dropped\n",
+           item.type, (int)res, _flushAttempts);
+      gTelemetryStore.drop();
+      _flushAttempts = 0;
+      continue;
+    }
+    break;                       // 일시적 실패 - 다음 간격에 같은 항목 재시도
+  }
+  _publisher.service();
+  
+  if (gTelemetryStore.depth() == 0) {
+    Serial.println("[MQTT] Stored backlog flushed");
+  }
+}
+
+// 수신 명령 처리 (제어 루프 컨텍스트)
+void MQTTClient::processCommands() {
+#if ENABLE_API_UPLOAD
+  if (_rxQueue == nullptr) return;
+  MQTT_CMD_BATCH batch;
+  while (xQueueReceive(_rxQueue, &batch, 0) == pdTRUE) {
+    mqttApplyBatch(batch);
+  }
+#endif
+}
+
+bool MQTTClient::enqueue(MQTT_TX_ITEM& item) {
+#if ENABLE_API_UPLOAD
+  if (_txQueue == nullptr) return false;
+  item.queued_ms = millis();  // 보관 후 발행 시 age 계산용
+  if (xQueueSend(_txQueue, &item, 0) != pdTRUE) {
+    _txDropped++;
+    LOGW("[MQTT] Tx queue full, dropped (total %lu)\n", _txDropped);
+    return false;
+  }
+  return true;
+#else
+  (void)item;
+  return false;
+#endif
+}
+
 bool MQTTClient::connect() {
   Serial.printf("[MQTT] Connecting to %s:%d...\n", AWS_IOT_ENDPOINT, AWS_IOT_PORT);
   
@@ -198,22 +312,26 @@ bool MQTTClient::connect() {
            (uint16_t)(chipid >> 32), 
            (uint32_t)chipid);
   
+  _publisher.resetRx();
+  _link.attempts++;
+  uint32_t t0 = millis();
   if (_mqttClient.connect(clientId)) {
+    _link.connects++;
+    _link.last_connect_ms = millis() - t0;
+    _healthDue = true;
+    _publisher.onConnected();  // PUBACK 못 받은 메시지 재전송 예약
+    _encoder.reset();          // 새 연결의 첫 바이너리 프레임은 키프레임
+    if (!gBoot.isReady(BOOT_EVT_MQTT)) gBoot.mark(BOOT_STAGE_MQTT);  // 첫 연결만 (부팅 타임라인)
+    const TLS_STATS& tls = _tlsClient.stats();
     Serial.printf("[MQTT] Connected! Client ID: %s\n", clientId);
+    Serial.printf("[MQTT] TLS %s, handshake %lu ms, heap peak %lu, resumed %lu/%lu\n",
+                  tls.last_resumed ? "resumed" : "full",
+                  (unsigned long)tls.last_handshake_ms, (unsigned long)tls.last_heap_peak,
+                  (unsigned long)tls.resumed, (unsigned long)tls.connects);
     
     // 개별 수신 토픽 구독: Hskb/{24자리 CPUID}
-    uint8_t mac[6];
-    for (int i = 0; i < 6; i++) {
-      mac[i] = (chipid >> (i * 8)) & 0xFF;
-    }
-    
-    char cpuid[32];
-    snprintf(cpuid, sizeof(cpuid), "%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
-      mac[5], mac[4], mac[3], mac[2], mac[1], mac[0],
-      mac[5], mac[4], mac[3], mac[2], mac[1], mac[0]);
-    
     char subscribeTopic[64];
-    snprintf(subscribeTopic, sizeof(subscribeTopic), "Hskb/%s", cpuid);
+    snprintf(subscribeTopic, sizeof(subscribeTopic), "Hskb/%s", _cpuid);
     
     if (_mqttClient.subscribe(subscribeTopic)) {
       Serial.printf("[MQTT] Subscribed to: %s\n", subscribeTopic);
@@ -224,7 +342,9 @@ bool MQTTClient::connect() {
     return true;
   } else {
     int state = _mqttClient.state();
-    Serial.printf("[MQTT] Connection failed, rc=%d\n", state);
+    _link.failures++;
+    _link.last_rc = state;
+    Serial.printf("[MQTT] Connection failed, rc=%d (%lu ms)\n", state, (unsigned long)(millis() - t0));
     return false;
   }
 }
@@ -234,135 +354,133 @@ void MQTTClient::reconnect() {
   unsigned long now = millis();
   
   // 재연결 시도는 5초마다 한 번씩만
-  if (now - _lastReconnectAttempt > 5000) {
+  if (_lastReconnectAttempt == 0 || now - _lastReconnectAttempt > 5000) {
     _lastReconnectAttempt = now;
     
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("[MQTT] Attempting to reconnect...");
-      if (connect()) {
-        _lastReconnectAttempt = 0;  // 연결 성공 시 리셋
-      }
-    } else {
-      Serial.println("[MQTT] WiFi not connected, skipping reconnect");
+    Serial.println("[MQTT] Attempting to reconnect...");
+    if (connect()) {
+      _lastReconnectAttempt = 0;  // 연결 성공 시 리셋
     }
   }
 #endif
 }
 
-void MQTTClient::loop() {
-#if ENABLE_API_UPLOAD
-  if (!_mqttClient.connected()) {
-    reconnect();
-  } else {
-    _mqttClient.loop();  // MQTT 메시지 처리
-  }
-#endif
+// 텔레메트리 스냅샷을 송신 큐에 추가 (제어 루프에서 호출, 차단 없음)
+// gCUR 스냅샷 (제어 루프 컨텍스트)
+void MQTTClient::snapshot(TELEMETRY_SAMPLE& sample) {
+  memset(&sample, 0, sizeof(sample));
+  sample.uptime_ms = millis();
+  sample.fan_current = gCUR.fan_current;
+  sample.remaining_minute = gCUR.remaining_minute;
+  sample.ntc_temp_x10 = (int16_t)(gCUR.measure_ntc_temp * 10);
+  sample.sht30_temp_x10 = (int16_t)(gCUR.sht30_temp * 10);
+  sample.humidity_x10 = (int16_t)(gCUR.sht30_humidity * 10);
+  sample.seljung_temp_x10 = (int16_t)(gCUR.seljung_temp * 10);
+  sample.relay_state = gCUR.relay_state.u8;
+  sample.dry_state = (uint8_t)gCUR.dry_state;
+  sample.error_info = gCUR.error_info.data;
 }
 
 bool MQTTClient::publishData() {
+  MQTT_TX_ITEM item;
+  memset(&item, 0, sizeof(item));
+  item.type = MQTT_TX_DATA;
+  snapshot(item.sample);
+  if (!enqueue(item)) return false;  // 큐 없음(begin 전)/가득 참 - 정책 기준은 그대로 두고 다음 평가에서 재시도
+  _policy.markPublished(item.sample, item.sample.uptime_ms);
+  return true;
+}
+
+// 발행 정책 평가 후 필요할 때만 큐에 추가 (loop()에서 PUBLISH_CHECK_INTERVAL_MS마다 호출)
+bool MQTTClient::publishIfDue() {
 #if ENABLE_API_UPLOAD
-  if (!_mqttClient.connected()) {
-    Serial.println("[MQTT] Not connected, cannot publish");
-    return false;
-  }
+  if (isnan(gCUR.measure_ntc_temp)) return false;  // 센서 값이 유효할 때만
   
-  // CPU ID 가져오기 (48비트 MAC을 24자리 HEX 문자열로)
-  uint64_t chipid = ESP.getEfuseMac();
-  uint8_t mac[6];
-  for (int i = 0; i < 6; i++) {
-    mac[i] = (chipid >> (i * 8)) & 0xFF;
-  }
+  MQTT_TX_ITEM item;
+  memset(&item, 0, sizeof(item));
+  item.type = MQTT_TX_DATA;
+  snapshot(item.sample);
   
-  char cpuid[32];
-  snprintf(cpuid, sizeof(cpuid), "%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
-    mac[5], mac[4], mac[3], mac[2], mac[1], mac[0],
-    mac[5], mac[4], mac[3], mac[2], mac[1], mac[0]);
-  
-  // zz 필드 생성 (파이프 구분)
-  // 형식: 전화번호|IMEI|CPUID|IDX|압축기전류|히터전류|팬전류|버전|재상모드|O3모드|재상주기|재상시간|오존주기|오존발생시간|릴레이상태|오존측정|제어온도|T1온도|T2온도|습도|CO2|설정온도|오존기준|습도상태|시스템상태
-  char zz[256];
-  uint16_t revision = 10;  // 펌웨어 버전 1.0
-  uint16_t sys_state = 0x0000;  // 시스템 상태
-  //inx=0x01;
-  snprintf(zz, sizeof(zz),
-    "01252769611|770186056655075|%s|01|%04X|%04X|%04X|%04X|00|00|%04X|0000|001E|0032|%02X|0000|%04X|%04X|0000|%04X|0000|%04X|03E8|0000|%04X|",
-    cpuid,                              // CPUID
-    0x0000,                             // 압축기 전류
-    0x0000,                             // 히터 전류  
-    gCUR.fan_current,                   // 팬 전류
-    2511,                               // 펌웨어 버전
-                                        // 재상 모드 00
-                                        // O3 모드 00
-    gCUR.remaining_minute,              // 남은 시간
-                                        // 재상 시간 0000
-                                        // 오존 주기 001E (30)
-                                        // 오존 발생시간 0032 (50)
-    gCUR.relay_state.u8,                // 릴레이 상태 (RY1~RY8)
-                                        // 오존 측정값 0000
-    (int)(gCUR.measure_ntc_temp * 10),  // 제어 온도 (NTC, x10)
-    (int)(gCUR.sht30_temp * 10),        // T1 온도 (SHT30, x10)
-                                        // T2 온도 0000
-    (int)(gCUR.sht30_humidity * 10),    // 습도 (SHT30, x10)
-                                        // CO2 0000
-    (int)(gCUR.seljung_temp*10),        // 설정 온도
-                                        // 오존 기준 03E8 (1000)
-                                        // 습도 상태 0000
-    sys_state                           // 시스템 상태
-  );
+  PublishReason reason = _policy.evaluate(item.sample, item.sample.uptime_ms);
+  if (reason == PUBLISH_NONE) return false;
   
-  // 체크섬 계산
-  uint8_t sum = 0;
-  for (int i = 0; zz[i] != '\0'; i++) {
-    sum += zz[i];
+  if (!enqueue(item)) return false;  // 큐에 들어간 것만 발행으로 기록
+  _policy.markPublished(item.sample, item.sample.uptime_ms);
+  LOGI("[MQTT] Publish (%s)\n", PublishPolicy::reasonName(reason));
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool MQTTClient::publishEvent(uint16_t xor_uEvent, uint16_t uEvent) {
+  MQTT_TX_ITEM item;
+  memset(&item, 0, sizeof(item));
+  item.type = MQTT_TX_EVENT;
+  item.xor_uEvent = xor_uEvent;
+  item.uEvent = uEvent;
+  return enqueue(item);
+}
+
+bool MQTTClient::publishBoot() {
+  MQTT_TX_ITEM item;
+  memset(&item, 0, sizeof(item));
+  item.type = MQTT_TX_BOOT;
+  return enqueue(item);
+}
+
+bool MQTTClient::sendData(const TELEMETRY_SAMPLE& sample, uint32_t age_s) {
+#if ENABLE_API_UPLOAD
+#if TELEMETRY_BINARY
+  // 바이너리 프레임 (버전 + 비트맵 + 변경 필드 + CRC16) - 시각은 프레임의 업타임 필드로 전달
+  (void)age_s;
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  size_t len = _encoder.encode(sample, frame, sizeof(frame));
+  if (len == 0) return false;
+  bool ok = _publisher.submit(AWS_IOT_BINARY_TOPIC, frame, len, MQTT_QOS_DATA);
+  if (ok) {
+    _encoder.commit();       // 전송된 프레임만 델타 기준이 됨
+    _lastPublishTime = millis();
   }
+  return ok;
+#else
+  // zz 프레임: 템플릿의 고정 위치 필드만 덮어쓰고 체크섬 증분 갱신
+  // 보관분은 age(초) 키 추가 (-1: 이전 부팅에서 보관)
+  const char* payload;
+  size_t len;
+  char aged[TELEMETRY_FRAME_LEN + 32];
+  if (age_s > 0) {
+    len = _frame.buildAged(sample, (age_s == TELEMETRY_AGE_UNKNOWN) ? -1L : (long)age_s,
+                           aged, sizeof(aged));
+    payload = aged;
+  } else {
+    payload = _frame.build(sample, len);
+  }
+  if (len == 0) return false;
   
-  // JSON 페이로드 생성 (idx:0, zz)
-  char payload[384];
-  snprintf(payload, sizeof(payload),
-    "{\"idx\":0,\"zz\":\"%s%02X\"}",
-    zz, sum);
-  
-  Serial.printf("[MQTT] Publishing to %s: %s\n", AWS_IOT_PUBLISH_TOPIC, payload);
-  
-  bool success = _mqttClient.publish(AWS_IOT_PUBLISH_TOPIC, payload);
+  LOGD("[MQTT] Publishing to %s (%u bytes)\n", AWS_IOT_PUBLISH_TOPIC, (unsigned)len);
   
+  bool success = _publisher.submit(AWS_IOT_PUBLISH_TOPIC, (const uint8_t*)payload, len, MQTT_QOS_DATA);
   if (success) {
-    Serial.println("[MQTT] Publish successful");
     _lastPublishTime = millis();
-  } else {
-    Serial.println("[MQTT] Publish failed");
   }
   
   return success;
+#endif
 #else
-  Serial.println("[MQTT] Upload disabled");
+  (void)sample;
+  (void)age_s;
   return false;
 #endif
 }
 
-bool MQTTClient::publishEvent(uint16_t xor_uEvent, uint16_t uEvent) {
+bool MQTTClient::sendEvent(uint16_t xor_uEvent, uint16_t uEvent, uint32_t age_s) {
 #if ENABLE_API_UPLOAD
-  if (!_mqttClient.connected()) {
-    Serial.println("[MQTT] Not connected, cannot publish event");
-    return false;
-  }
-  
-  // CPU ID 가져오기 (24자리 HEX)
-  uint64_t chipid = ESP.getEfuseMac();
-  uint8_t mac[6];
-  for (int i = 0; i < 6; i++) {
-    mac[i] = (chipid >> (i * 8)) & 0xFF;
-  }
-  
-  char cpuid[32];
-  snprintf(cpuid, sizeof(cpuid), "%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
-    mac[5], mac[4], mac[3], mac[2], mac[1], mac[0],
-    mac[5], mac[4], mac[3], mac[2], mac[1], mac[0]);
   
   // evt 필드 생성: CPUID|xor_event|event
   // xor_event: 변경된 이벤트 비트, event: 현재 이벤트 상태
   char evt[64];
-  snprintf(evt, sizeof(evt), "%s|%04X|%04X|", cpuid, xor_uEvent, uEvent);
+  snprintf(evt, sizeof(evt), "%s|%04X|%04X|", _cpuid, xor_uEvent, uEvent);
   
   // 체크섬 계산
   uint8_t sum = 0;
@@ -370,32 +488,154 @@ bool MQTTClient::publishEvent(uint16_t xor_uEvent, uint16_t uEvent) {
     sum += evt[i];
   }
   
-  // JSON 페이로드 생성 (idx:1, evt)
+  // JSON 페이로드 생성 (idx:1, evt) - 보관분은 age(초) 추가
   char payload[128];
-  snprintf(payload, sizeof(payload),
-    "{\"idx\":1,\"evt\":\"%s%02X\"}",
-    evt, sum);
-  
-  Serial.printf("[MQTT] Publishing event to %s: %s\n", AWS_IOT_PUBLISH_TOPIC, payload);
+  if (age_s > 0) {
+    snprintf(payload, sizeof(payload),
+      "{\"idx\":1,\"age\":%ld,\"evt\":\"%s%02X\"}",
+      (age_s == TELEMETRY_AGE_UNKNOWN) ? -1L : (long)age_s, evt, sum);
+  } else {
+    snprintf(payload, sizeof(payload),
+      "{\"idx\":1,\"evt\":\"%s%02X\"}",
+      evt, sum);
+  }
   
-  bool success = _mqttClient.publish(AWS_IOT_PUBLISH_TOPIC, payload);
+  LOGD("[MQTT] Publishing event %04X/%04X to %s\n", xor_uEvent, uEvent, AWS_IOT_PUBLISH_TOPIC);
   
-  if (success) {
-    Serial.println("[MQTT] Event publish successful");
+  return _publisher.submit(AWS_IOT_PUBLISH_TOPIC, payload, MQTT_QOS_EVENT);
+#else
+  (void)xor_uEvent;
+  (void)uEvent;
+  (void)age_s;
+  return false;
+#endif
+}
+
+// 연결 상태 변화 시 미연결 시간 누적 (MQTT Task 전용)
+void MQTTClient::setConnected(bool connected) {
+  if (connected == _connected) return;
+  if (connected) {
+    _link.down_ms += millis() - _downSince;
   } else {
-    Serial.println("[MQTT] Event publish failed");
+    _downSince = millis();
   }
+  _connected = connected;
+}
+
+void MQTTClient::linkStats(MQTT_LINK_STATS& out) {
+  out = _link;
+  if (!_connected) out.down_ms += millis() - _downSince;
+}
+
+// {"idx":5,"up":초,
+//  "w":[rssi,min,avg,max,ch,연결,시도,끊김,사유,assoc_ms,dhcp_ms,끊김초],
+//  "m":[연결,시도,실패,rc,connect_ms,tls_ms,재개,tls오류,미연결초],
+//  "p":[발행,확인,재전송,버림]}
+bool MQTTClient::sendHealth() {
+#if ENABLE_API_UPLOAD
+  WIFI_LINK_STATS w;
+  gWiFi.linkStats(w, true);  // RSSI 최소/최대/평균은 보고 구간 단위
+  MQTT_LINK_STATS m;
+  linkStats(m);
+  const TLS_STATS& tls = _tlsClient.stats();
+  const MQTT_PUB_STATS& p = _publisher.stats();
   
-  return success;
+  char payload[MQTT_PAYLOAD_MAX];
+  int len = snprintf(payload, sizeof(payload),
+    "{\"idx\":5,\"up\":%lu,"
+    "\"w\":[%d,%d,%d,%d,%u,%lu,%lu,%lu,%u,%lu,%lu,%lu],"
+    "\"m\":[%lu,%lu,%lu,%d,%lu,%lu,%u,%ld,%lu],"
+    "\"p\":[%lu,%lu,%lu,%lu]}",
+    (unsigned long)(millis() / 1000),
+    w.rssi, w.rssi_min, w.rssi_avg, w.rssi_max, w.channel,
+    (unsigned long)w.connects, (unsigned long)w.attempts, (unsigned long)w.disconnects, w.last_reason,
+    (unsigned long)w.assoc_ms, (unsigned long)w.dhcp_ms, (unsigned long)(w.down_ms / 1000),
+    (unsigned long)m.connects, (unsigned long)m.attempts, (unsigned long)m.failures, m.last_rc,
+    (unsigned long)m.last_connect_ms, (unsigned long)tls.last_handshake_ms, tls.last_resumed ? 1 : 0,
+    (long)tls.last_error, (unsigned long)(m.down_ms / 1000),
+    (unsigned long)p.sent, (unsigned long)p.acked, (unsigned long)p.retransmits,
+    (unsigned long)(p.dropped + _txDropped));
+  if (len <= 0 || (size_t)len >= sizeof(payload)) return false;
+  
+  LOGD("[MQTT] Publishing health to %s (%u bytes)\n", AWS_IOT_HEALTH_TOPIC, (unsigned)len);
+  
+  return _publisher.submit(AWS_IOT_HEALTH_TOPIC, (const uint8_t*)payload, len, 0);
 #else
-  Serial.println("[MQTT] Event upload disabled");
   return false;
 #endif
 }
 
+bool MQTTClient::sendDiag() {
+#if ENABLE_API_UPLOAD
+  char payload[MQTT_PAYLOAD_MAX];
+  size_t len = gDiag.format(payload, sizeof(payload));
+  if (len == 0) return false;
+  
+  LOGD("[MQTT] Publishing diag to %s (%u bytes)\n", AWS_IOT_DIAG_TOPIC, (unsigned)len);
+  
+  return _publisher.submit(AWS_IOT_DIAG_TOPIC, (const uint8_t*)payload, len, 0);
+#else
+  return false;
+#endif
+}
+
+#if ENABLE_PROFILER
+// part 0: 요약, 1..PROF_SECTION_COUNT: 구간 히스토그램
+bool MQTTClient::sendProfile(uint8_t part) {
+  char payload[MQTT_PAYLOAD_MAX];
+  size_t len = (part == 0) ? gProf.formatSummary(payload, sizeof(payload))
+                           : gProf.formatSection(part - 1, payload, sizeof(payload));
+  if (len == 0) return false;
+  return _publisher.submit(AWS_IOT_PROF_TOPIC, (const uint8_t*)payload, len, 0);
+}
+#endif
+
+bool MQTTClient::sendBoot() {
+#if ENABLE_API_UPLOAD
+  char timeline[160];
+  gBoot.format(timeline, sizeof(timeline));
+  
+  // boot 필드 생성: REVISION|reset_reason|STAGE:ms|...
+  char boot[192];
+  snprintf(boot, sizeof(boot), "%s|%s", REVISION, timeline);
+  
+  // 체크섬 계산
+  uint8_t sum = 0;
+  for (int i = 0; boot[i] != '\0'; i++) {
+    sum += boot[i];
+  }
+  
+  // JSON 페이로드 생성 (idx:2, boot)
+  char payload[256];
+  snprintf(payload, sizeof(payload),
+    "{\"idx\":2,\"boot\":\"%s%02X\"}",
+    boot, sum);
+  
+  Serial.printf("[MQTT] Publishing boot timeline to %s: %s\n", AWS_IOT_PUBLISH_TOPIC, payload);
+  
+  return _publisher.submit(AWS_IOT_PUBLISH_TOPIC, payload, MQTT_QOS_BOOT);
+#else
+  return false;
+#endif
+}
+
+// 발행 통계 출력 (송신 큐 버림 + 송신함 상태)
+void MQTTClient::printStats() {
+  const MQTT_PUB_STATS& st = _publisher.stats();
+  const TELEMETRY_STORE_STATS& ss = gTelemetryStore.stats();
+  Serial.printf("[MQTT] Pub stats: sent %lu, acked %lu, retx %lu, outbox %u (inflight %u), dropped %lu+%lu\n",
+                (unsigned long)st.sent, (unsigned long)st.acked, (unsigned long)st.retransmits,
+                st.depth, st.inflight,
+                (unsigned long)_txDropped, (unsigned long)st.dropped);
+  Serial.printf("[MQTT] Store: depth %lu/%lu%s, spilled %lu, flushed %lu, dropped %lu\n",
+                (unsigned long)ss.depth, (unsigned long)ss.capacity, ss.psram ? " (PSRAM)" : "",
+                (unsigned long)ss.spilled, (unsigned long)ss.flushed, (unsigned long)ss.dropped);
+  gMem.printStats();
+}
+
 bool MQTTClient::isConnected() {
 #if ENABLE_API_UPLOAD
-  return _mqttClient.connected();
+  return _connected;
 #else
   return false;
 #endif
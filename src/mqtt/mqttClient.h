@@ -4,23 +4,115 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
 #include <PubSubClient.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
 #include "../config.h"
+#include "../typedef.h"
+#include "../wifiManager/wifiManager.h"
+#include "tlsClient.h"
+#include "mqttPublisher.h"
+#include "telemetryCodec.h"
+#include "telemetryFrame.h"
+#include "publishPolicy.h"
+#include "mqttCommand.h"
+
+// 송신 큐 항목 타입
+enum MQTTTxType {
+  MQTT_TX_DATA = 0,     // 텔레메트리 (idx:0, zz)
+  MQTT_TX_EVENT = 1,    // 이벤트 (idx:1, evt)
+  MQTT_TX_BOOT = 2,     // 부팅 타임라인 (idx:2, boot) - gBoot에서 직접 포맷
+};
+
+// 송신 결과 (dispatch)
+enum MQTTDispatchResult {
+  MQTT_DISPATCH_SENT = 0,     // 송신함에 들어감
+  MQTT_DISPATCH_RETRY,        // 일시적 (송신함 가득 참, 연결 끊김) - 보관 후 재시도
+  MQTT_DISPATCH_REJECTED,     // 항목 자체가 발행 불가 (인코딩 실패, 길이 초과, 알 수 없는 타입) - 버림
+};
+
+// 송신 큐 항목 (생산자 → MQTT Task)
+typedef struct {
+  uint8_t type;               // MQTTTxType
+  TELEMETRY_SAMPLE sample;    // MQTT_TX_DATA
+  uint16_t xor_uEvent;        // MQTT_TX_EVENT
+  uint16_t uEvent;
+  uint32_t queued_ms;         // 큐 투입 시각 (보관 후 발행 시 age)
+} MQTT_TX_ITEM;
+
+// MQTT 연결 통계 (건강 메시지)
+typedef struct {
+  uint32_t attempts;          // connect() 시도
+  uint32_t connects;          // 성공
+  uint32_t failures;          // 실패 (TCP/TLS/CONNACK)
+  int8_t last_rc;             // 마지막 실패 시 _mqttClient.state() (MQTT_CONNECTION_TIMEOUT 등)
+  uint32_t last_connect_ms;   // 마지막 성공: TCP + TLS + CONNECT 전체
+  uint32_t down_ms;           // 부팅 이후 누적 미연결 시간 (현재 포함)
+} MQTT_LINK_STATS;
 
 class MQTTClient {
 public:
-  void begin();
-  void loop();
-  bool publishData();
+  void begin();               // 설정 + 큐 생성 + MQTT Task 시작 (차단 없음)
+  void processCommands();     // 수신 명령 배치 적용 (제어 틱 경계에서 호출 - 제어 루프 컨텍스트)
+  bool publishData();         // gCUR 스냅샷을 송신 큐에 추가 (차단 없음)
+  bool publishIfDue();        // 발행 정책(데드밴드/상태 변화/간격)에 따라 publishData
   bool publishEvent(uint16_t xor_uEvent, uint16_t uEvent);
+  bool publishBoot();         // 부팅 타임라인 (bootSeq)
   bool isConnected();
+  const MQTT_PUB_STATS& pubStats() const { return _publisher.stats(); }
+  void linkStats(MQTT_LINK_STATS& out);
+  uint32_t txDropped() const { return _txDropped; }
 
 private:
-  WiFiClientSecure _wifiClient;
+  static void mqttTask(void* parameter);
+  static void onWiFiLink(WIFI_LINK_STATE state, void* arg);
+  static void onMessage(char* topic, byte* payload, unsigned int length);
+  static void snapshot(TELEMETRY_SAMPLE& sample);
+  bool enqueue(MQTT_TX_ITEM& item);
+  MQTTDispatchResult dispatch(const MQTT_TX_ITEM& item, uint32_t age_s);
+  void storeQueued();
+  void flushStored();
+  bool sendData(const TELEMETRY_SAMPLE& sample, uint32_t age_s);
+  bool sendEvent(uint16_t xor_uEvent, uint16_t uEvent, uint32_t age_s);
+  bool sendBoot();
+  bool sendDiag();
+  bool sendHealth();
+  void setConnected(bool connected);
+#if ENABLE_PROFILER
+  bool sendProfile(uint8_t part);
+#endif
+  void printStats();
+
+  TLSClient _tlsClient;       // 인증서 1회 파싱 + 세션 재개
   PubSubClient _mqttClient;
+  MQTTPublisher _publisher;   // 송신함 + QoS1 PUBACK 추적
+  TelemetryFrame _frame;      // zz 프레임 템플릿 (필드 덮어쓰기)
+  TelemetryEncoder _encoder;  // TELEMETRY_BINARY 프레임 (델타 억제)
+  char _cpuid[25] = {0};      // 24자리 CPUID (MAC 두 번)
+  PublishPolicy _policy;      // 제어 루프 측 발행 시점 결정
   unsigned long _lastReconnectAttempt = 0;
   unsigned long _lastPublishTime = 0;
+  unsigned long _lastStatsTime = 0;
+  unsigned long _lastFlushTime = 0;
+  uint8_t _flushAttempts = 0;         // 보관소 맨 앞 항목의 연속 발행 실패 횟수
+  unsigned long _lastDiagTime = 0;
+  unsigned long _lastHealthTime = 0;
+  bool _healthDue = false;            // 재연결 직후 1회 발행
+  MQTT_LINK_STATS _link = {};
+  uint32_t _downSince = 0;
+#if ENABLE_PROFILER
+  unsigned long _lastProfTime = 0;
+  uint8_t _profCursor = 0xFF;         // 발행할 다음 보고 조각 (PROF_SECTION_COUNT 초과 = 없음)
+#endif
+  
+  TaskHandle_t _taskHandle = nullptr;
+  QueueHandle_t _txQueue = nullptr;   // 텔레메트리/이벤트 송신 큐
+  QueueHandle_t _rxQueue = nullptr;   // 수신 명령 배치 큐
+  volatile bool _connected = false;
+  uint32_t _txDropped = 0;            // 송신 큐 가득 참/발행 불가로 버린 항목 수
+  uint32_t _rxDropped = 0;            // 수신 큐 가득 참으로 버린 배치 수
+  uint32_t _rxRejected = 0;           // 길이/범위/개수 초과로 거부한 메시지 수
   
   bool connect();
   void reconnect();
@@ -0,0 +1,135 @@
+// mqttCommand.cpp - MQTT 수신 명령 파서 + 명령 테이블 구현
+
+#include "mqttCommand.h"
+#include <Arduino.h>
+#include "../typedef.h"
+#include "../dataClass/dataClass.h"
+#include "../TM1638Display/TM1638Display.h"
+#include "../binLog/binLog.h"
+
+extern CURRENT_DATA gCUR;
+extern dataClass gData;
+extern TM1638Display gDisplay;
+
+// ========== 명령 핸들러 (제어 루프 컨텍스트) ==========
+static uint8_t applyPower(const MQTT_RX_CMD& c) {
+  // 전원 ON/OFF - 소프트 오프 플래그 설정
+  LOGI("[MQTT] Power command: %ld\n", (long)c.ivalue);
+  gCUR.flg.soft_off = (c.ivalue == 0) ? 1 : 0;
+  return MQTT_EFFECT_NONE;
+}
+
+static uint8_t applyTemperature(const MQTT_RX_CMD& c) {
+  // 설정 온도 //서버에서 보내는값 x10이 되어 건조기에서는  온도값으로 사용 (예 6.5도 -> 65)
+  LOGI("[MQTT] Temperature set: %ld\n", (long)c.ivalue);
+  gCUR.seljung_temp = c.ivalue / 10.0f;
+  return MQTT_EFFECT_BEEP | MQTT_EFFECT_SAVE;
+}
+
+static uint8_t applyTimer(const MQTT_RX_CMD& c) {
+  // 제상 주기 (분)를 건조기에서는 시간설정으로
+  LOGI("[MQTT] Timer set: %ld min\n", (long)c.ivalue);
+  gCUR.remaining_minute = c.ivalue;
+  return MQTT_EFFECT_BEEP | MQTT_EFFECT_SAVE;
+}
+
+static uint8_t applyDefrostDuration(const MQTT_RX_CMD& c) {
+  // 제상 시간 (분) - 제상 시간 설정 로직 추가 필요
+  LOGI("[MQTT] Defrost duration: %ld min\n", (long)c.ivalue);
+  return MQTT_EFFECT_NONE;
+}
+
+static uint8_t applyForceDefrost(const MQTT_RX_CMD& c) {
+  // 강제 제상 - 강제 제상 로직 추가 필요
+  LOGI("[MQTT] Force defrost: %ld\n", (long)c.ivalue);
+  return MQTT_EFFECT_NONE;
+}
+
+static uint8_t applyReset(const MQTT_RX_CMD& c) {
+  // 시스템 리셋 - 같은 배치의 설정을 저장한 뒤 재시작
+  if (c.ivalue) {
+    Serial.println("[MQTT] System reset requested");
+    return MQTT_EFFECT_RESTART;
+  }
+  return MQTT_EFFECT_NONE;
+}
+
+static uint8_t applyCgi(const MQTT_RX_CMD& c) {
+  // CGI@ 명령: "110124|espDRY" 형식에서 | 앞부분 ID 추출하여 FND 표시
+  char id[16];
+  int i = 0;
+  while (c.svalue[i] && c.svalue[i] != '|' && i < 15) {
+    id[i] = c.svalue[i];
+    i++;
+  }
+  id[i] = '\0';
+
+  if (i > 0) {
+    // gCUR에 ID 저장 및 FND 상태 변경
+    strncpy(gCUR.mqtt_recv_id, id, sizeof(gCUR.mqtt_recv_id) - 1);
+    gCUR.mqtt_recv_id[sizeof(gCUR.mqtt_recv_id) - 1] = '\0';
+    gCUR.mqtt_recv_time = millis();
+    gCUR.fnd_state = FND_MQTT_RECV_ID;
+    Serial.printf("[MQTT] CGI@ received: %s\n", gCUR.mqtt_recv_id);  // 변경 가능한 버퍼 - 즉시 출력
+  }
+  return MQTT_EFFECT_NONE;
+}
+
+// ========== 명령 테이블 (컴파일 타임) ==========
+static constexpr MQTT_COMMAND s_commands[] = {
+  { mqttCmdKey("PWR"), "PWR", MQTT_VAL_INT, INT32_MIN, INT32_MAX, applyPower },
+  { mqttCmdKey("TMP"), "TMP", MQTT_VAL_INT, 0,         999,       applyTemperature },
+  { mqttCmdKey("JSP"), "JSP", MQTT_VAL_INT, 0,         1440,      applyTimer },        // 0~24시간
+  { mqttCmdKey("JSD"), "JSD", MQTT_VAL_INT, 0,         60,        applyDefrostDuration },
+  { mqttCmdKey("JSF"), "JSF", MQTT_VAL_INT, INT32_MIN, INT32_MAX, applyForceDefrost },
+  { mqttCmdKey("RES"), "RES", MQTT_VAL_INT, INT32_MIN, INT32_MAX, applyReset },
+  { mqttCmdKey("CGI"), "CGI", MQTT_VAL_STR, 0,         0,         applyCgi },
+};
+
+static constexpr uint8_t NUM_COMMANDS = sizeof(s_commands) / sizeof(s_commands[0]);
+static_assert(NUM_COMMANDS < 255, "command index must fit in uint8_t");
+
+const char* mqttCommandName(uint8_t index) {
+  return index < NUM_COMMANDS ? s_commands[index].name : "?";
+}
+
+// ========== 파서 (본체는 mqttCommandParser.cpp) ==========
+// 진단 출력 - 명령 이름/값은 수신 버퍼라 즉시 서식화 (LOGx는 %s 포인터를 나중에 따라감)
+static void logUnknown(const uint8_t* name, size_t nameLen, const uint8_t* value, size_t valueLen) {
+  Serial.printf("[MQTT] Unknown command: %.*s = %.*s\n",
+                (int)nameLen, (const char*)name, (int)valueLen, (const char*)value);
+}
+
+static void logRange(const char* name, int32_t value) {
+  LOGW("[MQTT] %s out of range: %ld\n", name, (long)value);  // name은 명령 테이블 리터럴
+}
+
+static const MQTT_PARSE_LOG s_parseLog = { logUnknown, logRange };
+
+MqttParseResult mqttParseCommands(const uint8_t* payload, size_t len, MQTT_CMD_BATCH& batch) {
+  return mqttParseWith(s_commands, NUM_COMMANDS, payload, len, batch, &s_parseLog);
+}
+
+// 배치 적용: 모든 필드를 같은 시점에 반영하고 부저/저장/재시작은 끝에서 한 번씩
+// 재시작은 요청만 남기고 loop() 끝에서 수행 (제어 틱 안에서 지연/재시작하지 않음)
+void mqttApplyBatch(const MQTT_CMD_BATCH& batch) {
+  extern bool restart_request;
+  uint8_t effects = MQTT_EFFECT_NONE;
+  for (uint8_t i = 0; i < batch.count && i < MQTT_CMD_BATCH_MAX; i++) {
+    const MQTT_RX_CMD& cmd = batch.cmd[i];
+    if (cmd.index < NUM_COMMANDS) {
+      effects |= s_commands[cmd.index].apply(cmd);
+    }
+  }
+
+  if (effects & MQTT_EFFECT_SAVE) {
+    gData.saveToFlash();  // Flash에 저장 (배치당 한 번)
+    LOGI("[MQTT] Settings saved to flash (%u commands)\n", batch.count);
+  }
+  if (effects & MQTT_EFFECT_BEEP) {
+    gDisplay.beep();
+  }
+  if (effects & MQTT_EFFECT_RESTART) {
+    restart_request = true;
+  }
+}
@@ -0,0 +1,80 @@
+// mqttCommand.h - MQTT 수신 명령 파서 + 명령 테이블
+//
+// 페이로드 형식: {"PWR@":1, "TMP@":50, "CGI@":"110124|espDRY", ...}
+// mqttParseCommands()는 페이로드를 복사하지 않고 한 번 훑으면서 "XXX@":값 쌍을 찾아
+// 컴파일 타임 명령 테이블에서 찾은 뒤 값 타입/범위를 검사해 메시지 단위 배치(MQTT_CMD_BATCH)로 모은다.
+// 배치는 제어 루프가 틱 경계에서 한 번에 적용한다 (mqttApplyBatch: 부저 1회, Flash 저장 1회, 재시작은 loop() 끝으로 미룸).
+// 범위를 벗어난 값이 하나라도 있으면 배치 전체를 거부한다.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MQTT_CMD_PAYLOAD_MAX  256     // 이보다 긴 페이로드는 통째로 거부
+#define MQTT_CMD_VALUE_MAX    31      // 값 문자열 최대 길이
+#define MQTT_CMD_BATCH_MAX    8       // 메시지당 최대 명령 수
+
+enum MqttValueType : uint8_t {
+  MQTT_VAL_INT = 0,                   // 정수 (atoi 규칙)
+  MQTT_VAL_STR,                       // 문자열
+};
+
+// 파싱된 명령
+typedef struct {
+  uint8_t index;                      // 명령 테이블 인덱스
+  int32_t ivalue;                     // MQTT_VAL_INT
+  char svalue[MQTT_CMD_VALUE_MAX + 1];// MQTT_VAL_STR
+} MQTT_RX_CMD;
+
+// 메시지 하나의 명령 묶음 (MQTT Task → 제어 루프 큐 항목)
+typedef struct {
+  uint8_t count;
+  MQTT_RX_CMD cmd[MQTT_CMD_BATCH_MAX];
+} MQTT_CMD_BATCH;
+
+// 핸들러가 돌려주는 후처리 (배치 끝에서 한 번만 수행)
+enum {
+  MQTT_EFFECT_NONE    = 0x00,
+  MQTT_EFFECT_BEEP    = 0x01,         // 부저
+  MQTT_EFFECT_SAVE    = 0x02,         // Flash 저장
+  MQTT_EFFECT_RESTART = 0x04,         // 저장 후 재시작
+};
+
+// 명령 테이블 항목
+typedef struct {
+  uint32_t key;                       // 3글자 명령 이름 (mqttCmdKey)
+  const char* name;
+  MqttValueType type;
+  int32_t min;                        // MQTT_VAL_INT 허용 범위
+  int32_t max;
+  uint8_t (*apply)(const MQTT_RX_CMD& cmd);   // MQTT_EFFECT_* 반환
+} MQTT_COMMAND;
+
+constexpr uint32_t mqttCmdKey(const char* s) {
+  return (uint32_t)(uint8_t)s[0] | ((uint32_t)(uint8_t)s[1] << 8) | ((uint32_t)(uint8_t)s[2] << 16);
+}
+
+// 페이로드 파싱 결과
+enum MqttParseResult {
+  MQTT_PARSE_OK = 0,
+  MQTT_PARSE_TOO_LONG,                // MQTT_CMD_PAYLOAD_MAX 초과
+  MQTT_PARSE_INVALID,                 // 범위를 벗어난 값 - 배치 전체 거부
+  MQTT_PARSE_TOO_MANY,                // MQTT_CMD_BATCH_MAX 초과
+};
+
+MqttParseResult mqttParseCommands(const uint8_t* payload, size_t len, MQTT_CMD_BATCH& batch);  // MQTT Task
+void mqttApplyBatch(const MQTT_CMD_BATCH& batch);   // 제어 루프 컨텍스트 (틱 경계)
+const char* mqttCommandName(uint8_t index);
+
+// 파서 진단 출력 (펌웨어: mqttCommand.cpp에서 Serial/LOGx로 연결, 호스트 테스트는 nullptr)
+typedef struct {
+  void (*unknown)(const uint8_t* name, size_t nameLen, const uint8_t* value, size_t valueLen);
+  void (*range)(const char* name, int32_t value);
+} MQTT_PARSE_LOG;
+
+// 파서 본체 (mqttCommandParser.cpp - Arduino 의존성 없음, 호스트 테스트 대상)
+MqttParseResult mqttParseWith(const MQTT_COMMAND* table, uint8_t count,
+                              const uint8_t* payload, size_t len, MQTT_CMD_BATCH& batch,
+                              const MQTT_PARSE_LOG* log = nullptr);
+int32_t mqttSpanToInt(const uint8_t* p, size_t len);   // atoi 규칙, 32비트 범위로 포화
@@ -0,0 +1,108 @@
+// mqttCommandParser.cpp - MQTT 수신 명령 단일 패스 파서 (Arduino/FreeRTOS 의존성 없음)
+//
+// 명령 테이블은 호출자가 넘겨준다 (펌웨어: mqttCommand.cpp의 s_commands).
+// 진단 출력은 호출자가 넘긴 MQTT_PARSE_LOG로 보내므로 호스트 테스트에서도 그대로 빌드된다.
+
+#include "mqttCommand.h"
+#include <string.h>
+
+static int findCommand(const MQTT_COMMAND* table, uint8_t count, const uint8_t* name, size_t len) {
+  if (len != 3) return -1;
+  uint32_t key = (uint32_t)name[0] | ((uint32_t)name[1] << 8) | ((uint32_t)name[2] << 16);
+  for (uint8_t i = 0; i < count; i++) {
+    if (table[i].key == key) return i;
+  }
+  return -1;
+}
+
+// atoi 규칙 (앞 공백/부호/숫자, 숫자 아닌 문자에서 멈춤) - 길이 제한 버전
+// 범위를 넘으면 INT32_MAX/INT32_MIN으로 포화 (ESP32 newlib atoi = 32비트 strtol과 같은 결과)
+int32_t mqttSpanToInt(const uint8_t* p, size_t len) {
+  size_t i = 0;
+  while (i < len && (p[i] == ' ' || (p[i] >= '\t' && p[i] <= '\r'))) i++;
+  bool neg = false;
+  if (i < len && (p[i] == '-' || p[i] == '+')) neg = (p[i++] == '-');
+  const uint32_t limit = neg ? 0x80000000UL : 0x7FFFFFFFUL;
+  uint32_t v = 0;
+  while (i < len && p[i] >= '0' && p[i] <= '9') {
+    uint32_t d = p[i++] - '0';
+    if (v > (limit - d) / 10) {
+      v = limit;                       // 나머지 숫자는 버림
+      break;
+    }
+    v = v * 10 + d;
+  }
+  if (!neg) return (int32_t)v;
+  return (v == 0x80000000UL) ? INT32_MIN : -(int32_t)v;
+}
+
+// ========== 단일 패스 파서 ==========
+// 항목 구분은 ',' - 각 항목에서 첫 '"' 다음부터 '@'까지가 명령, ':' 뒤(공백/따옴표 제외)가 값
+MqttParseResult mqttParseWith(const MQTT_COMMAND* table, uint8_t count,
+                              const uint8_t* p, size_t len, MQTT_CMD_BATCH& batch,
+                              const MQTT_PARSE_LOG* log) {
+  batch.count = 0;
+  if (len > MQTT_CMD_PAYLOAD_MAX) return MQTT_PARSE_TOO_LONG;
+
+  size_t i = 0;
+  while (i < len) {
+    // 항목 안의 첫 따옴표
+    while (i < len && p[i] != '"' && p[i] != ',') i++;
+    if (i >= len) break;
+    if (p[i] == ',') { i++; continue; }
+    size_t nameStart = ++i;
+
+    // 명령 이름 ('@'까지)
+    while (i < len && p[i] != '@' && p[i] != ',') i++;
+    if (i >= len) break;
+    if (p[i] == ',') { i++; continue; }
+    size_t nameLen = i - nameStart;
+
+    // ':' 찾기
+    while (i < len && p[i] != ':' && p[i] != ',') i++;
+    if (i >= len) break;
+    if (p[i] == ',') { i++; continue; }
+    i++;
+
+    // 값: 공백/따옴표 건너뛰고 '"', '}', ',' 전까지 (최대 MQTT_CMD_VALUE_MAX)
+    while (i < len && (p[i] == ' ' || p[i] == '"')) i++;
+    size_t valStart = i;
+    while (i < len && p[i] != '"' && p[i] != '}' && p[i] != ',' &&
+           i - valStart < MQTT_CMD_VALUE_MAX) i++;
+    size_t valLen = i - valStart;
+
+    // 다음 항목으로 (이 항목의 나머지 건너뜀)
+    while (i < len && p[i] != ',') i++;
+
+    if (valLen == 0 || nameLen >= 8) continue;
+    int idx = findCommand(table, count, &p[nameStart], nameLen);
+    if (idx < 0) {
+      if (log && log->unknown) log->unknown(&p[nameStart], nameLen, &p[valStart], valLen);
+      continue;
+    }
+
+    if (batch.count >= MQTT_CMD_BATCH_MAX) {
+      batch.count = 0;
+      return MQTT_PARSE_TOO_MANY;
+    }
+
+    const MQTT_COMMAND& def = table[idx];
+    MQTT_RX_CMD& cmd = batch.cmd[batch.count];
+    cmd.index = (uint8_t)idx;
+    cmd.ivalue = 0;
+    cmd.svalue[0] = '\0';
+    if (def.type == MQTT_VAL_INT) {
+      cmd.ivalue = mqttSpanToInt(&p[valStart], valLen);
+      if (cmd.ivalue < def.min || cmd.ivalue > def.max) {
+        if (log && log->range) log->range(def.name, cmd.ivalue);
+        batch.count = 0;
+        return MQTT_PARSE_INVALID;
+      }
+    } else {
+      memcpy(cmd.svalue, &p[valStart], valLen);
+      cmd.svalue[valLen] = '\0';
+    }
+    batch.count++;
+  }
+  return MQTT_PARSE_OK;
+}
@@ -0,0 +1,199 @@
+// mqttPublisher.cpp - QoS1 발행 엔진 구현
+
+#include "mqttPublisher.h"
+#include "../binLog/binLog.h"
+
+// MQTT 3.1.1 패킷 타입 (고정 헤더 상위 4비트)
+#define MQTT_PKT_PUBLISH  0x30
+#define MQTT_PKT_PUBACK   0x40
+#define MQTT_FLAG_DUP     0x08
+
+// 수신 파서 상태
+enum { RX_HEADER = 0, RX_LENGTH, RX_BODY };
+
+// 패킷 조립 버퍼 (MQTT Task 전용)
+static uint8_t s_packet[MQTT_PAYLOAD_MAX + 64];
+
+void MQTTPublisher::begin(PubSubClient* client) {
+  _client = client;
+  _head = 0;
+  _count = 0;
+  _inflight = 0;
+  memset(_box, 0, sizeof(_box));
+  resetRx();
+}
+
+uint16_t MQTTPublisher::nextPacketId() {
+  if (++_packetId == 0) _packetId = 1;  // 0은 사용 불가
+  return _packetId;
+}
+
+bool MQTTPublisher::submit(const char* topic, const char* payload, uint8_t qos) {
+  return submit(topic, (const uint8_t*)payload, strlen(payload), qos);
+}
+
+bool MQTTPublisher::submit(const char* topic, const uint8_t* data, size_t len, uint8_t qos) {
+  if (!hasRoom() || len > MQTT_PAYLOAD_MAX) {
+    _stats.dropped++;
+    LOGW("[MQTTPub] Dropped (outbox %u, len %u, total %lu)\n",
+         _count, (unsigned)len, (unsigned long)_stats.dropped);
+    return false;
+  }
+
+  OUTBOX_ENTRY& e = _box[(_head + _count) % MQTT_OUTBOX_LEN];
+  e.topic = topic;
+  e.len = (uint16_t)len;
+  memcpy(e.payload, data, len);
+  e.qos = qos ? 1 : 0;
+  e.packetId = e.qos ? nextPacketId() : 0;
+  e.state = ENTRY_PENDING;
+  e.dup = false;
+  e.sentAt = 0;
+  _count++;
+  _stats.submitted++;
+  _stats.depth = _count;
+  return true;
+}
+
+void MQTTPublisher::resetRx() {
+  _rxState = RX_HEADER;
+  _rxRemaining = 0;
+  _rxMultiplier = 1;
+  _rxPos = 0;
+}
+
+void MQTTPublisher::onConnected() {
+  // 이전 연결에서 PUBACK을 못 받은 항목은 같은 패킷 ID로 DUP 재전송 (최소 1회 전달)
+  for (uint8_t i = 0; i < _count; i++) {
+    OUTBOX_ENTRY& e = _box[(_head + i) % MQTT_OUTBOX_LEN];
+    if (e.state == ENTRY_INFLIGHT) {
+      e.state = ENTRY_PENDING;
+      e.dup = true;
+      _inflight--;
+    }
+  }
+}
+
+// PUBLISH 패킷 직접 조립: 고정 헤더 + 남은 길이 + 토픽 + 패킷 ID + 페이로드
+bool MQTTPublisher::send(OUTBOX_ENTRY& e) {
+  size_t topicLen = strlen(e.topic);
+  size_t remaining = 2 + topicLen + (e.qos ? 2 : 0) + e.len;
+  if (remaining + 5 > sizeof(s_packet)) return false;
+
+  size_t n = 0;
+  s_packet[n++] = MQTT_PKT_PUBLISH | (e.qos << 1) | (e.dup ? MQTT_FLAG_DUP : 0);
+  do {
+    uint8_t b = remaining % 128;
+    remaining /= 128;
+    if (remaining > 0) b |= 0x80;
+    s_packet[n++] = b;
+  } while (remaining > 0);
+  s_packet[n++] = (uint8_t)(topicLen >> 8);
+  s_packet[n++] = (uint8_t)topicLen;
+  memcpy(&s_packet[n], e.topic, topicLen);
+  n += topicLen;
+  if (e.qos) {
+    s_packet[n++] = (uint8_t)(e.packetId >> 8);
+    s_packet[n++] = (uint8_t)e.packetId;
+  }
+  memcpy(&s_packet[n], e.payload, e.len);
+  n += e.len;
+
+  return _client->write(s_packet, n) == n;
+}
+
+void MQTTPublisher::service() {
+  if (_client == nullptr) return;
+  uint32_t now = millis();
+
+  for (uint8_t i = 0; i < _count; i++) {
+    OUTBOX_ENTRY& e = _box[(_head + i) % MQTT_OUTBOX_LEN];
+
+    if (e.state == ENTRY_INFLIGHT) {
+      if (now - e.sentAt < MQTT_PUBACK_TIMEOUT_MS) continue;
+      e.dup = true;
+      if (!send(e)) return;  // 연결 끊김 - 재연결 후 onConnected()에서 재시도
+      e.sentAt = now;
+      _stats.retransmits++;
+      LOGI("[MQTTPub] Retransmit id %u\n", e.packetId);
+      continue;
+    }
+
+    if (e.state != ENTRY_PENDING) continue;
+    // 순서 유지: 윈도우가 차면 뒤 항목도 보내지 않음
+    if (e.qos && _inflight >= MQTT_INFLIGHT_WINDOW) break;
+    if (!send(e)) return;
+
+    if (e.dup) _stats.retransmits++;
+    else _stats.sent++;
+    if (e.qos) {
+      e.state = ENTRY_INFLIGHT;
+      e.sentAt = now;
+      _inflight++;
+    } else {
+      e.state = ENTRY_FREE;  // QoS0: 전송으로 완료
+    }
+  }
+
+  // 완료된 앞쪽 항목 회수
+  while (_count > 0 && _box[_head].state == ENTRY_FREE) {
+    _head = (_head + 1) % MQTT_OUTBOX_LEN;
+    _count--;
+  }
+  _stats.depth = _count;
+  _stats.inflight = _inflight;
+}
+
+void MQTTPublisher::onPubAck(uint16_t packetId) {
+  for (uint8_t i = 0; i < _count; i++) {
+    OUTBOX_ENTRY& e = _box[(_head + i) % MQTT_OUTBOX_LEN];
+    if (e.state == ENTRY_INFLIGHT && e.packetId == packetId) {
+      e.state = ENTRY_FREE;
+      _inflight--;
+      _stats.acked++;
+      return;
+    }
+  }
+  // 재전송 후 늦게 도착한 중복 PUBACK 등은 무시
+}
+
+void MQTTPublisher::rxTap(const uint8_t* data, size_t len, void* arg) {
+  static_cast<MQTTPublisher*>(arg)->onRxBytes(data, len);
+}
+
+// 수신 스트림에서 패킷 경계를 따라가며 PUBACK의 패킷 ID만 추출
+void MQTTPublisher::onRxBytes(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    uint8_t b = data[i];
+    switch (_rxState) {
+      case RX_HEADER:
+        _rxType = b & 0xF0;
+        _rxRemaining = 0;
+        _rxMultiplier = 1;
+        _rxPos = 0;
+        _rxId = 0;
+        _rxState = RX_LENGTH;
+        break;
+
+      case RX_LENGTH:
+        _rxRemaining += (b & 0x7F) * _rxMultiplier;
+        _rxMultiplier *= 128;
+        if ((b & 0x80) == 0) {
+          _rxState = (_rxRemaining > 0) ? RX_BODY : RX_HEADER;
+        } else if (_rxMultiplier > 128UL * 128UL * 128UL) {
+          resetRx();  // 잘못된 길이 - 다음 바이트부터 다시 동기화
+        }
+        break;
+
+      case RX_BODY:
+        if (_rxType == MQTT_PKT_PUBACK && _rxPos < 2) {
+          _rxId = (_rxId << 8) | b;
+        }
+        if (++_rxPos >= _rxRemaining) {
+          if (_rxType == MQTT_PKT_PUBACK && _rxRemaining >= 2) onPubAck(_rxId);
+          _rxState = RX_HEADER;
+        }
+        break;
+    }
+  }
+}
@@ -0,0 +1,73 @@
+// mqttPublisher.h - QoS1 발행 엔진 (송신함 + PUBACK 추적 + 재전송)
+//
+// PubSubClient는 QoS0 publish만 지원하고 PUBACK을 읽어서 버린다.
+// MQTTPublisher는 QoS1 PUBLISH 패킷을 직접 만들어 PubSubClient::write()로 보내고,
+// TLSClient 수신 탭으로 들어오는 MQTT 스트림에서 PUBACK을 찾아 전송 중 항목을 완료 처리한다.
+// 모든 메서드는 MQTT Task에서만 호출한다 (잠금 없음).
+
+#pragma once
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "../config.h"
+
+// 발행 통계 (진단용)
+typedef struct {
+  uint32_t submitted;         // 송신함에 들어온 메시지 수
+  uint32_t sent;              // 최초 전송 수
+  uint32_t acked;             // PUBACK 수신 수
+  uint32_t retransmits;       // 재전송 수 (타임아웃/재연결, DUP=1)
+  uint32_t dropped;           // 송신함 가득 참으로 버린 수
+  uint8_t depth;              // 현재 송신함 항목 수
+  uint8_t inflight;           // 현재 PUBACK 대기 수
+} MQTT_PUB_STATS;
+
+class MQTTPublisher {
+public:
+  void begin(PubSubClient* client);
+  bool hasRoom() const { return _count < MQTT_OUTBOX_LEN; }
+  uint8_t freeSlots() const { return MQTT_OUTBOX_LEN - _count; }
+  bool submit(const char* topic, const char* payload, uint8_t qos);
+  bool submit(const char* topic, const uint8_t* data, size_t len, uint8_t qos);  // 바이너리
+  void resetRx();             // 새 연결 전: 수신 파서 초기화
+  void onConnected();         // 연결 직후: PUBACK 못 받은 항목을 DUP로 재전송 예약
+  void service();             // 윈도우 안에서 전송 + 타임아웃 재전송 (연결된 상태에서 호출)
+  const MQTT_PUB_STATS& stats() const { return _stats; }
+
+  static void rxTap(const uint8_t* data, size_t len, void* arg);  // TLSClient 수신 탭
+
+private:
+  enum EntryState : uint8_t { ENTRY_FREE = 0, ENTRY_PENDING, ENTRY_INFLIGHT };
+
+  typedef struct {
+    const char* topic;        // 정적 문자열 (AWS_IOT_PUBLISH_TOPIC 등)
+    uint16_t len;
+    uint16_t packetId;
+    uint8_t qos;
+    uint8_t state;            // EntryState
+    bool dup;
+    uint32_t sentAt;
+    uint8_t payload[MQTT_PAYLOAD_MAX];
+  } OUTBOX_ENTRY;
+
+  bool send(OUTBOX_ENTRY& e);
+  void onRxBytes(const uint8_t* data, size_t len);
+  void onPubAck(uint16_t packetId);
+  uint16_t nextPacketId();
+
+  PubSubClient* _client = nullptr;
+  OUTBOX_ENTRY _box[MQTT_OUTBOX_LEN];
+  uint8_t _head = 0;          // 가장 오래된 항목
+  uint8_t _count = 0;         // head부터 사용 중인 슬롯 수 (완료된 빈 자리 포함)
+  uint8_t _inflight = 0;
+  uint16_t _packetId = 0;
+  MQTT_PUB_STATS _stats = {};
+
+  // 수신 스트림 파서 (고정 헤더 → 남은 길이 → 본문)
+  uint8_t _rxState = 0;
+  uint8_t _rxType = 0;
+  uint32_t _rxRemaining = 0;
+  uint32_t _rxMultiplier = 1;
+  uint32_t _rxPos = 0;
+  uint16_t _rxId = 0;
+};
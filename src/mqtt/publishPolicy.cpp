@@ -0,0 +1,43 @@
+// publishPolicy.cpp - 텔레메트리 발행 시점 결정 구현
+
+#include "publishPolicy.h"
+
+PublishReason PublishPolicy::evaluate(const TELEMETRY_SAMPLE& s, uint32_t now) const {
+  if (!_havePublished) return PUBLISH_FIRST;
+
+  uint32_t elapsed = now - _lastTime;
+
+  // 운전 상태 변화는 바로 보고 (연속 변화는 최소 간격으로 묶음)
+  if (s.dry_state != _last.dry_state || s.relay_state != _last.relay_state ||
+      s.error_info != _last.error_info || s.seljung_temp_x10 != _last.seljung_temp_x10) {
+    if (elapsed >= PUBLISH_STATE_MIN_INTERVAL_MS) return PUBLISH_STATE;
+  }
+
+  if (elapsed >= PUBLISH_MAX_INTERVAL_MS) return PUBLISH_HEARTBEAT;
+  if (elapsed < PUBLISH_MIN_INTERVAL_MS) return PUBLISH_NONE;
+
+  if (exceeds(s.ntc_temp_x10, _last.ntc_temp_x10, PUBLISH_DEADBAND_TEMP_X10) ||
+      exceeds(s.sht30_temp_x10, _last.sht30_temp_x10, PUBLISH_DEADBAND_TEMP_X10) ||
+      exceeds(s.humidity_x10, _last.humidity_x10, PUBLISH_DEADBAND_HUMI_X10) ||
+      exceeds(s.fan_current, _last.fan_current, PUBLISH_DEADBAND_FAN_CURRENT) ||
+      exceeds(s.remaining_minute, _last.remaining_minute, PUBLISH_DEADBAND_REMAIN_MIN)) {
+    return PUBLISH_DEADBAND;
+  }
+  return PUBLISH_NONE;
+}
+
+void PublishPolicy::markPublished(const TELEMETRY_SAMPLE& s, uint32_t now) {
+  _last = s;
+  _lastTime = now;
+  _havePublished = true;
+}
+
+const char* PublishPolicy::reasonName(PublishReason r) {
+  switch (r) {
+    case PUBLISH_FIRST:     return "first";
+    case PUBLISH_STATE:     return "state";
+    case PUBLISH_DEADBAND:  return "deadband";
+    case PUBLISH_HEARTBEAT: return "heartbeat";
+    default:                return "none";
+  }
+}
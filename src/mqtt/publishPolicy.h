@@ -0,0 +1,35 @@
+// publishPolicy.h - 텔레메트리 발행 시점 결정 (데드밴드 + 상태 변화 + 최소/최대 간격)
+//
+// 마지막으로 발행한 샘플과 현재 샘플을 비교한다.
+//  - dry_state / relay_state / error_info / 설정 온도 변화: 즉시 (PUBLISH_STATE_MIN_INTERVAL_MS 이상 간격)
+//  - 온도/습도/팬 전류/남은 시간이 데드밴드를 넘으면: PUBLISH_MIN_INTERVAL_MS 이상 간격
+//  - 변화가 없어도 PUBLISH_MAX_INTERVAL_MS마다 한 번 (생존 신호)
+// 제어 루프(loop) 컨텍스트 전용.
+
+#pragma once
+
+#include <Arduino.h>
+#include "../config.h"
+#include "../typedef.h"
+
+enum PublishReason {
+  PUBLISH_NONE = 0,
+  PUBLISH_FIRST,        // 부팅 후 첫 샘플
+  PUBLISH_STATE,        // 상태/릴레이/에러/설정 변화
+  PUBLISH_DEADBAND,     // 측정값이 데드밴드 초과
+  PUBLISH_HEARTBEAT,    // 최대 간격 경과
+};
+
+class PublishPolicy {
+public:
+  PublishReason evaluate(const TELEMETRY_SAMPLE& s, uint32_t now) const;
+  void markPublished(const TELEMETRY_SAMPLE& s, uint32_t now);
+  static const char* reasonName(PublishReason r);
+
+private:
+  static bool exceeds(int32_t a, int32_t b, int32_t band) { return abs(a - b) >= band; }
+
+  bool _havePublished = false;
+  uint32_t _lastTime = 0;
+  TELEMETRY_SAMPLE _last = {};
+};
@@ -0,0 +1,163 @@
+// telemetryCodec.cpp - 바이너리 텔레메트리 프레임 인코더/디코더 구현
+
+#include "telemetryCodec.h"
+#include <string.h>
+
+// CRC16-CCITT (poly 0x1021, init 0xFFFF)
+uint16_t telemetryCrc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// ========== 리틀 엔디언 헬퍼 ==========
+static inline void put16(uint8_t*& p, uint16_t v) {
+  *p++ = (uint8_t)v;
+  *p++ = (uint8_t)(v >> 8);
+}
+
+static inline void put32(uint8_t*& p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get16(const uint8_t*& p) {
+  uint16_t v = (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+  p += 2;
+  return v;
+}
+
+static inline uint32_t get32(const uint8_t*& p) {
+  uint32_t lo = get16(p);
+  return lo | ((uint32_t)get16(p) << 16);
+}
+
+// 비트맵에 해당하는 필드 값 바이트 수
+static size_t fieldsSize(uint16_t present) {
+  size_t n = 0;
+  if (present & TLM_FIELD_UPTIME) n += 4;
+  for (uint16_t f = TLM_FIELD_FAN_CURRENT; f <= TLM_FIELD_SELJUNG_TEMP; f <<= 1) {
+    if (present & f) n += 2;
+  }
+  for (uint16_t f = TLM_FIELD_RELAY; f <= TLM_FIELD_ERROR; f <<= 1) {
+    if (present & f) n += 1;
+  }
+  return n;
+}
+
+// ========== 인코더 ==========
+void TelemetryEncoder::begin(const uint8_t mac[6], uint16_t fwVersion, uint8_t keyframeInterval) {
+  memcpy(_mac, mac, sizeof(_mac));
+  _fwVersion = fwVersion;
+  _keyInterval = keyframeInterval ? keyframeInterval : 1;
+  _sinceKey = 0xFF;
+  _seq = 0;
+  _hasPending = false;
+}
+
+size_t TelemetryEncoder::encode(const TELEMETRY_SAMPLE& s, uint8_t* out, size_t outSize) {
+  bool key = (_sinceKey >= _keyInterval);
+
+  // 직전 전송 값과 다른 필드만 포함 (업타임은 항상 포함)
+  uint16_t present = TLM_FIELD_ALL;
+  if (!key) {
+    present = TLM_FIELD_UPTIME;
+    if (s.fan_current != _last.fan_current) present |= TLM_FIELD_FAN_CURRENT;
+    if (s.remaining_minute != _last.remaining_minute) present |= TLM_FIELD_REMAINING;
+    if (s.ntc_temp_x10 != _last.ntc_temp_x10) present |= TLM_FIELD_NTC_TEMP;
+    if (s.sht30_temp_x10 != _last.sht30_temp_x10) present |= TLM_FIELD_SHT30_TEMP;
+    if (s.humidity_x10 != _last.humidity_x10) present |= TLM_FIELD_HUMIDITY;
+    if (s.seljung_temp_x10 != _last.seljung_temp_x10) present |= TLM_FIELD_SELJUNG_TEMP;
+    if (s.relay_state != _last.relay_state) present |= TLM_FIELD_RELAY;
+    if (s.dry_state != _last.dry_state) present |= TLM_FIELD_DRY_STATE;
+    if (s.error_info != _last.error_info) present |= TLM_FIELD_ERROR;
+  }
+
+  size_t need = 5 + (key ? 8 : 0) + fieldsSize(present) + 2;
+  if (need > outSize) return 0;
+
+  uint8_t* p = out;
+  *p++ = TELEMETRY_CODEC_VERSION;
+  *p++ = key ? TLM_FLAG_KEYFRAME : 0;
+  *p++ = _seq;
+  put16(p, present);
+  if (key) {
+    memcpy(p, _mac, 6);
+    p += 6;
+    put16(p, _fwVersion);
+  }
+  if (present & TLM_FIELD_UPTIME) put32(p, s.uptime_ms / 1000);
+  if (present & TLM_FIELD_FAN_CURRENT) put16(p, s.fan_current);
+  if (present & TLM_FIELD_REMAINING) put16(p, s.remaining_minute);
+  if (present & TLM_FIELD_NTC_TEMP) put16(p, (uint16_t)s.ntc_temp_x10);
+  if (present & TLM_FIELD_SHT30_TEMP) put16(p, (uint16_t)s.sht30_temp_x10);
+  if (present & TLM_FIELD_HUMIDITY) put16(p, (uint16_t)s.humidity_x10);
+  if (present & TLM_FIELD_SELJUNG_TEMP) put16(p, (uint16_t)s.seljung_temp_x10);
+  if (present & TLM_FIELD_RELAY) *p++ = s.relay_state;
+  if (present & TLM_FIELD_DRY_STATE) *p++ = s.dry_state;
+  if (present & TLM_FIELD_ERROR) *p++ = s.error_info;
+  put16(p, telemetryCrc16(out, p - out));
+
+  _pending = s;
+  _pendingKey = key;
+  _hasPending = true;
+  return p - out;
+}
+
+void TelemetryEncoder::commit() {
+  if (!_hasPending) return;
+  _last = _pending;
+  _seq++;
+  _sinceKey = _pendingKey ? 1 : (uint8_t)(_sinceKey + 1);
+  _hasPending = false;
+}
+
+// ========== 디코더 ==========
+TelemetryDecodeResult TelemetryDecoder::decode(const uint8_t* in, size_t len, TELEMETRY_SAMPLE& out) {
+  if (len < 7) return TLM_DECODE_SHORT;
+  uint16_t crc = (uint16_t)in[len - 2] | ((uint16_t)in[len - 1] << 8);
+  if (telemetryCrc16(in, len - 2) != crc) return TLM_DECODE_CRC;
+  if (in[0] != TELEMETRY_CODEC_VERSION) return TLM_DECODE_VERSION;
+
+  const uint8_t* p = in + 1;
+  bool key = (*p++ & TLM_FLAG_KEYFRAME) != 0;
+  uint8_t seq = *p++;
+  uint16_t present = get16(p);
+  if (5 + (key ? 8 : 0) + fieldsSize(present) + 2 != len) return TLM_DECODE_SHORT;
+
+  if (!key && _haveBase && seq == _seq) {
+    return TLM_DECODE_DUPLICATE;  // QoS1 DUP 재전송 - 기준 상태 유지
+  }
+  if (!key && (!_haveBase || seq != (uint8_t)(_seq + 1))) {
+    _haveBase = false;  // 기준 상태 손실 - 다음 키프레임까지 대기
+    return TLM_DECODE_NO_BASE;
+  }
+
+  TELEMETRY_SAMPLE s = key ? TELEMETRY_SAMPLE{} : _last;
+  if (key) {
+    memcpy(_mac, p, 6);
+    p += 6;
+    _fwVersion = get16(p);
+  }
+  if (present & TLM_FIELD_UPTIME) s.uptime_ms = get32(p) * 1000;
+  if (present & TLM_FIELD_FAN_CURRENT) s.fan_current = get16(p);
+  if (present & TLM_FIELD_REMAINING) s.remaining_minute = get16(p);
+  if (present & TLM_FIELD_NTC_TEMP) s.ntc_temp_x10 = (int16_t)get16(p);
+  if (present & TLM_FIELD_SHT30_TEMP) s.sht30_temp_x10 = (int16_t)get16(p);
+  if (present & TLM_FIELD_HUMIDITY) s.humidity_x10 = (int16_t)get16(p);
+  if (present & TLM_FIELD_SELJUNG_TEMP) s.seljung_temp_x10 = (int16_t)get16(p);
+  if (present & TLM_FIELD_RELAY) s.relay_state = *p++;
+  if (present & TLM_FIELD_DRY_STATE) s.dry_state = *p++;
+  if (present & TLM_FIELD_ERROR) s.error_info = *p++;
+
+  _last = s;
+  _seq = seq;
+  _haveBase = true;
+  out = s;
+  return TLM_DECODE_OK;
+}
@@ -0,0 +1,91 @@
+// telemetryCodec.h - 바이너리 텔레메트리 프레임 인코더/디코더
+//
+// zz ASCII 프레임(약 200 bytes + JSON)을 대체하는 선택형 바이너리 프레임.
+// Arduino 의존성이 없어 호스트(서버/PC 도구)에서도 그대로 컴파일된다.
+//
+// 프레임 구조 (리틀 엔디언):
+//   [0]    버전 (TELEMETRY_CODEC_VERSION)
+//   [1]    플래그 (TLM_FLAG_*)
+//   [2]    시퀀스 번호 (디코더가 누락 감지)
+//   [3..4] 필드 존재 비트맵 (TLM_FIELD_*) - 직전 프레임과 같은 필드는 생략
+//   [..]   키프레임이면 장치 ID(MAC 6) + 펌웨어 버전(2)
+//   [..]   비트맵 순서대로 필드 값
+//   [-2..] CRC16-CCITT (앞의 모든 바이트)
+//
+// 키프레임은 모든 필드를 담는다. 델타 프레임은 디코더가 직전 상태를 갖고 있어야 하므로
+// 시퀀스가 끊기면 다음 키프레임까지 델타를 버린다.
+// 인코더는 encode()로 프레임만 만들고, 전송 성공 후 commit()해야 델타 기준/시퀀스가 넘어간다
+// (전송 실패 시 commit하지 않으면 다음 프레임이 같은 기준으로 다시 만들어짐).
+// 디코더는 QoS1 재전송(DUP)으로 같은 시퀀스의 델타가 다시 오면 상태를 건드리지 않고 무시한다.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../typedef.h"
+
+#define TELEMETRY_CODEC_VERSION   1
+#define TELEMETRY_FRAME_MAX       48      // 키프레임 최대 크기
+
+// 플래그
+#define TLM_FLAG_KEYFRAME         0x01
+
+// 필드 존재 비트맵
+#define TLM_FIELD_UPTIME          (1u << 0)   // uint32 초
+#define TLM_FIELD_FAN_CURRENT     (1u << 1)   // uint16
+#define TLM_FIELD_REMAINING       (1u << 2)   // uint16 분
+#define TLM_FIELD_NTC_TEMP        (1u << 3)   // int16 x10
+#define TLM_FIELD_SHT30_TEMP      (1u << 4)   // int16 x10
+#define TLM_FIELD_HUMIDITY        (1u << 5)   // int16 x10
+#define TLM_FIELD_SELJUNG_TEMP    (1u << 6)   // int16 x10
+#define TLM_FIELD_RELAY           (1u << 7)   // uint8
+#define TLM_FIELD_DRY_STATE       (1u << 8)   // uint8
+#define TLM_FIELD_ERROR           (1u << 9)   // uint8
+#define TLM_FIELD_ALL             0x03FFu
+
+uint16_t telemetryCrc16(const uint8_t* data, size_t len);
+
+// 장치 측 인코더 (직전 전송 상태 보관)
+class TelemetryEncoder {
+public:
+  void begin(const uint8_t mac[6], uint16_t fwVersion, uint8_t keyframeInterval);
+  void reset() { _sinceKey = 0xFF; _hasPending = false; }  // 다음 프레임을 키프레임으로 (재연결 등)
+  size_t encode(const TELEMETRY_SAMPLE& s, uint8_t* out, size_t outSize);  // 상태 변경 없음
+  void commit();                        // 마지막 encode() 프레임이 전송됨 → 기준 갱신
+
+private:
+  uint8_t _mac[6] = {0};
+  uint16_t _fwVersion = 0;
+  uint8_t _keyInterval = 12;
+  uint8_t _sinceKey = 0xFF;
+  uint8_t _seq = 0;
+  TELEMETRY_SAMPLE _last = {};
+  TELEMETRY_SAMPLE _pending = {};       // encode()했지만 아직 commit 안 된 샘플
+  bool _pendingKey = false;
+  bool _hasPending = false;
+};
+
+// 디코더 결과
+enum TelemetryDecodeResult {
+  TLM_DECODE_OK = 0,
+  TLM_DECODE_SHORT,       // 길이 부족
+  TLM_DECODE_CRC,         // CRC 불일치
+  TLM_DECODE_VERSION,     // 알 수 없는 버전
+  TLM_DECODE_NO_BASE,     // 키프레임 이전 또는 시퀀스 누락 후의 델타
+  TLM_DECODE_DUPLICATE,   // 직전과 같은 시퀀스의 델타 (재전송) - 무시, 상태 유지
+};
+
+// 수신 측 디코더 (장치별 인스턴스 하나)
+class TelemetryDecoder {
+public:
+  TelemetryDecodeResult decode(const uint8_t* in, size_t len, TELEMETRY_SAMPLE& out);
+  const uint8_t* mac() const { return _mac; }
+  uint16_t fwVersion() const { return _fwVersion; }
+
+private:
+  bool _haveBase = false;
+  uint8_t _seq = 0;
+  uint8_t _mac[6] = {0};
+  uint16_t _fwVersion = 0;
+  TELEMETRY_SAMPLE _last = {};
+};
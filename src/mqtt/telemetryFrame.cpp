@@ -0,0 +1,122 @@
+// telemetryFrame.cpp - zz 텔레메트리 프레임 템플릿 구현
+
+#include "telemetryFrame.h"
+#include <string.h>
+#include <stdio.h>
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+void TelemetryFrame::append(const char* s) {
+  size_t n = strlen(s);
+  if (_len + n >= sizeof(_buf)) n = sizeof(_buf) - 1 - _len;
+  memcpy(&_buf[_len], s, n);
+  _len += n;
+  _buf[_len] = '\0';
+}
+
+void TelemetryFrame::appendHex(uint16_t value, uint8_t width) {
+  for (int8_t i = width - 1; i >= 0 && _len < sizeof(_buf) - 1; i--) {
+    _buf[_len++] = HEX_DIGITS[(value >> (i * 4)) & 0x0F];
+  }
+  _buf[_len] = '\0';
+}
+
+void TelemetryFrame::appendField(Field f, uint8_t width) {
+  _off[f] = _len;
+  _width[f] = width;
+  appendHex(0, width);
+}
+
+// 형식: 전화번호|IMEI|CPUID|IDX|압축기전류|히터전류|팬전류|버전|재상모드|O3모드|재상주기|재상시간|오존주기|오존발생시간|
+//       릴레이상태|오존측정|제어온도|T1온도|T2온도|습도|CO2|설정온도|오존기준|습도상태|시스템상태|체크섬
+void TelemetryFrame::begin(const char* cpuid, uint16_t fwVersion) {
+  _len = 0;
+  _buf[0] = '\0';
+
+  append("{\"idx\":0,\"zz\":\"");
+  _zzStart = _len;
+  append("01252769611|770186056655075|");
+  append(cpuid);
+  append("|01|0000|0000|");                 // IDX, 압축기 전류, 히터 전류
+  appendField(F_FAN_CURRENT, 4);            // 팬 전류
+  append("|");
+  appendHex(fwVersion, 4);                  // 펌웨어 버전
+  append("|00|00|");                        // 재상 모드, O3 모드
+  appendField(F_REMAINING, 4);              // 남은 시간
+  append("|0000|001E|0032|");               // 재상 시간, 오존 주기(30), 오존 발생시간(50)
+  appendField(F_RELAY, 2);                  // 릴레이 상태 (RY1~RY8)
+  append("|0000|");                         // 오존 측정값
+  appendField(F_NTC_TEMP, 4);               // 제어 온도 (NTC, x10)
+  append("|");
+  appendField(F_SHT30_TEMP, 4);             // T1 온도 (SHT30, x10)
+  append("|0000|");                         // T2 온도
+  appendField(F_HUMIDITY, 4);               // 습도 (SHT30, x10)
+  append("|0000|");                         // CO2
+  appendField(F_SELJUNG_TEMP, 4);           // 설정 온도
+  append("|03E8|0000|0000|");               // 오존 기준(1000), 습도 상태, 시스템 상태
+  appendField(F_CHECKSUM, 2);
+  append("\"}");
+
+  // 체크섬 기준값: 체크섬 자리를 뺀 zz 문자 합
+  _sum = 0;
+  for (uint16_t i = _zzStart; i < _off[F_CHECKSUM]; i++) {
+    _sum += (uint8_t)_buf[i];
+  }
+}
+
+// 필드 덮어쓰기 + 바뀐 문자만큼 체크섬 증감
+// 폭이 바뀌면 (부호 필드 4 ↔ 8자리) 뒤쪽 문자열을 밀고 이후 필드 위치를 옮긴다
+void TelemetryFrame::patch(Field f, uint32_t value, uint8_t width) {
+  uint8_t old = _width[f];
+  if (width != old) {
+    if (_len + width - old >= (int)sizeof(_buf)) return;  // 256 버퍼에서는 발생하지 않음
+    char* p = &_buf[_off[f]];
+    for (uint8_t i = 0; i < old; i++) _sum -= (uint8_t)p[i];
+    uint16_t end = _off[f] + old;
+    memmove(&_buf[end + width - old], &_buf[end], _len - end + 1);
+    for (uint8_t i = 0; i < width; i++) {
+      p[i] = '0';
+      _sum += (uint8_t)'0';
+    }
+    for (uint8_t g = f + 1; g < F_COUNT; g++) _off[g] += width - old;
+    _len += width - old;
+    _width[f] = width;
+  }
+
+  char* p = &_buf[_off[f]];
+  for (uint8_t i = 0; i < width; i++) {
+    char c = HEX_DIGITS[(value >> ((width - 1 - i) * 4)) & 0x0F];
+    if (f != F_CHECKSUM) _sum += (uint8_t)c - (uint8_t)p[i];
+    p[i] = c;
+  }
+}
+
+// 기존 snprintf("%04X", (int)v)와 동일: 음수는 int 32비트 그대로 8자리
+void TelemetryFrame::patchSigned(Field f, int16_t value) {
+  if (value < 0) patch(f, (uint32_t)(int32_t)value, 8);
+  else patch(f, (uint32_t)value, 4);
+}
+
+const char* TelemetryFrame::build(const TELEMETRY_SAMPLE& s, size_t& len) {
+  patch(F_FAN_CURRENT, s.fan_current, 4);
+  patch(F_REMAINING, s.remaining_minute, 4);
+  patch(F_RELAY, s.relay_state, 2);
+  patchSigned(F_NTC_TEMP, s.ntc_temp_x10);
+  patchSigned(F_SHT30_TEMP, s.sht30_temp_x10);
+  patchSigned(F_HUMIDITY, s.humidity_x10);
+  patchSigned(F_SELJUNG_TEMP, s.seljung_temp_x10);
+  patch(F_CHECKSUM, _sum, 2);
+  len = _len;
+  return _buf;
+}
+
+size_t TelemetryFrame::buildAged(const TELEMETRY_SAMPLE& s, long age_s, char* out, size_t outSize) {
+  size_t len;
+  build(s, len);
+  // {"idx":0,"age":N,"zz":"..."} - zz 부분은 템플릿에서 복사
+  int n = snprintf(out, outSize, "{\"idx\":0,\"age\":%ld,\"zz\":\"", age_s);
+  size_t tail = _len - _zzStart;
+  if (n < 0 || (size_t)n + tail >= outSize) return 0;
+  memcpy(out + n, &_buf[_zzStart], tail + 1);
+  return n + tail;
+}
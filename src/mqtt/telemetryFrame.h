@@ -0,0 +1,51 @@
+// telemetryFrame.h - zz 텔레메트리 프레임 템플릿 (고정 위치 HEX 필드 덮어쓰기)
+//
+// 전화번호/IMEI/CPUID/상수 필드를 포함한 JSON 페이로드를 begin()에서 한 번 만들고,
+// 발행할 때는 변하는 고정 폭 HEX 필드만 제자리에 덮어쓴다.
+// 체크섬(zz 문자 합, 1 byte)은 바뀐 문자만큼 증감해 갱신한다 - snprintf/동적 할당 없음.
+// 부호 있는 온도/습도 필드는 기존 "%04X" + (int) 출력과 같게 음수면 32비트 8자리로 늘어난다
+// (예: -20.0℃ → "FFFFFF38"). 폭이 바뀌면 뒤쪽을 밀고 이후 필드 위치를 옮긴다.
+// MQTT Task 전용.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../typedef.h"
+
+#define TELEMETRY_FRAME_LEN   256
+
+class TelemetryFrame {
+public:
+  void begin(const char* cpuid, uint16_t fwVersion);
+  // 실시간 프레임: 내부 버퍼 포인터 반환 ({"idx":0,"zz":"...CS"})
+  const char* build(const TELEMETRY_SAMPLE& s, size_t& len);
+  // 보관분: age 키를 붙여 out에 복사 (age < 0: 알 수 없음)
+  size_t buildAged(const TELEMETRY_SAMPLE& s, long age_s, char* out, size_t outSize);
+
+private:
+  enum Field : uint8_t {
+    F_FAN_CURRENT = 0,
+    F_REMAINING,
+    F_RELAY,
+    F_NTC_TEMP,
+    F_SHT30_TEMP,
+    F_HUMIDITY,
+    F_SELJUNG_TEMP,
+    F_CHECKSUM,
+    F_COUNT
+  };
+
+  void append(const char* s);
+  void appendHex(uint16_t value, uint8_t width);
+  void appendField(Field f, uint8_t width);
+  void patch(Field f, uint32_t value, uint8_t width);
+  void patchSigned(Field f, int16_t value);
+
+  char _buf[TELEMETRY_FRAME_LEN];
+  uint16_t _len = 0;
+  uint16_t _zzStart = 0;              // zz 문자열 시작 (체크섬 범위)
+  uint16_t _off[F_COUNT] = {0};       // 필드 위치
+  uint8_t _width[F_COUNT] = {0};      // 필드 폭 (HEX 자릿수)
+  uint8_t _sum = 0;                   // zz 문자 합 (체크섬 제외)
+};
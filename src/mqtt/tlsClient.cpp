@@ -0,0 +1,329 @@
+// tlsClient.cpp - 인증서 파싱 결과를 유지하고 TLS 세션을 재개하는 mbedTLS Client 구현
+
+#include "tlsClient.h"
+#include "mbedtls/version.h"
+#include "mbedtls/net_sockets.h"
+
+// mbedTLS 3.x는 세션 구조체 필드가 private
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define TLS_SESSION_FIELD(s, f) ((s).MBEDTLS_PRIVATE(f))
+#else
+#define TLS_SESSION_FIELD(s, f) ((s).f)
+#endif
+
+static const char TLS_DRBG_PERS[] = "dryer-tls";
+
+TLSClient::TLSClient() {
+  mbedtls_entropy_init(&_entropy);
+  mbedtls_ctr_drbg_init(&_drbg);
+  mbedtls_x509_crt_init(&_ca);
+  mbedtls_x509_crt_init(&_cert);
+  mbedtls_pk_init(&_key);
+  mbedtls_ssl_config_init(&_conf);
+  mbedtls_ssl_init(&_ssl);
+  mbedtls_ssl_session_init(&_session);
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+TLSClient::~TLSClient() {
+  stop();
+  mbedtls_ssl_session_free(&_session);
+  mbedtls_ssl_config_free(&_conf);
+  mbedtls_pk_free(&_key);
+  mbedtls_x509_crt_free(&_cert);
+  mbedtls_x509_crt_free(&_ca);
+  mbedtls_ctr_drbg_free(&_drbg);
+  mbedtls_entropy_free(&_entropy);
+}
+
+bool TLSClient::begin(const char* caPem, const char* certPem, const char* keyPem) {
+  if (_ready) return true;
+
+  uint32_t t0 = millis();
+  int ret = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                  (const unsigned char*)TLS_DRBG_PERS, sizeof(TLS_DRBG_PERS) - 1);
+  if (ret != 0) {
+    Serial.printf("[TLS] DRBG seed failed: -0x%04X\n", -ret);
+    return false;
+  }
+
+  // PEM 파싱은 여기서 한 번만 (길이에 NUL 포함)
+  ret = mbedtls_x509_crt_parse(&_ca, (const unsigned char*)caPem, strlen(caPem) + 1);
+  if (ret != 0) {
+    Serial.printf("[TLS] CA parse failed: -0x%04X\n", -ret);
+    return false;
+  }
+  ret = mbedtls_x509_crt_parse(&_cert, (const unsigned char*)certPem, strlen(certPem) + 1);
+  if (ret != 0) {
+    Serial.printf("[TLS] Certificate parse failed: -0x%04X\n", -ret);
+    return false;
+  }
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+  ret = mbedtls_pk_parse_key(&_key, (const unsigned char*)keyPem, strlen(keyPem) + 1, NULL, 0,
+                             mbedtls_ctr_drbg_random, &_drbg);
+#else
+  ret = mbedtls_pk_parse_key(&_key, (const unsigned char*)keyPem, strlen(keyPem) + 1, NULL, 0);
+#endif
+  if (ret != 0) {
+    Serial.printf("[TLS] Private key parse failed: -0x%04X\n", -ret);
+    return false;
+  }
+
+  ret = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT,
+                                    MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+  if (ret != 0) {
+    Serial.printf("[TLS] Config failed: -0x%04X\n", -ret);
+    return false;
+  }
+  mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+  mbedtls_ssl_conf_ca_chain(&_conf, &_ca, NULL);
+  mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+  ret = mbedtls_ssl_conf_own_cert(&_conf, &_cert, &_key);
+  if (ret != 0) {
+    Serial.printf("[TLS] Own cert failed: -0x%04X\n", -ret);
+    return false;
+  }
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  mbedtls_ssl_conf_session_tickets(&_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+  _ready = true;
+  Serial.printf("[TLS] Credentials parsed once (%lu ms)\n", (unsigned long)(millis() - t0));
+  return true;
+}
+
+void TLSClient::clearSession() {
+  mbedtls_ssl_session_free(&_session);
+  mbedtls_ssl_session_init(&_session);
+  _sessionValid = false;
+}
+
+// ========== mbedTLS BIO (WiFiClient 위에서 동작) ==========
+int TLSClient::bioSend(void* ctx, const unsigned char* buf, size_t len) {
+  TLSClient* self = static_cast<TLSClient*>(ctx);
+  if (!self->_tcp.connected()) return MBEDTLS_ERR_NET_CONN_RESET;
+  size_t n = self->_tcp.write(buf, len);
+  if (n == 0) return MBEDTLS_ERR_NET_SEND_FAILED;
+  return (int)n;
+}
+
+int TLSClient::bioRecv(void* ctx, unsigned char* buf, size_t len) {
+  TLSClient* self = static_cast<TLSClient*>(ctx);
+  int avail = self->_tcp.available();
+  if (avail <= 0) {
+    if (!self->_tcp.connected()) return MBEDTLS_ERR_NET_CONN_RESET;
+    return MBEDTLS_ERR_SSL_WANT_READ;
+  }
+  int n = self->_tcp.read(buf, len);
+  return (n > 0) ? n : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+// ========== 연결 ==========
+int TLSClient::connect(IPAddress ip, uint16_t port) {
+  if (!_ready) return 0;
+  stop();
+
+  uint32_t t0 = millis();
+  if (!_tcp.connect(ip, port)) {
+    _stats.failures++;
+    return 0;
+  }
+  _stats.last_tcp_ms = millis() - t0;
+  return startTls(nullptr);
+}
+
+int TLSClient::connect(const char* host, uint16_t port) {
+  if (!_ready) return 0;
+  stop();
+
+  uint32_t t0 = millis();
+  if (!_tcp.connect(host, port)) {
+    _stats.failures++;
+    Serial.printf("[TLS] TCP connect to %s:%u failed\n", host, port);
+    return 0;
+  }
+  _stats.last_tcp_ms = millis() - t0;
+  return startTls(host);
+}
+
+int TLSClient::startTls(const char* host) {
+  _tcp.setNoDelay(true);
+
+  mbedtls_ssl_init(&_ssl);
+  int ret = mbedtls_ssl_setup(&_ssl, &_conf);
+  if (ret == 0 && host) ret = mbedtls_ssl_set_hostname(&_ssl, host);
+  if (ret != 0) {
+    _stats.failures++;
+    _stats.last_error = ret;
+    mbedtls_ssl_free(&_ssl);
+    _tcp.stop();
+    return 0;
+  }
+  mbedtls_ssl_set_bio(&_ssl, this, bioSend, bioRecv, NULL);
+  _sslActive = true;
+
+  // 이전 세션 제시 (서버가 수락하면 인증서 검증/키 교환 생략)
+  bool offered = false;
+  if (_sessionValid && mbedtls_ssl_set_session(&_ssl, &_session) == 0) {
+    offered = true;
+  }
+
+  uint32_t t0 = millis();
+  uint32_t heapStart = ESP.getFreeHeap();
+  uint32_t heapMin = heapStart;
+  while ((ret = mbedtls_ssl_handshake(&_ssl)) != 0) {
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+    uint32_t heapNow = ESP.getFreeHeap();
+    if (heapNow < heapMin) heapMin = heapNow;
+    if (millis() - t0 > _handshakeTimeout) {
+      ret = MBEDTLS_ERR_SSL_TIMEOUT;
+      break;
+    }
+    vTaskDelay(1);
+  }
+  uint32_t heapNow = ESP.getFreeHeap();
+  if (heapNow < heapMin) heapMin = heapNow;
+  _stats.last_handshake_ms = millis() - t0;
+  _stats.last_heap_peak = heapStart - heapMin;
+
+  if (ret == 0 && mbedtls_ssl_get_verify_result(&_ssl) != 0) {
+    ret = MBEDTLS_ERR_X509_CERT_VERIFY_FAILED;
+  }
+  if (ret != 0) {
+    _stats.failures++;
+    _stats.last_error = ret;
+    Serial.printf("[TLS] Handshake failed: -0x%04X (%lu ms)\n", -ret, (unsigned long)_stats.last_handshake_ms);
+    if (offered) clearSession();  // 재개 실패가 반복되지 않도록 다음은 전체 핸드셰이크
+    freeSsl();
+    _tcp.stop();
+    return 0;
+  }
+
+  // 세션 재개 여부: 제시한 세션 ID를 서버가 그대로 돌려주면 재개
+  mbedtls_ssl_session fresh;
+  mbedtls_ssl_session_init(&fresh);
+  bool resumed = false;
+  if (mbedtls_ssl_get_session(&_ssl, &fresh) == 0) {
+    size_t idLen = TLS_SESSION_FIELD(fresh, id_len);
+    resumed = offered && idLen > 0 && idLen == TLS_SESSION_FIELD(_session, id_len) &&
+              memcmp(TLS_SESSION_FIELD(fresh, id), TLS_SESSION_FIELD(_session, id), idLen) == 0;
+    mbedtls_ssl_session_free(&_session);
+    _session = fresh;  // 소유권 이전 (fresh는 해제하지 않음)
+    _sessionValid = true;
+  } else {
+    mbedtls_ssl_session_free(&fresh);
+  }
+
+  _stats.connects++;
+  if (resumed) _stats.resumed++;
+  _stats.last_resumed = resumed;
+  _stats.last_error = 0;
+  Serial.printf("[TLS] Handshake %s: tcp %lu ms, tls %lu ms, heap peak %lu bytes\n",
+                resumed ? "resumed" : "full",
+                (unsigned long)_stats.last_tcp_ms, (unsigned long)_stats.last_handshake_ms,
+                (unsigned long)_stats.last_heap_peak);
+  return 1;
+}
+
+void TLSClient::freeSsl() {
+  if (_sslActive) {
+    mbedtls_ssl_free(&_ssl);
+    _sslActive = false;
+  }
+  _peek = -1;
+}
+
+void TLSClient::stop() {
+  if (_sslActive && _tcp.connected()) {
+    mbedtls_ssl_close_notify(&_ssl);
+  }
+  freeSsl();
+  _tcp.stop();
+}
+
+// ========== 송수신 ==========
+size_t TLSClient::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t TLSClient::write(const uint8_t* buf, size_t size) {
+  if (!_sslActive) return 0;
+  size_t sent = 0;
+  uint32_t t0 = millis();
+  while (sent < size) {
+    int ret = mbedtls_ssl_write(&_ssl, buf + sent, size - sent);
+    if (ret > 0) {
+      sent += ret;
+      continue;
+    }
+    if ((ret != MBEDTLS_ERR_SSL_WANT_WRITE && ret != MBEDTLS_ERR_SSL_WANT_READ) ||
+        millis() - t0 > _handshakeTimeout) {
+      _stats.last_error = ret;
+      stop();
+      return sent;
+    }
+    vTaskDelay(1);
+  }
+  return sent;
+}
+
+int TLSClient::available() {
+  if (!_sslActive) return 0;
+  int n = (int)mbedtls_ssl_get_bytes_avail(&_ssl);
+  if (n == 0) {
+    // 수신 레코드가 있으면 복호화해서 버퍼에 올림
+    int ret = mbedtls_ssl_read(&_ssl, NULL, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      _stats.last_error = ret;
+      stop();
+      return 0;
+    }
+    n = (int)mbedtls_ssl_get_bytes_avail(&_ssl);
+  }
+  return n + (_peek >= 0 ? 1 : 0);
+}
+
+int TLSClient::read() {
+  uint8_t b;
+  return (read(&b, 1) == 1) ? b : -1;
+}
+
+int TLSClient::read(uint8_t* buf, size_t size) {
+  if (!_sslActive || size == 0) return -1;
+  int got = 0;
+  if (_peek >= 0) {
+    buf[got++] = (uint8_t)_peek;
+    _peek = -1;
+  }
+  if ((size_t)got < size) {
+    int ret = mbedtls_ssl_read(&_ssl, buf + got, size - got);
+    if (ret > 0) {
+      got += ret;
+    } else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      _stats.last_error = ret;
+      stop();
+    }
+  }
+  if (got > 0 && _rxTap) _rxTap(buf, got, _rxTapArg);
+  return got > 0 ? got : -1;
+}
+
+int TLSClient::peek() {
+  if (_peek < 0) {
+    uint8_t b;
+    if (_sslActive && mbedtls_ssl_read(&_ssl, &b, 1) == 1) {
+      _peek = b;
+    }
+  }
+  return _peek;
+}
+
+void TLSClient::flush() {
+  // mbedtls_ssl_write()가 레코드 단위로 바로 전송하므로 추가 처리 없음
+}
+
+uint8_t TLSClient::connected() {
+  if (!_sslActive) return 0;
+  if (_tcp.connected()) return 1;
+  return (mbedtls_ssl_get_bytes_avail(&_ssl) > 0 || _peek >= 0) ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+// tlsClient.h - 인증서 파싱 결과를 유지하고 TLS 세션을 재개하는 mbedTLS Client
+//
+// WiFiClientSecure는 연결할 때마다 PEM 인증서/키를 다시 파싱하고 전체 핸드셰이크를 수행한다.
+// TLSClient는 CA/인증서/키/설정/DRBG를 begin()에서 한 번만 준비하고,
+// 마지막 세션(세션 ID 또는 세션 티켓)을 보관해 재연결 시 약식 핸드셰이크를 시도한다.
+
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+#include <WiFiClient.h>
+#include "mbedtls/ssl.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+
+// 연결별 TLS 측정값
+typedef struct {
+  uint32_t connects;          // 핸드셰이크 성공 횟수
+  uint32_t resumed;           // 그중 세션 재개 횟수
+  uint32_t failures;          // TCP/핸드셰이크 실패 횟수
+  uint32_t last_tcp_ms;       // 마지막 TCP 연결 시간
+  uint32_t last_handshake_ms; // 마지막 TLS 핸드셰이크 시간
+  uint32_t last_heap_peak;    // 마지막 핸드셰이크 중 최대 힙 사용량 (bytes)
+  int32_t last_error;         // 마지막 mbedTLS 에러 코드 (0 = 없음)
+  bool last_resumed;          // 마지막 연결이 세션 재개였는지
+} TLS_STATS;
+
+// 복호화된 수신 바이트 관찰 콜백 (PubSubClient가 버리는 PUBACK 추적용)
+typedef void (*TLSRxTap)(const uint8_t* data, size_t len, void* arg);
+
+class TLSClient : public Client {
+public:
+  TLSClient();
+  ~TLSClient();
+
+  // CA/클라이언트 인증서/개인키 파싱 (프로세스 수명 동안 유지)
+  bool begin(const char* caPem, const char* certPem, const char* keyPem);
+  void setHandshakeTimeout(uint32_t ms) { _handshakeTimeout = ms; }
+  void clearSession();                   // 다음 연결은 전체 핸드셰이크
+  const TLS_STATS& stats() const { return _stats; }
+  void setRxTap(TLSRxTap tap, void* arg) { _rxTap = tap; _rxTapArg = arg; }
+
+  // Client 인터페이스 (PubSubClient에서 사용)
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size) override;
+  int peek() override;
+  void flush() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+
+private:
+  static int bioSend(void* ctx, const unsigned char* buf, size_t len);
+  static int bioRecv(void* ctx, unsigned char* buf, size_t len);
+  int startTls(const char* host);
+  void freeSsl();
+
+  WiFiClient _tcp;
+  mbedtls_entropy_context _entropy;
+  mbedtls_ctr_drbg_context _drbg;
+  mbedtls_x509_crt _ca;
+  mbedtls_x509_crt _cert;
+  mbedtls_pk_context _key;
+  mbedtls_ssl_config _conf;
+  mbedtls_ssl_context _ssl;
+  mbedtls_ssl_session _session;       // 재개용 마지막 세션
+
+  bool _ready = false;                // 인증서/설정 준비 완료
+  bool _sslActive = false;            // _ssl 사용 중
+  bool _sessionValid = false;         // _session 재개 가능
+  int _peek = -1;
+  uint32_t _handshakeTimeout = 10000;
+  TLSRxTap _rxTap = nullptr;
+  void* _rxTapArg = nullptr;
+  TLS_STATS _stats;
+};
@@ -0,0 +1,109 @@
+// profiler.cpp - 구간 시간 log2 히스토그램, 틱 데드라인, Task 점유율
+
+#include "profiler.h"
+
+#if ENABLE_PROFILER
+
+#include "esp_timer.h"
+
+Profiler gProf;
+
+static const char* const SECTION_NAMES[PROF_SECTION_COUNT] = {
+  "tick", "loop", "ctrl", "ota", "wifi", "pub", "key", "disp", "mqtt"
+};
+
+void Profiler::begin() {
+  _cpuMHz = getCpuFrequencyMhz();
+  reset();
+  Serial.printf("[Prof] Enabled (%lu MHz, %u buckets)\n", (unsigned long)_cpuMHz, PROFILER_BUCKETS);
+}
+
+void Profiler::reset() {
+  memset(_sec, 0, sizeof(_sec));
+  _ticks = 0;
+  _lost = 0;
+  _late = 0;
+  _startUs = esp_timer_get_time();
+}
+
+void Profiler::record(PROF_SECTION sec, uint32_t cycleDelta) {
+  uint32_t us = cycleDelta / _cpuMHz;
+  PROF_HIST& h = _sec[sec];
+  uint8_t b = us ? (32 - __builtin_clz(us)) : 0;
+  if (b >= PROFILER_BUCKETS) b = PROFILER_BUCKETS - 1;
+  h.hist[b]++;
+  h.count++;
+  h.total_us += us;
+  if (us > h.max_us) h.max_us = us;
+}
+
+// 인터럽트 핸들러에서 호출 (timerMux 안)
+void IRAM_ATTR Profiler::markTick() {
+  if (_tickPending) _lost++;  // 이전 틱을 아직 처리하지 못함
+  _tickStamp = cycles();
+  _tickPending = true;
+  _ticks++;
+}
+
+void Profiler::tickHandled() {
+  if (!_tickPending) return;
+  uint32_t delta = cycles() - _tickStamp;
+  _tickPending = false;
+  record(PROF_TICK_LATENCY, delta);
+  if (delta / _cpuMHz > PROFILER_TICK_DEADLINE_US) _late++;
+}
+
+// {"idx":4,"sec":"sum","s":경과초,"tick":[틱,lost,late],"busy":[loop%,ui%,mqtt%]} (점유율 x10)
+size_t Profiler::formatSummary(char* buf, size_t size) {
+  uint64_t elapsed = (uint64_t)(esp_timer_get_time() - _startUs);
+  if (elapsed == 0) elapsed = 1;
+  uint32_t loop = (uint32_t)(_sec[PROF_LOOP].total_us * 1000 / elapsed);
+  uint32_t ui = (uint32_t)((_sec[PROF_KEY].total_us + _sec[PROF_DISPLAY].total_us) * 1000 / elapsed);
+  uint32_t mqtt = (uint32_t)(_sec[PROF_MQTT_LOOP].total_us * 1000 / elapsed);
+  int n = snprintf(buf, size,
+    "{\"idx\":4,\"sec\":\"sum\",\"s\":%lu,\"tick\":[%lu,%lu,%lu],\"busy\":[%lu,%lu,%lu]}",
+    (unsigned long)(elapsed / 1000000ULL),
+    (unsigned long)_ticks, (unsigned long)_lost, (unsigned long)_late,
+    (unsigned long)loop, (unsigned long)ui, (unsigned long)mqtt);
+  return (n > 0 && (size_t)n < size) ? n : 0;
+}
+
+// {"idx":4,"sec":"이름","n":횟수,"avg":us,"max":us,"h":[버킷...]}
+size_t Profiler::formatSection(uint8_t sec, char* buf, size_t size) {
+  if (sec >= PROF_SECTION_COUNT) return 0;
+  const PROF_HIST& h = _sec[sec];
+  int n = snprintf(buf, size, "{\"idx\":4,\"sec\":\"%s\",\"n\":%lu,\"avg\":%lu,\"max\":%lu,\"h\":[",
+                   SECTION_NAMES[sec], (unsigned long)h.count,
+                   (unsigned long)(h.count ? h.total_us / h.count : 0), (unsigned long)h.max_us);
+  if (n < 0 || (size_t)n >= size) return 0;
+  size_t len = n;
+  for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+    n = snprintf(buf + len, size - len, b ? ",%lu" : "%lu", (unsigned long)h.hist[b]);
+    if (n < 0 || (size_t)n >= size - len) return 0;
+    len += n;
+  }
+  if (len + 3 > size) return 0;
+  buf[len++] = ']';
+  buf[len++] = '}';
+  buf[len] = '\0';
+  return len;
+}
+
+void Profiler::print() {
+  char line[MQTT_PAYLOAD_MAX];
+  if (formatSummary(line, sizeof(line))) Serial.printf("[Prof] %s\n", line);
+  for (uint8_t s = 0; s < PROF_SECTION_COUNT; s++) {
+    const PROF_HIST& h = _sec[s];
+    if (h.count == 0) continue;
+    Serial.printf("[Prof] %-5s n=%-8lu avg=%-7lu max=%-7lu us |", SECTION_NAMES[s], (unsigned long)h.count,
+                  (unsigned long)(h.total_us / h.count), (unsigned long)h.max_us);
+    for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+      if (h.hist[b] == 0) continue;
+      if (b == PROFILER_BUCKETS - 1) Serial.printf(" >=%lu:%lu", 1UL << (b - 1), (unsigned long)h.hist[b]);
+      else Serial.printf(" <%lu:%lu", 1UL << b, (unsigned long)h.hist[b]);
+    }
+    Serial.println();
+  }
+}
+
+#endif
@@ -0,0 +1,77 @@
+// profiler.h - 제어 루프 지연/구간 시간 계측 (CPU 사이클 카운터 기반)
+//
+// ENABLE_PROFILER=0이면 PROF_* 매크로와 ISR 훅이 모두 사라진다 (코드/RAM 0).
+//  - 틱 지연: 1초 인터럽트 → loop()의 onSecondElapsed() 직전까지
+//  - 구간 시간: loop() 각 단계, UI Task(key/display), MQTT Task(loop/service)
+//  - 데드라인: 처리 전에 다음 틱이 온 경우(lost), 지연이 PROFILER_TICK_DEADLINE_US 초과(late)
+//  - Task 점유율: 계측 구간 누적 시간 / 경과 시간
+// 각 구간은 한 Task만 기록하므로 잠금 없음 (보고 시 약간 어긋난 값은 허용).
+// 사이클 카운터는 코어별이므로 한 구간의 시작/끝은 같은 Task(같은 코어)에서 측정한다.
+
+#pragma once
+
+#include <Arduino.h>
+#include "../config.h"
+
+// 계측 구간
+typedef enum {
+  PROF_TICK_LATENCY = 0,  // 1초 인터럽트 → 제어 틱 처리 시작
+  PROF_LOOP,              // loop() 1회 (delay 제외)
+  PROF_CONTROL_TICK,      // flag_1sec 처리 (명령/제어/알람/업로드/RTC)
+  PROF_OTA,               // ArduinoOTA.handle()
+  PROF_WIFI,              // gWiFi.loop()
+  PROF_PUBLISH,           // publishIfDue()
+  PROF_KEY,               // UI Task: key_process()
+  PROF_DISPLAY,           // UI Task: sendToDisplay()
+  PROF_MQTT_LOOP,         // MQTT Task: PubSubClient loop + 송신함 service
+  PROF_SECTION_COUNT
+} PROF_SECTION;
+
+#if ENABLE_PROFILER
+
+// log2 히스토그램: 버킷 b = 마이크로초 값의 비트 수 (0: 0us, 1: 1us, 2: 2~3us, ... 마지막: 그 이상)
+typedef struct {
+  uint32_t count;
+  uint32_t max_us;
+  uint64_t total_us;
+  uint32_t hist[PROFILER_BUCKETS];
+} PROF_HIST;
+
+class Profiler {
+public:
+  void begin();
+  void reset();
+  static inline uint32_t cycles() { return ESP.getCycleCount(); }
+  void record(PROF_SECTION sec, uint32_t cycleDelta);
+  void markTick();                         // ISR: 틱 발생 (flag_1sec 설정 직전)
+  void tickHandled();                      // loop(): 틱 처리 시작
+  size_t formatSummary(char* buf, size_t size);
+  size_t formatSection(uint8_t sec, char* buf, size_t size);
+  void print();
+
+private:
+  PROF_HIST _sec[PROF_SECTION_COUNT];
+  volatile uint32_t _tickStamp = 0;        // ISR에서 기록한 사이클
+  volatile bool _tickPending = false;
+  volatile uint32_t _ticks = 0;
+  volatile uint32_t _lost = 0;             // 처리 전에 다음 틱 도착
+  uint32_t _late = 0;                      // 지연 > PROFILER_TICK_DEADLINE_US
+  uint32_t _cpuMHz = 240;
+  int64_t _startUs = 0;                    // 통계 시작 시각 (esp_timer)
+};
+
+extern Profiler gProf;
+
+#define PROF_BEGIN(var)         uint32_t var = Profiler::cycles()
+#define PROF_END(sec, var)      gProf.record(sec, Profiler::cycles() - (var))
+#define PROF_TICK_ISR()         gProf.markTick()
+#define PROF_TICK_HANDLED()     gProf.tickHandled()
+
+#else
+
+#define PROF_BEGIN(var)
+#define PROF_END(sec, var)
+#define PROF_TICK_ISR()
+#define PROF_TICK_HANDLED()
+
+#endif
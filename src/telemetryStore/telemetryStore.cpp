@@ -0,0 +1,214 @@
+// telemetryStore.cpp - 오프라인 구간 텔레메트리/이벤트 보관 구현
+
+#include "telemetryStore.h"
+#include "esp_heap_caps.h"
+#include "../memPool/memPool.h"
+#if TELEMETRY_STORE_SPILL
+#include <SPIFFS.h>
+#endif
+
+TelemetryStore gTelemetryStore;
+
+#define SPILL_FILE "/tlm_spill.bin"
+#define SPILL_MAGIC   0x544C4D53UL   // "TLMS"
+#define SPILL_VERSION 1              // MQTT_TX_ITEM 배치/헤더 의미가 바뀌면 올림
+
+// 스필 파일 헤더 - 읽기 위치를 함께 저장해서 비우는 도중 재부팅해도 이미 발행한 항목을 다시 보내지 않음
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t item_size;          // sizeof(MQTT_TX_ITEM) - 구조체가 바뀐 빌드의 파일은 버림
+  uint32_t read_pos;           // 다음 읽기 위치 (파일 시작 기준 bytes)
+} SPILL_HDR;
+
+void TelemetryStore::begin() {
+  if (_ring) return;
+
+  // PSRAM 우선 (MEM_BULK), PSRAM이 없으면 내부 RAM에 작은 링
+  _capacity = TELEMETRY_STORE_LEN;
+  _ring = (MQTT_TX_ITEM*)heap_caps_malloc(_capacity * sizeof(MQTT_TX_ITEM), MALLOC_CAP_SPIRAM);
+  _stats.psram = (_ring != nullptr);
+  if (_ring == nullptr) {
+    _capacity = TELEMETRY_STORE_LEN_NO_PSRAM;
+    _ring = (MQTT_TX_ITEM*)gMem.alloc(_capacity * sizeof(MQTT_TX_ITEM), MEM_FAST);
+    if (_ring == nullptr) {
+      _capacity = 0;
+      Serial.println("[Store] Allocation failed - offline samples will be dropped");
+      return;
+    }
+  }
+  _stats.capacity = _capacity;
+
+#if TELEMETRY_STORE_SPILL
+  // 이전 부팅에서 남은 항목은 그대로 이어서 발행
+  if (SPIFFS.begin(true)) {
+    _spillReady = true;
+    File f = SPIFFS.open(SPILL_FILE, FILE_READ);
+    if (f) {
+      SPILL_HDR hdr;
+      size_t size = f.size();
+      bool ok = f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+                hdr.magic == SPILL_MAGIC && hdr.version == SPILL_VERSION &&
+                hdr.item_size == sizeof(MQTT_TX_ITEM) &&
+                hdr.read_pos >= sizeof(hdr) && hdr.read_pos <= size &&
+                (hdr.read_pos - sizeof(hdr)) % sizeof(MQTT_TX_ITEM) == 0;
+      f.close();
+      if (ok) {
+        _spillReadPos = hdr.read_pos;
+        _spillCount = (size - hdr.read_pos) / sizeof(MQTT_TX_ITEM);
+        _staleSpill = _spillCount;
+      }
+      if (!ok || _spillCount == 0) {
+        if (!ok) Serial.println("[Store] Spill file from other version - discarded");
+        _spillReadPos = 0;
+        _spillCount = 0;
+        _staleSpill = 0;
+        SPIFFS.remove(SPILL_FILE);
+      }
+    }
+  } else {
+    Serial.println("[Store] SPIFFS mount failed - spill disabled");
+  }
+#endif
+
+  Serial.printf("[Store] Ring %lu items in %s, spill %s (%lu pending)\n",
+                (unsigned long)_capacity, _stats.psram ? "PSRAM" : "internal RAM",
+                _spillReady ? "on" : "off", (unsigned long)_spillCount);
+}
+
+bool TelemetryStore::push(const MQTT_TX_ITEM& item) {
+  if (_capacity == 0) {
+    _stats.dropped++;
+    return false;
+  }
+
+  if (_count == _capacity) {
+    // 가장 오래된 항목을 플래시로 내보내거나 버림
+    if (!spillOldest()) {
+      _stats.dropped++;
+      Serial.printf("[Store] Full, dropped oldest (total %lu)\n", (unsigned long)_stats.dropped);
+    }
+    _head = (_head + 1) % _capacity;
+    _count--;
+  }
+
+  _ring[(_head + _count) % _capacity] = item;
+  _count++;
+  _stats.stored++;
+  return true;
+}
+
+bool TelemetryStore::spillOldest() {
+#if TELEMETRY_STORE_SPILL
+  if (!_spillReady) return false;
+  uint32_t fileStart = _spillReadPos ? _spillReadPos : sizeof(SPILL_HDR);  // 읽기 위치는 헤더를 포함
+  if ((uint64_t)(_spillCount + 1) * sizeof(MQTT_TX_ITEM) + fileStart > TELEMETRY_SPILL_MAX_BYTES) {
+    return false;
+  }
+  if (_spillReadPos == 0) {
+    // 새 파일 - 헤더부터
+    _spillReadPos = sizeof(SPILL_HDR);
+    if (!writeSpillHeader(FILE_WRITE)) {
+      _spillReadPos = 0;
+      return false;
+    }
+  }
+  File f = SPIFFS.open(SPILL_FILE, FILE_APPEND);
+  if (!f) return false;
+  size_t n = f.write((const uint8_t*)&_ring[_head], sizeof(MQTT_TX_ITEM));
+  f.close();
+  if (n != sizeof(MQTT_TX_ITEM)) return false;
+  _spillCount++;
+  _stats.spilled++;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// 헤더 기록 (mode: 새 파일은 FILE_WRITE, 읽기 위치 갱신은 "r+"로 제자리 덮어쓰기)
+bool TelemetryStore::writeSpillHeader(const char* mode) {
+#if TELEMETRY_STORE_SPILL
+  SPILL_HDR hdr = { SPILL_MAGIC, SPILL_VERSION, (uint16_t)sizeof(MQTT_TX_ITEM), _spillReadPos };
+  File f = SPIFFS.open(SPILL_FILE, mode);
+  if (!f) return false;
+  bool ok = f.seek(0) && f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+  f.close();
+  return ok;
+#else
+  (void)mode;
+  return false;
+#endif
+}
+
+bool TelemetryStore::readSpill(MQTT_TX_ITEM& item) {
+#if TELEMETRY_STORE_SPILL
+  File f = SPIFFS.open(SPILL_FILE, FILE_READ);
+  if (!f) return false;
+  bool ok = f.seek(_spillReadPos) && f.read((uint8_t*)&item, sizeof(item)) == sizeof(item);
+  f.close();
+  return ok;
+#else
+  (void)item;
+  return false;
+#endif
+}
+
+// 플래시 쪽이 항상 RAM 링보다 오래된 항목
+bool TelemetryStore::peek(MQTT_TX_ITEM& item) {
+  if (_spillCount > 0) {
+    if (readSpill(item)) {
+      if (_staleSpill > 0) item.queued_ms = 0;  // 이전 부팅의 millis는 의미 없음
+      _peekFromSpill = true;
+      return true;
+    }
+    // 파일 손상 - 남은 플래시 항목은 포기
+    _stats.dropped += _spillCount;
+    _spillCount = 0;
+    _staleSpill = 0;
+    _spillReadPos = 0;
+#if TELEMETRY_STORE_SPILL
+    SPIFFS.remove(SPILL_FILE);
+#endif
+  }
+  if (_count == 0) return false;
+  item = _ring[_head];
+  _peekFromSpill = false;
+  return true;
+}
+
+void TelemetryStore::pop() {
+  if (removeHead()) _stats.flushed++;
+}
+
+void TelemetryStore::drop() {
+  if (removeHead()) _stats.dropped++;
+}
+
+bool TelemetryStore::removeHead() {
+  if (_peekFromSpill) {
+    if (_spillCount == 0) return false;
+    _spillCount--;
+    if (_staleSpill > 0) _staleSpill--;
+    _spillReadPos += sizeof(MQTT_TX_ITEM);
+    if (_spillCount == 0) {
+      _spillReadPos = 0;
+#if TELEMETRY_STORE_SPILL
+      SPIFFS.remove(SPILL_FILE);
+#endif
+    } else if (!writeSpillHeader("r+")) {
+      Serial.println("[Store] Spill header update failed");
+    }
+  } else {
+    if (_count == 0) return false;
+    _head = (_head + 1) % _capacity;
+    _count--;
+  }
+  _peekFromSpill = false;
+  return true;
+}
+
+const TELEMETRY_STORE_STATS& TelemetryStore::stats() {
+  _stats.depth = depth();
+  return _stats;
+}
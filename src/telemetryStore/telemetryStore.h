@@ -0,0 +1,58 @@
+// telemetryStore.h - 오프라인 구간 텔레메트리/이벤트 보관 (store-and-forward)
+//
+// WiFi/MQTT가 끊긴 동안 송신 큐 항목을 PSRAM 링 버퍼에 보관하고,
+// 링이 가득 차면 가장 오래된 항목을 SPIFFS 파일로 내보낸다 (TELEMETRY_STORE_SPILL).
+// 스필 파일은 버전/항목 크기/읽기 위치 헤더를 가지며, 다른 빌드의 파일은 부팅 시 버린다.
+// 재연결 후 MQTT Task가 속도 제한을 두고 오래된 것부터 꺼내 발행한다.
+// MQTT Task 전용 (잠금 없음).
+
+#pragma once
+
+#include <Arduino.h>
+#include "../config.h"
+#include "../mqtt/mqttClient.h"
+
+#define TELEMETRY_AGE_UNKNOWN     0xFFFFFFFFUL  // 이전 부팅에서 보관된 항목 (millis 기준 없음)
+
+// 보관 통계 (진단용)
+typedef struct {
+  uint32_t stored;            // 보관한 항목 수
+  uint32_t flushed;           // 재연결 후 발행한 항목 수
+  uint32_t spilled;           // 플래시로 내보낸 항목 수
+  uint32_t dropped;           // 공간 부족/발행 불가로 버린 항목 수
+  uint32_t depth;             // 현재 보관 중 (RAM + 플래시)
+  uint32_t capacity;          // RAM 링 용량 (항목)
+  bool psram;                 // 링이 PSRAM에 있는지
+} TELEMETRY_STORE_STATS;
+
+class TelemetryStore {
+public:
+  void begin();
+  bool push(const MQTT_TX_ITEM& item);   // 보관 (가득 차면 가장 오래된 것을 플래시로/버림)
+  bool peek(MQTT_TX_ITEM& item);         // 가장 오래된 항목 (꺼내지 않음)
+  void pop();                            // peek()한 항목 제거 (발행 성공 후)
+  void drop();                           // peek()한 항목 버림 (발행 불가 - dropped로 집계)
+  uint32_t depth() const { return _count + _spillCount; }
+  const TELEMETRY_STORE_STATS& stats();
+
+private:
+  bool removeHead();
+  bool spillOldest();
+  bool readSpill(MQTT_TX_ITEM& item);
+  bool writeSpillHeader(const char* mode);
+
+  MQTT_TX_ITEM* _ring = nullptr;
+  uint32_t _capacity = 0;
+  uint32_t _head = 0;
+  uint32_t _count = 0;
+
+  bool _spillReady = false;
+  uint32_t _spillCount = 0;              // 파일에 남은 항목 수
+  uint32_t _spillReadPos = 0;            // 다음 읽기 위치 (bytes, 0 = 파일 없음) - 파일 헤더에도 저장
+  uint32_t _staleSpill = 0;              // 이전 부팅에서 남은 항목 수 (age 알 수 없음)
+  bool _peekFromSpill = false;
+
+  TELEMETRY_STORE_STATS _stats = {};
+};
+
+extern TelemetryStore gTelemetryStore;
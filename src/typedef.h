@@ -149,4 +149,48 @@ typedef struct
   DRY_STATE dry_state;        // 건조기 상태 (DRY_RUN, DRY_COOL, DRY_FINISH)
   char mqtt_recv_id[16];      // MQTT로 받은 ID 문자열
   unsigned long mqtt_recv_time; // MQTT ID 수신 시간
-}CURRENT_DATA;
\ No newline at end of file
+}CURRENT_DATA;
+
+// RTC slow memory 웜 리스타트 상태 (소프트웨어 리셋/WDT 리셋 시 유지, 전원 OFF 시 소실)
+#define RTC_STATE_MAGIC   0x44525931UL  // "DRY1"
+#define RTC_STATE_VERSION 1
+
+typedef struct
+{
+  uint32_t magic;             // RTC_STATE_MAGIC
+  uint8_t version;            // RTC_STATE_VERSION
+  uint8_t auto_damper;
+  uint8_t soft_off;
+  uint8_t dry_state;          // DRY_STATE
+  int16_t seljung_temp;       // 설정 온도
+  uint16_t remaining_minute;  // 남은 시간(분)
+  uint8_t relay_state;        // 릴레이 상태 (RY1~RY8)
+  uint8_t error_info;         // 에러 정보
+  uint8_t second_counter;     // 분 카운터 진행값 (0~59)
+  uint8_t prepare_seconds;    // DRY_PREPARE 카운트다운
+  float m0_value;             // ADC 지수 이동 평균 필터 상태
+  uint16_t cooling_minutes;   // 냉각 남은 시간(분)
+  uint16_t fan_start_delay;   // 팬 시작 지연 카운터(초)
+  uint16_t fan_error_count;   // 팬 에러 카운터
+  uint8_t cooling_mode;       // 냉각 모드 플래그
+  uint8_t fan_started;        // 팬 시작 플래그
+  uint8_t heater_on;          // 히스테리시스 히터 상태
+  uint8_t reserved[3];
+  uint32_t crc;               // magic ~ reserved 까지 CRC32
+}RTC_STATE;
+
+// 텔레메트리 샘플 (MQTT 전송 큐용 스냅샷 - 생산자 시점의 gCUR 값 고정)
+typedef struct
+{
+  uint32_t uptime_ms;         // 샘플 시각 (millis)
+  uint16_t fan_current;       // 팬 전류
+  uint16_t remaining_minute;  // 남은 시간(분)
+  int16_t ntc_temp_x10;       // 제어 온도 (NTC, x10)
+  int16_t sht30_temp_x10;     // T1 온도 (SHT30, x10)
+  int16_t humidity_x10;       // 습도 (SHT30, x10)
+  int16_t seljung_temp_x10;   // 설정 온도 (x10)
+  uint8_t relay_state;        // 릴레이 상태 (RY1~RY8)
+  uint8_t dry_state;          // DRY_STATE
+  uint8_t error_info;         // 에러 정보
+  uint8_t reserved;
+}TELEMETRY_SAMPLE;
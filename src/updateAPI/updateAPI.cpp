@@ -1,4 +1,10 @@
 #include "updateAPI.h"
+#include "../dataClass/dataClass.h"
+#include "../wifiManager/wifiManager.h"
+#include "../diag/diag.h"
+#include "../binLog/binLog.h"
+
+UpdateAPI gUpdateAPI;
 
 void UpdateAPI::setConfig(const APIConfig& config) {
   process_data_input = config;
@@ -6,9 +12,9 @@ void UpdateAPI::setConfig(const APIConfig& config) {
 }
 
 // JSON에서 record_id 추출 (메모리 효율적인 버전)
-bool UpdateAPI::parseRecordId(const String& response) {
+bool UpdateAPI::parseRecordId(const char* response) {
   // "record_id":1057 형식에서 숫자만 추출
-  const char* ptr = strstr(response.c_str(), "\"record_id\":");
+  const char* ptr = strstr(response, "\"record_id\":");
   if (!ptr) return false;
   
   ptr += 12; // "record_id": 길이 (12자)
@@ -26,55 +32,169 @@ bool UpdateAPI::parseRecordId(const String& response) {
   return (i > 0);
 }
 
+// ========== url-encoded body (미리 할당된 _body에 직접 기록) ==========
+static bool isUnreserved(char c) {
+  return isalnum((unsigned char)c) || c == '-' || c == '_' || c == '.' || c == '~';
+}
+
+bool UpdateAPI::addField(size_t& len, const char* key, const char* value) {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+  size_t n = len;
+  if (n > 0) {
+    if (n + 1 >= sizeof(_body)) return false;
+    _body[n++] = '&';
+  }
+  for (const char* k = key; *k; k++) {
+    if (n + 1 >= sizeof(_body)) return false;
+    _body[n++] = *k;
+  }
+  if (n + 1 >= sizeof(_body)) return false;
+  _body[n++] = '=';
+  for (const char* v = value; *v; v++) {
+    if (isUnreserved(*v)) {
+      if (n + 1 >= sizeof(_body)) return false;
+      _body[n++] = *v;
+    } else {
+      if (n + 3 >= sizeof(_body)) return false;
+      _body[n++] = '%';
+      _body[n++] = HEX_DIGITS[((uint8_t)*v) >> 4];
+      _body[n++] = HEX_DIGITS[((uint8_t)*v) & 0x0F];
+    }
+  }
+  _body[n] = '\0';
+  len = n;
+  return true;
+}
+
+bool UpdateAPI::addField(size_t& len, const char* key, long value) {
+  char num[12];
+  ltoa(value, num, 10);
+  return addField(len, key, num);
+}
+
+// ========== Keep-alive POST ==========
+// HTTPClient::setReuse(true) + 엔드포인트별 WiFiClient 유지: 서버가 keep-alive면 TCP 연결 재사용
+int UpdateAPI::post(APIEndpoint& ep, size_t bodyLen, const char* idemKey) {
+  bool reuse = ep.client.connected();
+  if (!ep.http.begin(ep.client, ep.url)) {
+    Serial.println("[APITask] HTTP begin failed");
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  ep.http.addHeader(process_data_input.securityKey, process_data_input.securityValue);
+  ep.http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+  if (idemKey) ep.http.addHeader(API_IDEMPOTENCY_HEADER, idemKey);
+  static const char* RESPONSE_HEADERS[] = { "Retry-After" };
+  ep.http.collectHeaders(RESPONSE_HEADERS, 1);
+  
+  int code = ep.http.POST((uint8_t*)_body, bodyLen);
+  _response[0] = '\0';
+  _lastCode = code;
+  _retryAfterMs = 0;
+  if (code == 429 || code == 503) {
+    // Retry-After: 초 단위만 지원 (HTTP-date 형식은 무시 → 기본 백오프)
+    long sec = ep.http.header("Retry-After").toInt();
+    if (sec > 0) _retryAfterMs = min((uint32_t)sec * 1000UL, (uint32_t)API_RETRY_MAX_MS);
+  }
+  
+  if (code > 0) {
+    int size = ep.http.getSize();
+    WiFiClient* stream = ep.http.getStreamPtr();
+    if (size >= 0 && stream) {
+      // 응답 본문을 끝까지 읽어야 다음 요청에 연결 재사용 가능 (버퍼를 넘는 부분은 버림)
+      size_t got = 0;
+      uint32_t t0 = millis();
+      while (size > 0 && millis() - t0 < API_HTTP_TIMEOUT_MS) {
+        int avail = stream->available();
+        if (avail <= 0) {
+          if (!stream->connected()) break;
+          vTaskDelay(pdMS_TO_TICKS(1));
+          continue;
+        }
+        uint8_t scratch[32];
+        uint8_t* dst = scratch;
+        size_t room = sizeof(scratch);
+        if (got < sizeof(_response) - 1) {
+          dst = (uint8_t*)&_response[got];
+          room = sizeof(_response) - 1 - got;
+        }
+        int n = stream->read(dst, min((size_t)min(avail, size), room));
+        if (n <= 0) break;
+        if (dst != scratch) got += n;
+        size -= n;
+      }
+      _response[got] = '\0';
+    } else {
+      // 길이 미상(chunked) 응답 - 드문 경우라 String으로 읽음
+      String body = ep.http.getString();
+      strncpy(_response, body.c_str(), sizeof(_response) - 1);
+      _response[sizeof(_response) - 1] = '\0';
+    }
+  }
+  
+  ep.http.end();  // setReuse(true): 연결을 닫지 않고 유지
+  ep.requests++;
+  if (reuse) ep.reused++;
+  return code;
+}
+
 // 공정 시작 API 호출 (record_id 받아오기)
 bool UpdateAPI::processStart() {
 #if ENABLE_API_UPLOAD
+  _lastCode = 0;
+  _retryAfterMs = 0;
+  _startAccepted = false;
   if (WiFi.status() != WL_CONNECTED) {
     Serial.println("[ProcessStart] WiFi not connected");
     return false;
   }
-
-  WiFiClient client;
-  HTTPClient http;
   
-  if (!http.begin(client, API_START_URL)) {
-    Serial.println("[ProcessStart] HTTP begin failed");
-    return false;
+  // START는 멱등이 아님 - 재시도마다 같은 키를 보내지만 서버가 이 헤더를 지원한다는 근거는 없음 (권고용)
+  // 그래서 요청이 전송된 뒤의 실패(응답 유실/타임아웃)는 재전송하지 않음 (아래 _startAccepted)
+  if (_startKey[0] == '\0') {
+    static uint32_t bootNonce = 0;
+    if (bootNonce == 0) bootNonce = esp_random() | 1;
+    snprintf(_startKey, sizeof(_startKey), "%s-%08lx-%lu", process_data_input.machineId,
+             (unsigned long)bootNonce, (unsigned long)++_startSeq);
   }
 
-  // 헤더 설정
-  http.addHeader(process_data_input.securityKey, process_data_input.securityValue);
-  http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-
   // Body 데이터 생성
-  String postData = "product_id=" + String(process_data_input.productId);
-  postData += "&partner_id=" + String(process_data_input.partnerId);
-  postData += "&machine_id=" + String(process_data_input.machineId);
+  size_t len = 0;
+  bool ok = addField(len, "product_id", process_data_input.productId) &&
+            addField(len, "partner_id", process_data_input.partnerId) &&
+            addField(len, "machine_id", process_data_input.machineId);
+  if (!ok) {
+    Serial.println("[ProcessStart] Body too long");
+    return false;
+  }
 
-  Serial.printf("[ProcessStart] POST to: %s\n", API_START_URL);
-  Serial.printf("[ProcessStart] Body: %s\n", postData.c_str());
+  Serial.printf("[ProcessStart] POST to: %s\n", _startEp.url);
+  Serial.printf("[ProcessStart] Body: %s (key %s)\n", _body, _startKey);
 
-  int httpResponseCode = http.POST(postData);
+  int httpResponseCode = post(_startEp, len, _startKey);
 
   if (httpResponseCode > 0) {
-    String response = http.getString();
     Serial.printf("[ProcessStart] HTTP %d\n", httpResponseCode);
     
-    if (httpResponseCode == 200) {
-      // record_id 추출
-      if (parseRecordId(response)) {
+    if (httpResponseCode >= 200 && httpResponseCode < 300) {
+      // 서버는 이미 레코드를 만들었음 - 본문을 못 읽어도 다시 보내면 중복 레코드
+      _startAccepted = true;
+      if (parseRecordId(_response)) {
         process_data_input.recordId = _recordId;
         Serial.printf("[ProcessStart] Received record_id: %s\n", _recordId);
-        http.end();
         return true;
       } else {
         Serial.println("[ProcessStart] Failed to parse record_id");
       }
     }
-    http.end();
   } else {
     Serial.printf("[ProcessStart] POST failed: code=%d\n", httpResponseCode);
-    http.end();
+    // 본문까지 보낸 뒤 끊김/응답 타임아웃: 서버가 레코드를 만들었는지 알 수 없음 → 재전송 금지
+    // (연결 실패/헤더 전송 실패는 요청이 처리될 수 없으므로 재시도 가능)
+    if (httpResponseCode == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+        httpResponseCode == HTTPC_ERROR_CONNECTION_LOST ||
+        httpResponseCode == HTTPC_ERROR_READ_TIMEOUT) {
+      _startAccepted = true;
+    }
   }
   
   return false;
@@ -129,14 +249,15 @@ void UpdateAPI::begin() {
   process_data_input.machine_status = 0;
   Serial.println("[UpdateAPI] Config initialized from config.h");
 
-  // FreeRTOS Queue 생성 (최대 10개 항목 저장)
-  _uploadQueue = xQueueCreate(10, sizeof(APIUploadData));
-  if (_uploadQueue == nullptr) {
-    Serial.println("[UpdateAPI] Failed to create queue");
-    return;
-  }
+  // Keep-alive 연결 설정 (엔드포인트당 WiFiClient/HTTPClient 하나를 계속 사용)
+  _startEp.url = API_START_URL;
+  _dataEp.url = API_DATA_URL;
+  _startEp.http.setReuse(true);
+  _dataEp.http.setReuse(true);
+  _startEp.http.setTimeout(API_HTTP_TIMEOUT_MS);
+  _dataEp.http.setTimeout(API_HTTP_TIMEOUT_MS);
 
-  // FreeRTOS Task 생성 (Priority 1, Core 1에서 실행 - WiFi와 같은 코어)
+  // FreeRTOS Task 생성 (Core 0 - 네트워크 Task와 같은 코어, 제어 루프는 Core 1)
   BaseType_t ret = xTaskCreatePinnedToCore(
     uploadTask,         // Task 함수
     "APIUploadTask",    // Task 이름
@@ -144,36 +265,65 @@ void UpdateAPI::begin() {
     this,               // Parameter (this 포인터)
     1,                  // Priority (1 = 낮음)
     &_taskHandle,       // Task Handle
-    1                   // Core 1 (WiFi/Network와 같은 코어에서 실행)
+    0                   // Core 0
   );
 
   if (ret != pdPASS) {
     Serial.println("[UpdateAPI] Failed to create task");
     _taskHandle = nullptr;
   } else {
+    gDiag.registerTask(_taskHandle, "APIUploadTask", 16384);
     Serial.println("[UpdateAPI] Task created successfully");
   }
 #endif
 }
 
-void UpdateAPI::queueUpload(int measureValue, const char* departureYn) {
+// ========== 공정 수명주기 → 업로드 작업 ==========
+// 제어 루프 1초 틱에서 호출: dry_state 전환을 보고 START/DATA/FINISH 작업을 만든다.
+// PREPARE → RUN: START + 첫 DATA, RUN/COOL 중: API_UPLOAD_INTERVAL_MS마다 DATA, → FINISH: 마지막 DATA + FINISH
+void UpdateAPI::tick() {
 #if ENABLE_API_UPLOAD
-  if (_uploadQueue == nullptr) {
-    Serial.println("[UpdateAPI] Queue not initialized");
-    return;
+  if (_taskHandle == nullptr) return;
+  
+  uint8_t state = gCUR.dry_state;
+  uint32_t now = millis();
+  int temp = (int)gCUR.measure_ntc_temp;
+  
+  if (!_lifecycleInit) {
+    // 부팅 직후 RUN이면 (웜 리스타트 포함) 새 공정으로 시작
+    _lastDryState = DRY_FINISH;
+    _lifecycleInit = true;
   }
+  
+  if (state != _lastDryState) {
+    if (state == DRY_RUN && !_processActive) {
+      pushJob(PROCESS_START, 0);
+      pushJob(PROCESS_DATA, temp);
+      _processActive = true;
+      _lastDataMs = now;
+    } else if (state == DRY_FINISH && _processActive) {
+      pushJob(PROCESS_DATA, temp);
+      pushJob(PROCESS_FINISH, temp);
+      _processActive = false;
+    }
+    _lastDryState = state;
+  }
+  
+  if (_processActive && now - _lastDataMs >= API_UPLOAD_INTERVAL_MS) {
+    pushJob(PROCESS_DATA, temp);
+    _lastDataMs = now;
+  }
+#endif
+}
 
-  APIUploadData data;
-  data.measureValue = measureValue;
-  strncpy(data.departureYn, departureYn, sizeof(data.departureYn) - 1);
-  data.departureYn[sizeof(data.departureYn) - 1] = '\0';
-
-  // Queue에 데이터 추가 (대기 없음)
-  if (xQueueSend(_uploadQueue, &data, 0) != pdTRUE) {
-    Serial.println("[UpdateAPI] Queue full, upload skipped");
-  } else {
-    Serial.printf("[UpdateAPI] Queued: value=%d, departure=%s\n", measureValue, departureYn);
+void UpdateAPI::queueUpload(int measureValue, const char* departureYn) {
+#if ENABLE_API_UPLOAD
+  (void)departureYn;  // departure_yn은 작업 종류(DATA/FINISH)로 결정됨
+  if (_taskHandle == nullptr) {
+    Serial.println("[UpdateAPI] Task not running");
+    return;
   }
+  pushJob(PROCESS_DATA, measureValue);
 #else
   (void)measureValue;
   (void)departureYn;
@@ -181,6 +331,128 @@ void UpdateAPI::queueUpload(int measureValue, const char* departureYn) {
 #endif
 }
 
+// ========== 작업 큐 (portMUX 보호, 제어 루프는 대기하지 않음) ==========
+bool UpdateAPI::pushJob(uint8_t type, int value) {
+  bool ok = true;
+  bool coalesced = false;
+  bool dropped = false;
+  
+  portENTER_CRITICAL(&_jobMux);
+  APIJob* tail = (_jobCount > 0) ? &_jobs[(_jobHead + _jobCount - 1) % API_JOB_QUEUE_LEN] : nullptr;
+  
+  if (type == PROCESS_DATA && tail && tail->type == PROCESS_DATA && !tail->inFlight) {
+    // 아직 전송 전인 DATA에 합침 (최신 값 유지)
+#if API_DATA_BATCH
+    if (tail->count >= API_DATA_BATCH_MAX) {
+      memmove(&tail->values[0], &tail->values[1], sizeof(int) * (API_DATA_BATCH_MAX - 1));
+      tail->count--;
+    }
+    tail->values[tail->count++] = value;
+#else
+    tail->values[0] = value;
+#endif
+    _coalesced++;
+    coalesced = true;
+  } else {
+    if (_jobCount >= API_JOB_QUEUE_LEN) {
+      // 가득 참: 가장 오래된 대기 DATA를 버려 자리 확보 (START/FINISH는 버리지 않음)
+      for (uint8_t i = 0; i < _jobCount; i++) {
+        uint8_t idx = (_jobHead + i) % API_JOB_QUEUE_LEN;
+        if (_jobs[idx].type == PROCESS_DATA && !_jobs[idx].inFlight) {
+          for (uint8_t j = i; j + 1 < _jobCount; j++) {
+            _jobs[(_jobHead + j) % API_JOB_QUEUE_LEN] = _jobs[(_jobHead + j + 1) % API_JOB_QUEUE_LEN];
+          }
+          _jobCount--;
+          _dropped++;
+          dropped = true;
+          break;
+        }
+      }
+    }
+    if (_jobCount < API_JOB_QUEUE_LEN) {
+      APIJob& job = _jobs[(_jobHead + _jobCount) % API_JOB_QUEUE_LEN];
+      job.type = type;
+      job.count = 1;
+      job.inFlight = false;
+      job.values[0] = value;
+      _jobCount++;
+    } else {
+      ok = false;  // START/FINISH만으로 가득 참 (오프라인 상태로 공정 여러 번 반복)
+    }
+  }
+  portEXIT_CRITICAL(&_jobMux);
+  
+  if (!ok) {
+    LOGE("[UpdateAPI] Job queue full, type %u lost\n", type);
+    return false;
+  }
+  if (dropped) LOGW("[UpdateAPI] Job queue full, oldest DATA dropped\n");
+  if (!coalesced && _taskHandle) xTaskNotifyGive(_taskHandle);
+  return true;
+}
+
+bool UpdateAPI::peekJob(APIJob& job) {
+  bool found = false;
+  portENTER_CRITICAL(&_jobMux);
+  if (_jobCount > 0) {
+    _jobs[_jobHead].inFlight = true;  // 전송 중에는 더 이상 합치지 않음
+    job = _jobs[_jobHead];
+    found = true;
+  }
+  portEXIT_CRITICAL(&_jobMux);
+  return found;
+}
+
+void UpdateAPI::finishJob(bool done) {
+  portENTER_CRITICAL(&_jobMux);
+  if (_jobCount > 0) {
+    if (done) {
+      _jobHead = (_jobHead + 1) % API_JOB_QUEUE_LEN;
+      _jobCount--;
+    } else {
+      _jobs[_jobHead].inFlight = false;  // 재시도 대기 중에는 새 값으로 갱신 가능
+    }
+  }
+  portEXIT_CRITICAL(&_jobMux);
+}
+
+uint8_t UpdateAPI::pending() {
+  portENTER_CRITICAL(&_jobMux);
+  uint8_t n = _jobCount;
+  portEXIT_CRITICAL(&_jobMux);
+  return n;
+}
+
+bool UpdateAPI::runJob(const APIJob& job) {
+  switch (job.type) {
+    case PROCESS_START:
+      return processStart();
+    case PROCESS_DATA:
+    case PROCESS_FINISH:
+      if (process_data_input.recordId[0] == '\0') {
+        // 이번 공정의 START를 포기함 - 다른 레코드에 섞이지 않도록 버림
+        Serial.printf("[APITask] Job %u skipped - no record_id\n", job.type);
+        _dropped++;
+        return true;
+      }
+      process_data_input.measure_temperature = (float)job.values[job.count - 1];
+#if API_DATA_BATCH
+      if (job.type == PROCESS_DATA) return sendData(PROCESS_DATA, job.values, job.count);
+#endif
+      return sendData(job.type);
+    default:
+      _lastCode = 400;
+      return false;
+  }
+}
+
+// 지수 백오프 (API_RETRY_MIN_MS → 2배씩 → API_RETRY_MAX_MS), ±25% 지터로 동시 재접속 분산
+uint32_t UpdateAPI::nextRetryDelay() {
+  _backoffMs = (_backoffMs == 0) ? API_RETRY_MIN_MS : min(_backoffMs * 2, (uint32_t)API_RETRY_MAX_MS);
+  uint32_t jitter = _backoffMs / 4;
+  return _backoffMs - jitter + (esp_random() % (2 * jitter + 1));
+}
+
 bool UpdateAPI::isTaskRunning() {
 #if ENABLE_API_UPLOAD
   return (_taskHandle != nullptr);
@@ -192,47 +464,71 @@ bool UpdateAPI::isTaskRunning() {
 void UpdateAPI::uploadTask(void* parameter) {
 #if ENABLE_API_UPLOAD
   UpdateAPI* api = static_cast<UpdateAPI*>(parameter);
-  APIUploadData data;
+  APIJob job;
 
   Serial.printf("[APITask] Started on Core %d\n", xPortGetCoreID());
 
   while (true) {
-    // Queue에서 데이터 수신 (최대 1초 대기)
-    if (xQueueReceive(api->_uploadQueue, &data, pdMS_TO_TICKS(1000)) == pdTRUE) {
-      // WiFi 연결 확인
-      if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("[APITask] Skip upload: WiFi disconnected");
-        vTaskDelay(pdMS_TO_TICKS(5000)); // 5초 대기 후 재시도
-        continue;
-      }
-
-      // HTTP POST 전송
-      Serial.printf("[APITask] Uploading: value=%d, departure=%s\n", 
-                    data.measureValue, data.departureYn);
-      
-      // 온도 데이터 업데이트
-      api->process_data_input.measure_temperature = (float)data.measureValue;
-      
-      // 공정 데이터 갱신으로 전송 (PROCESS_DATA)
-      bool success = api->sendData(PROCESS_DATA);
-      
-      if (success) {
-        Serial.println("[APITask] Upload successful");
-      } else {
-        Serial.println("[APITask] Upload failed");
-      }
-
-      // 전송 후 딜레이 (서버 부하 방지) - 메모리 정리 시간 확보
-      vTaskDelay(pdMS_TO_TICKS(2000));
+    if (!api->peekJob(job)) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // 새 작업까지 대기
+      continue;
+    }
+    
+    // WiFi 끊김: 작업은 큐에 남겨두고 대기 (백오프 증가 없음)
+    if (!gWiFi.isConnected()) {
+      api->finishJob(false);
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
     }
     
-    // CPU 양보 - 메모리 안정화
-    vTaskDelay(pdMS_TO_TICKS(500));
+    api->_attempts++;
+    if (api->runJob(job)) {
+      Serial.printf("[APITask] Job %u done (attempt %u, pending %u)\n",
+                    job.type, api->_attempts, api->pending() - 1);
+      api->finishJob(true);
+      api->_attempts = 0;
+      api->_backoffMs = 0;
+      if (job.type == PROCESS_START) api->_startKey[0] = '\0';
+      continue;  // 밀린 작업은 바로 이어서 전송
+    }
+    
+    int code = api->_lastCode;
+    if (job.type == PROCESS_START && api->_startAccepted) {
+      // 2xx인데 record_id를 못 읽었거나 전송 후 응답 유실: 재전송하면 서버에 레코드가 하나 더 생길 수 있음
+      // (멱등 키는 권고용) → 이번 공정은 업로드 포기
+      Serial.printf("[APITask] START sent (code %d) without record_id - process upload abandoned\n", code);
+      api->_recordId[0] = '\0';
+      api->process_data_input.recordId = api->_recordId;
+      api->_startKey[0] = '\0';
+      api->finishJob(true);
+      api->_attempts = 0;
+      api->_backoffMs = 0;
+      continue;
+    }
+    
+    // 4xx (408/429 제외)는 재시도해도 같은 결과 - DATA는 몇 번 뒤 포기, START/FINISH는 계속 재시도
+    // (여기까지 온 START는 서버에 도달하지 못했거나 거부된 요청 - 재전송해도 중복 생성 없음)
+    bool permanent = (code >= 400 && code < 500 && code != 408 && code != 429);
+    if (permanent && job.type == PROCESS_DATA && api->_attempts >= API_DATA_MAX_ATTEMPTS) {
+      Serial.printf("[APITask] DATA dropped after %u attempts (HTTP %d)\n", api->_attempts, code);
+      api->finishJob(true);
+      api->_attempts = 0;
+      api->_backoffMs = 0;
+      api->_dropped++;
+      continue;
+    }
+    
+    uint32_t wait = api->_retryAfterMs ? api->_retryAfterMs : api->nextRetryDelay();
+    Serial.printf("[APITask] Job %u failed (HTTP %d), retry in %lu ms\n",
+                  job.type, code, (unsigned long)wait);
+    api->finishJob(false);
+    vTaskDelay(pdMS_TO_TICKS(wait));
   }
 #endif
 }
 
-bool UpdateAPI::sendData(uint8_t processType) {
+// values/count: 묶음 전송할 측정값 (API_DATA_BATCH), 없으면 measure_temperature 하나
+bool UpdateAPI::sendData(uint8_t processType, const int* values, uint8_t count) {
 #if ENABLE_API_UPLOAD
   // processType에 따라 데이터 준비
   APIConfig config;
@@ -251,43 +547,52 @@ bool UpdateAPI::sendData(uint8_t processType) {
       return false;
   }
 
-  WiFiClient client;
-  HTTPClient http;
-  
-  if (!http.begin(client, config.endpointUrl)) {
-    Serial.println("[APITask] HTTP begin failed");
+  // Body 데이터 생성 (Postman과 동일하게) - 미리 할당된 버퍼에 직접 기록
+  size_t len = 0;
+  bool ok = addField(len, "product_id", config.productId) &&
+            addField(len, "partner_id", config.partnerId) &&
+            addField(len, "machine_id", config.machineId) &&
+            addField(len, "record_id", config.recordId);
+  if (ok && values != nullptr && count > 1) {
+    // 쉼표 구분 묶음 (서버가 지원할 때만 - API_DATA_BATCH)
+    char list[API_DATA_BATCH_MAX * 12];
+    size_t n = 0;
+    for (uint8_t i = 0; i < count && n < sizeof(list) - 12; i++) {
+      if (i > 0) list[n++] = ',';
+      ltoa(values[i], &list[n], 10);
+      n += strlen(&list[n]);
+    }
+    list[n] = '\0';
+    ok = addField(len, API_BATCH_FIELD, list);
+  } else if (ok) {
+    ok = addField(len, "measure_value", (long)config.measure_temperature);  // measure_value로 변경, 정수로 전송
+  }
+  ok = ok && addField(len, "departure_yn", config.departureYn);
+  if (!ok) {
+    Serial.println("[APITask] Body too long");
+    _lastCode = 400;  // 재시도해도 같은 결과 → 영구 오류로 취급
     return false;
   }
 
-  // 헤더 설정 (Postman 스크린샷과 동일)
-  http.addHeader(config.securityKey, config.securityValue);
-  http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-
-  // Body 데이터 생성 (Postman과 동일하게)
-  String postData = "product_id=" + String(config.productId);
-  postData += "&partner_id=" + String(config.partnerId);
-  postData += "&machine_id=" + String(config.machineId);
-  postData += "&record_id=" + String(config.recordId);
-  postData += "&measure_value=" + String((int)config.measure_temperature);  // measure_value로 변경, 정수로 전송
-  postData += "&departure_yn=" + String(config.departureYn);
-
-  Serial.printf("[APITask] POST to: %s\n", config.endpointUrl);
-  Serial.printf("[APITask] Body: %s\n", postData.c_str());
+  // 데이터/종료는 API_DATA_URL 연결 재사용
+  APIEndpoint& ep = _dataEp;
+  Serial.printf("[APITask] POST to: %s\n", ep.url);
+  Serial.printf("[APITask] Body: %s\n", _body);
 
-  int httpResponseCode = http.POST(postData);
+  int httpResponseCode = post(ep, len);
 
   if (httpResponseCode > 0) {
-    String response = http.getString();
-    Serial.printf("[APITask] HTTP %d: %s\n", httpResponseCode, response.c_str());
-    http.end();
+    Serial.printf("[APITask] HTTP %d: %s (conn reused %lu/%lu)\n", httpResponseCode, _response,
+                  (unsigned long)ep.reused, (unsigned long)ep.requests);
     return (httpResponseCode >= 200 && httpResponseCode < 300);
   } else {
-    Serial.printf("[APITask] POST failed: %s\n", http.errorToString(httpResponseCode).c_str());
-    http.end();
+    Serial.printf("[APITask] POST failed: %s\n", HTTPClient::errorToString(httpResponseCode).c_str());
     return false;
   }
 #else
   (void)processType;
+  (void)values;
+  (void)count;
   return false;
 #endif
 }
@@ -34,19 +34,34 @@ enum ProcessType {
   PROCESS_FINISH = 2    // 공정 종료
 };
 
-// API 업로드 데이터 구조체
-struct APIUploadData {
-  int measureValue;
-  char departureYn[4];  // "N", "Y", "n", "y" + null
+// 업로드 작업 (공정 수명주기 순서대로 처리)
+// DATA는 아직 전송 전이면 최신 값으로 합쳐짐 (API_DATA_BATCH=1이면 최근 API_DATA_BATCH_MAX개 유지)
+// START/FINISH는 큐 압박 시에도 버리지 않음 (대신 오래된 DATA를 버림)
+struct APIJob {
+  uint8_t type;                     // ProcessType
+  uint8_t count;                    // DATA: 측정값 수
+  bool inFlight;                    // 전송 중 (합치기 대상 아님)
+  int values[API_DATA_BATCH_MAX];   // DATA: 측정값 (오래된 것부터)
+};
+
+// Keep-alive HTTP 연결 (엔드포인트당 하나, 요청 간 TCP 연결 재사용)
+struct APIEndpoint {
+  const char* url;
+  WiFiClient client;
+  HTTPClient http;
+  uint32_t requests;    // 전송 요청 수
+  uint32_t reused;      // 기존 연결로 보낸 요청 수
 };
 
 class UpdateAPI {
 public:
   void begin();
+  void tick();                               // 제어 틱(1초)마다 - dry_state 전환으로 START/DATA/FINISH 생성
   void queueUpload(int measureValue, const char* departureYn = "N");
   bool isTaskRunning();
   void setConfig(const APIConfig& config);  // API 설정 변경
   bool processStart();                       // 공정 시작 (record_id 받아오기)
+  uint8_t pending();                         // 대기 중인 작업 수
   
   // 공정 타입별 데이터 준비 함수
   APIConfig start_process_data_input();      // 공정 시작
@@ -55,11 +70,43 @@ public:
 
 private:
   static void uploadTask(void* parameter);
-  bool sendData(uint8_t processType);        // processType에 따라 전송
-  bool parseRecordId(const String& response);  // JSON에서 record_id 추출
+  bool pushJob(uint8_t type, int value);     // 제어 루프 → 작업 큐 (차단 없음)
+  bool peekJob(APIJob& job);                 // 가장 오래된 작업 (inFlight 표시)
+  void finishJob(bool done);                 // done: 제거, 아니면 재시도 대기
+  bool runJob(const APIJob& job);
+  uint32_t nextRetryDelay();
+  bool sendData(uint8_t processType, const int* values = nullptr, uint8_t count = 0);  // processType에 따라 전송
+  bool parseRecordId(const char* response);  // JSON에서 record_id 추출
+  int post(APIEndpoint& ep, size_t bodyLen, const char* idemKey = nullptr); // _body 전송, 응답은 _response에
+  bool addField(size_t& len, const char* key, const char* value);
+  bool addField(size_t& len, const char* key, long value);
+  
+  APIEndpoint _startEp;                      // API_START_URL
+  APIEndpoint _dataEp;                       // API_DATA_URL (데이터/종료)
+  char _body[API_BODY_MAX];                  // 요청 body (url-encoded)
+  char _response[API_RESPONSE_MAX];          // 응답 body
   
   TaskHandle_t _taskHandle = nullptr;
-  QueueHandle_t _uploadQueue = nullptr;
+  portMUX_TYPE _jobMux = portMUX_INITIALIZER_UNLOCKED;
+  APIJob _jobs[API_JOB_QUEUE_LEN];
+  uint8_t _jobHead = 0;
+  uint8_t _jobCount = 0;
+  uint32_t _coalesced = 0;                   // 합쳐진 DATA 수
+  uint32_t _dropped = 0;                     // 버려진 DATA 수
+  
+  int _lastCode = 0;                         // 마지막 HTTP 응답 코드
+  uint32_t _retryAfterMs = 0;                // 서버 Retry-After (0 = 없음)
+  uint32_t _backoffMs = 0;                   // 현재 재시도 간격
+  uint8_t _attempts = 0;                     // 현재 작업 시도 횟수
+  bool _startAccepted = false;               // START가 2xx로 접수됨 또는 전송 후 응답 유실 (접수 여부 불명) - 재전송 금지
+  char _startKey[40] = {0};                  // START 멱등 키 (권고용 - 작업 완료/포기 전까지 재시도마다 같은 값)
+  uint32_t _startSeq = 0;                    // 부팅 후 START 작업 번호
+  
+  // 공정 수명주기 (제어 루프 측)
+  bool _lifecycleInit = false;
+  bool _processActive = false;
+  uint8_t _lastDryState = 0;
+  uint32_t _lastDataMs = 0;
   APIConfig process_data_input;
   char _recordId[16] = {0};                  // 서버에서 받은 record_id (최대 15자)
   // APIConfig _config = {  // 기본 설정 (config.h 값)
@@ -73,3 +120,5 @@ private:
   //   API_DEPARTURE_YN
   // };
 };
+
+extern UpdateAPI gUpdateAPI;
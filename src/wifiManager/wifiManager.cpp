@@ -0,0 +1,477 @@
+// wifiManager.cpp - 이벤트 기반 비차단 WiFi 연결 관리자 구현
+
+#include "wifiManager.h"
+#include <stddef.h>
+#include <esp_system.h>
+#include <esp32/rom/crc.h>
+
+WiFiManager gWiFi;
+
+// RTC slow memory 빠른 재연결 캐시 (웜 리스타트 시 NVS 읽기 생략)
+#define WIFI_CACHE_MAGIC 0x57464331UL  // "WFC1"
+typedef struct {
+  uint32_t magic;
+  uint8_t slot;
+  uint8_t channel;
+  uint8_t bssid[6];
+  uint32_t crc;
+} WIFI_RTC_CACHE;
+
+RTC_NOINIT_ATTR static WIFI_RTC_CACHE s_wifiRtcCache;
+
+static uint32_t cacheCrc(const WIFI_RTC_CACHE& c) {
+  return crc32_le(0, (const uint8_t*)&c, offsetof(WIFI_RTC_CACHE, crc));
+}
+
+// ========== WiFi 이벤트 핸들러 (WiFi 이벤트 Task 컨텍스트) ==========
+void WiFiManager::onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+      gWiFi._evtAssocAt = millis();
+      break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      gWiFi._evtGotIp = true;
+      gWiFi.setLinkState(WIFI_LINK_UP);
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      // 자체 WiFi.disconnect()에 의한 끊김(ASSOC_LEAVE)은 다음 시도의 실패로 보지 않음
+      if (info.wifi_sta_disconnected.reason == WIFI_REASON_ASSOC_LEAVE) break;
+      gWiFi._evtDisconnected = true;
+      if (gWiFi._linkState == WIFI_LINK_UP) {
+        Serial.printf("[WiFi] Disconnected (reason %d)\n", info.wifi_sta_disconnected.reason);
+        portENTER_CRITICAL(&gWiFi._statsMux);
+        gWiFi._stats.disconnects++;
+        gWiFi._stats.last_reason = info.wifi_sta_disconnected.reason;
+        portEXIT_CRITICAL(&gWiFi._statsMux);
+        gWiFi.setLinkState(WIFI_LINK_DOWN);
+      }
+      break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      gWiFi._evtDisconnected = true;
+      gWiFi.setLinkState(WIFI_LINK_DOWN);
+      break;
+    default:
+      break;
+  }
+}
+
+void WiFiManager::setLinkState(WIFI_LINK_STATE st) {
+  if (_linkState == st) return;
+  // 끊김 시간 누적: UP을 벗어나면 시작, UP이 되면 합산
+  portENTER_CRITICAL(&_statsMux);
+  if (st == WIFI_LINK_UP) {
+    _stats.down_ms += millis() - _downSince;
+  } else if (_linkState == WIFI_LINK_UP) {
+    _downSince = millis();
+  }
+  portEXIT_CRITICAL(&_statsMux);
+  _linkState = st;
+  for (uint8_t i = 0; i < _subscriberCount; i++) {
+    _subscribers[i](st, _subscriberArgs[i]);
+  }
+}
+
+bool WiFiManager::subscribe(WiFiLinkCallback cb, void* arg) {
+  if (cb == nullptr || _subscriberCount >= WIFI_MAX_SUBSCRIBERS) return false;
+  _subscribers[_subscriberCount] = cb;
+  _subscriberArgs[_subscriberCount] = arg;
+  _subscriberCount++;
+  return true;
+}
+
+bool WiFiManager::isConnected() {
+  return _linkState == WIFI_LINK_UP;
+}
+
+WIFI_LINK_STATE WiFiManager::state() {
+  return _linkState;
+}
+
+// ========== 저장된 네트워크 (Preferences "wifi") ==========
+// slot 0: "ssid"/"password" (기존 단일 키 호환), slot n: "ssid<n>"/"pass<n>"
+void WiFiManager::loadNetworks() {
+  _networkCount = 0;
+  _prefs.begin("wifi", true);
+  for (uint8_t i = 0; i < WIFI_MAX_NETWORKS; i++) {
+    char kSsid[8], kPass[10];
+    if (i == 0) {
+      strcpy(kSsid, "ssid");
+      strcpy(kPass, "password");
+    } else {
+      snprintf(kSsid, sizeof(kSsid), "ssid%d", i);
+      snprintf(kPass, sizeof(kPass), "pass%d", i);
+    }
+    WIFI_NETWORK& n = _networks[_networkCount];
+    if (_prefs.getString(kSsid, n.ssid, sizeof(n.ssid)) == 0 || n.ssid[0] == '\0') continue;
+    if (_prefs.getString(kPass, n.pass, sizeof(n.pass)) == 0) n.pass[0] = '\0';
+    _networkCount++;
+  }
+  _prefs.end();
+
+  // 저장된 네트워크가 없으면 config.h 기본값 사용
+  if (_networkCount == 0) {
+    strncpy(_networks[0].ssid, WIFI_SSID, sizeof(_networks[0].ssid) - 1);
+    _networks[0].ssid[sizeof(_networks[0].ssid) - 1] = '\0';
+    strncpy(_networks[0].pass, WIFI_PASS, sizeof(_networks[0].pass) - 1);
+    _networks[0].pass[sizeof(_networks[0].pass) - 1] = '\0';
+    _networkCount = 1;
+    Serial.println("[WiFi] Using default WiFi credentials");
+  } else {
+    Serial.printf("[WiFi] %d saved network(s)\n", _networkCount);
+  }
+}
+
+void WiFiManager::saveNetworks() {
+  _prefs.begin("wifi", false);
+  for (uint8_t i = 0; i < WIFI_MAX_NETWORKS; i++) {
+    char kSsid[8], kPass[10];
+    if (i == 0) {
+      strcpy(kSsid, "ssid");
+      strcpy(kPass, "password");
+    } else {
+      snprintf(kSsid, sizeof(kSsid), "ssid%d", i);
+      snprintf(kPass, sizeof(kPass), "pass%d", i);
+    }
+    if (i < _networkCount) {
+      _prefs.putString(kSsid, _networks[i].ssid);
+      _prefs.putString(kPass, _networks[i].pass);
+    } else {
+      _prefs.remove(kSsid);
+      _prefs.remove(kPass);
+    }
+  }
+  _prefs.end();
+}
+
+bool WiFiManager::addNetwork(const char* ssid, const char* pass) {
+  if (ssid == nullptr || ssid[0] == '\0') return false;
+
+  WIFI_NETWORK added;
+  strncpy(added.ssid, ssid, sizeof(added.ssid) - 1);
+  added.ssid[sizeof(added.ssid) - 1] = '\0';
+  strncpy(added.pass, pass ? pass : "", sizeof(added.pass) - 1);
+  added.pass[sizeof(added.pass) - 1] = '\0';
+
+  // 새 항목을 slot 0에, 같은 SSID는 제거하고 나머지는 한 칸씩 뒤로
+  WIFI_NETWORK list[WIFI_MAX_NETWORKS];
+  uint8_t count = 0;
+  list[count++] = added;
+  for (uint8_t i = 0; i < _networkCount && count < WIFI_MAX_NETWORKS; i++) {
+    if (strcmp(_networks[i].ssid, added.ssid) == 0) continue;
+    list[count++] = _networks[i];
+  }
+  memcpy(_networks, list, sizeof(WIFI_NETWORK) * count);
+  _networkCount = count;
+  saveNetworks();
+
+  // slot 번호가 바뀌었으므로 캐시 무효화 (다음 연결 성공 시 재기록)
+  _cacheValid = false;
+  s_wifiRtcCache.magic = 0;
+  Serial.printf("[WiFi] Network saved: %s (%d stored)\n", added.ssid, _networkCount);
+  return true;
+}
+
+// ========== 빠른 재연결 캐시 (RTC 우선, 콜드 부트는 NVS) ==========
+void WiFiManager::loadCache() {
+  WIFI_RTC_CACHE c = s_wifiRtcCache;
+  if (c.magic == WIFI_CACHE_MAGIC && c.crc == cacheCrc(c)) {
+    _cacheSlot = c.slot;
+    _cacheChannel = c.channel;
+    memcpy(_cacheBssid, c.bssid, 6);
+    _cacheValid = true;
+  } else {
+    _prefs.begin("wifi", true);
+    _cacheValid = (_prefs.getBytes("bssid", _cacheBssid, 6) == 6);
+    _cacheChannel = _prefs.getUChar("chan", 0);
+    _cacheSlot = _prefs.getUChar("slot", 0);
+    _prefs.end();
+  }
+  if (_cacheSlot >= _networkCount || _cacheChannel == 0) {
+    _cacheValid = false;
+  }
+}
+
+void WiFiManager::saveCache() {
+  const uint8_t* bssid = WiFi.BSSID();
+  uint8_t channel = (uint8_t)WiFi.channel();
+  if (bssid == nullptr || channel == 0) return;
+
+  bool changed = !_cacheValid || _cacheSlot != _currentSlot || _cacheChannel != channel ||
+                 memcmp(_cacheBssid, bssid, 6) != 0;
+  _cacheSlot = _currentSlot;
+  _cacheChannel = channel;
+  memcpy(_cacheBssid, bssid, 6);
+  _cacheValid = true;
+
+  WIFI_RTC_CACHE c;
+  c.magic = WIFI_CACHE_MAGIC;
+  c.slot = _cacheSlot;
+  c.channel = _cacheChannel;
+  memcpy(c.bssid, _cacheBssid, 6);
+  c.crc = cacheCrc(c);
+  s_wifiRtcCache = c;
+
+  // NVS는 AP가 바뀐 경우에만 기록 (Flash 마모 방지)
+  if (changed) {
+    _prefs.begin("wifi", false);
+    _prefs.putBytes("bssid", _cacheBssid, 6);
+    _prefs.putUChar("chan", _cacheChannel);
+    _prefs.putUChar("slot", _cacheSlot);
+    _prefs.end();
+  }
+}
+
+// ========== 연결 시도 ==========
+void WiFiManager::begin() {
+  loadNetworks();
+  loadCache();
+
+  WiFi.persistent(false);        // 드라이버의 자체 Flash 저장 사용 안함
+  WiFi.setAutoReconnect(false);  // 재연결은 이 관리자가 담당 (백오프)
+  WiFi.mode(WIFI_STA);
+  WiFi.onEvent(onWiFiEvent);
+  _downSince = millis();
+
+  _nextAttempt = millis();
+  _phase = PHASE_IDLE;
+}
+
+// 마지막 성공 AP로 채널/BSSID 지정 연결 (스캔 생략)
+void WiFiManager::startFastConnect() {
+  _currentSlot = _cacheSlot;
+  _candidateCount = 0;
+  _candidateIdx = 0;
+  Serial.printf("[WiFi] Fast reconnect: %s ch%d %02X:%02X:%02X:%02X:%02X:%02X\n",
+                _networks[_currentSlot].ssid, _cacheChannel,
+                _cacheBssid[0], _cacheBssid[1], _cacheBssid[2],
+                _cacheBssid[3], _cacheBssid[4], _cacheBssid[5]);
+  _evtDisconnected = false;
+  _evtGotIp = false;
+  WiFi.begin(_networks[_currentSlot].ssid, _networks[_currentSlot].pass, _cacheChannel, _cacheBssid);
+  beginAttempt();
+  _phase = PHASE_CONNECTING;
+  setLinkState(WIFI_LINK_CONNECTING);
+}
+
+void WiFiManager::startScan() {
+  WiFi.disconnect();
+  if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+    Serial.println("[WiFi] Scan start failed");
+    scheduleRetry();
+    return;
+  }
+  _attemptStart = millis();
+  _phase = PHASE_SCANNING;
+  setLinkState(WIFI_LINK_CONNECTING);
+}
+
+// 스캔 결과에서 저장된 네트워크만 골라 RSSI 내림차순 정렬
+void WiFiManager::processScan() {
+  int16_t n = WiFi.scanComplete();
+  if (n == WIFI_SCAN_RUNNING) {
+    if (millis() - _attemptStart > WIFI_SCAN_TIMEOUT_MS) {
+      WiFi.scanDelete();
+      scheduleRetry();
+    }
+    return;
+  }
+  if (n < 0) {
+    scheduleRetry();
+    return;
+  }
+
+  int32_t rssi[WIFI_MAX_NETWORKS];
+  _candidateCount = 0;
+  for (uint8_t slot = 0; slot < _networkCount; slot++) {
+    int best = -1;
+    for (int16_t i = 0; i < n; i++) {
+      if (WiFi.SSID(i) != _networks[slot].ssid) continue;
+      if (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best)) best = i;
+    }
+    if (best < 0) continue;
+
+    // 삽입 정렬 (RSSI 내림차순)
+    int32_t r = WiFi.RSSI(best);
+    uint8_t pos = _candidateCount;
+    while (pos > 0 && rssi[pos - 1] < r) {
+      rssi[pos] = rssi[pos - 1];
+      _candidates[pos] = _candidates[pos - 1];
+      pos--;
+    }
+    rssi[pos] = r;
+    _candidates[pos].slot = slot;
+    _candidates[pos].channel = WiFi.channel(best);
+    memcpy(_candidates[pos].bssid, WiFi.BSSID(best), 6);
+    _candidateCount++;
+  }
+  WiFi.scanDelete();
+
+  Serial.printf("[WiFi] Scan: %d AP(s), %d known\n", n, _candidateCount);
+  for (uint8_t i = 0; i < _candidateCount; i++) {
+    Serial.printf("[WiFi]   %s (%ld dBm, ch%ld)\n", _networks[_candidates[i].slot].ssid,
+                  (long)rssi[i], (long)_candidates[i].channel);
+  }
+
+  _candidateIdx = 0;
+  if (!connectNextCandidate()) {
+    scheduleRetry();
+  }
+}
+
+bool WiFiManager::connectNextCandidate() {
+  if (_candidateIdx >= _candidateCount) return false;
+  const Candidate& c = _candidates[_candidateIdx++];
+  _currentSlot = c.slot;
+  Serial.printf("[WiFi] Connecting to %s (ch%ld)\n", _networks[c.slot].ssid, (long)c.channel);
+  _evtDisconnected = false;
+  _evtGotIp = false;
+  WiFi.begin(_networks[c.slot].ssid, _networks[c.slot].pass, c.channel, c.bssid);
+  beginAttempt();
+  _phase = PHASE_CONNECTING;
+  setLinkState(WIFI_LINK_CONNECTING);
+  return true;
+}
+
+void WiFiManager::beginAttempt() {
+  _attemptStart = millis();
+  _evtAssocAt = 0;
+  portENTER_CRITICAL(&_statsMux);
+  _stats.attempts++;
+  portEXIT_CRITICAL(&_statsMux);
+}
+
+// ========== 링크 통계 ==========
+void WiFiManager::sampleRssi(uint32_t now) {
+  if (now - _lastRssiSample < WIFI_RSSI_SAMPLE_MS) return;
+  _lastRssiSample = now;
+  int32_t rssi = WiFi.RSSI();
+  if (rssi == 0) return;  // 연결 정보 없음
+  portENTER_CRITICAL(&_statsMux);
+  _stats.rssi = rssi;
+  if (_rssiCount == 0 || rssi < _stats.rssi_min) _stats.rssi_min = rssi;
+  if (_rssiCount == 0 || rssi > _stats.rssi_max) _stats.rssi_max = rssi;
+  _rssiSum += rssi;
+  _rssiCount++;
+  _stats.rssi_avg = _rssiSum / _rssiCount;
+  portEXIT_CRITICAL(&_statsMux);
+}
+
+void WiFiManager::linkStats(WIFI_LINK_STATS& out, bool resetWindow) {
+  portENTER_CRITICAL(&_statsMux);
+  out = _stats;
+  if (_linkState != WIFI_LINK_UP) out.down_ms += millis() - _downSince;
+  if (resetWindow) {
+    _rssiSum = 0;
+    _rssiCount = 0;
+    _stats.rssi_min = _stats.rssi_max = _stats.rssi_avg = _stats.rssi;
+  }
+  portEXIT_CRITICAL(&_statsMux);
+}
+
+// 지수 백오프 + ±25% 지터
+void WiFiManager::scheduleRetry() {
+  uint32_t jitter = _backoffMs / 4;
+  uint32_t delayMs = _backoffMs - jitter + (jitter ? (esp_random() % (2 * jitter + 1)) : 0);
+  _nextAttempt = millis() + delayMs;
+  Serial.printf("[WiFi] Retry in %lu ms\n", (unsigned long)delayMs);
+
+  _backoffMs *= 2;
+  if (_backoffMs > WIFI_BACKOFF_MAX_MS) _backoffMs = WIFI_BACKOFF_MAX_MS;
+
+  _phase = PHASE_IDLE;
+  setLinkState(WIFI_LINK_DOWN);
+}
+
+void WiFiManager::reconnect() {
+  _backoffMs = WIFI_BACKOFF_MIN_MS;
+  _nextAttempt = millis();
+  _phase = PHASE_IDLE;
+  WiFi.disconnect();
+}
+
+void WiFiManager::pause(bool paused) {
+  _paused = paused;
+  if (!paused) {
+    // 외부(SmartConfig)에서 이미 연결했으면 그대로 사용
+    if (WiFi.status() == WL_CONNECTED) {
+      _phase = PHASE_UP;
+      setLinkState(WIFI_LINK_UP);
+    } else {
+      _phase = PHASE_IDLE;
+      _nextAttempt = millis();
+    }
+  }
+}
+
+// ========== 상태 머신 (차단 없음) ==========
+void WiFiManager::loop() {
+  if (_paused) return;
+
+  uint32_t now = millis();
+
+  // IP 획득: 캐시 갱신 + 백오프 리셋
+  if (_evtGotIp) {
+    _evtGotIp = false;
+    if (_phase != PHASE_UP) {
+      _phase = PHASE_UP;
+      _backoffMs = WIFI_BACKOFF_MIN_MS;
+      _candidateCount = 0;  // 다음 끊김 시 빠른 재연결부터 시도
+      Serial.printf("[WiFi] Connected: %s, IP %s, RSSI %d dBm (%lu ms)\n",
+                    WiFi.SSID().c_str(), WiFi.localIP().toString().c_str(), WiFi.RSSI(),
+                    (unsigned long)(now - _attemptStart));
+      // 어소시에이션/DHCP 시간 분리 (STA_CONNECTED 이벤트 시각 기준)
+      uint32_t assocAt = _evtAssocAt;
+      if (assocAt == 0 || (int32_t)(assocAt - _attemptStart) < 0) assocAt = _attemptStart;
+      portENTER_CRITICAL(&_statsMux);
+      _stats.connects++;
+      _stats.assoc_ms = assocAt - _attemptStart;
+      _stats.dhcp_ms = now - assocAt;
+      _stats.channel = WiFi.channel();
+      portEXIT_CRITICAL(&_statsMux);
+      _lastRssiSample = now - WIFI_RSSI_SAMPLE_MS;  // 연결 직후 바로 한 번 샘플
+      saveCache();
+    }
+  }
+
+  switch (_phase) {
+    case PHASE_UP:
+      sampleRssi(now);
+      if (_evtDisconnected || _linkState != WIFI_LINK_UP) {
+        _evtDisconnected = false;
+        // 끊김 직후 첫 재시도는 빠른 재연결 (백오프 최소값)
+        _phase = PHASE_IDLE;
+        _nextAttempt = now;
+      }
+      break;
+
+    case PHASE_IDLE:
+      if ((int32_t)(now - _nextAttempt) >= 0) {
+        if (_cacheValid && _candidateCount == 0 && _backoffMs == WIFI_BACKOFF_MIN_MS) {
+          startFastConnect();
+        } else {
+          startScan();
+        }
+      }
+      break;
+
+    case PHASE_CONNECTING:
+      if (_evtDisconnected || now - _attemptStart > WIFI_CONNECT_TIMEOUT_MS) {
+        _evtDisconnected = false;
+        WiFi.disconnect();
+        if (_candidateCount == 0) {
+          // 빠른 재연결 실패 → 스캔으로 전환
+          Serial.println("[WiFi] Fast reconnect failed, scanning");
+          _backoffMs = _backoffMs == WIFI_BACKOFF_MIN_MS ? WIFI_BACKOFF_MIN_MS * 2 : _backoffMs;
+          startScan();
+        } else if (!connectNextCandidate()) {
+          _candidateCount = 0;
+          scheduleRetry();
+        }
+      }
+      break;
+
+    case PHASE_SCANNING:
+      processScan();
+      break;
+  }
+}
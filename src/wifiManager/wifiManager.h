@@ -0,0 +1,121 @@
+// wifiManager.h - 이벤트 기반 비차단 WiFi 연결 관리자
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include "../config.h"
+
+// 링크 상태
+typedef enum _WIFI_LINK_STATE {
+  WIFI_LINK_DOWN = 0,     // 연결 끊김 (백오프 대기 포함)
+  WIFI_LINK_CONNECTING,   // 연결 시도 중 (스캔/어소시에이션/DHCP)
+  WIFI_LINK_UP,           // IP 획득 완료
+} WIFI_LINK_STATE;
+
+// 링크 상태 변경 구독 콜백 (WiFi 이벤트 Task 컨텍스트에서 호출 - 짧게 처리할 것)
+typedef void (*WiFiLinkCallback)(WIFI_LINK_STATE state, void* arg);
+
+// 링크 품질/연결 통계 (진단용, 건강 메시지로 발행)
+typedef struct {
+  uint32_t connects;          // IP 획득 횟수
+  uint32_t attempts;          // 연결 시도 (WiFi.begin) 횟수
+  uint32_t disconnects;       // 연결 중 끊김 횟수
+  uint8_t last_reason;        // 마지막 끊김 사유 (wifi_err_reason_t)
+  uint32_t assoc_ms;          // 마지막 연결: WiFi.begin → 어소시에이션
+  uint32_t dhcp_ms;           // 마지막 연결: 어소시에이션 → IP 획득
+  uint32_t down_ms;           // 부팅 이후 누적 끊김 시간 (현재 끊김 포함)
+  int8_t rssi;                // 최근 RSSI (dBm, 0 = 없음)
+  int8_t rssi_min;            // 구간 최소/최대/평균 (마지막 리셋 이후)
+  int8_t rssi_max;
+  int8_t rssi_avg;
+  uint8_t channel;
+} WIFI_LINK_STATS;
+
+// 저장된 네트워크 (slot 0 = 기존 "ssid"/"password" 키, 가장 최근 등록)
+typedef struct {
+  char ssid[33];
+  char pass[65];
+} WIFI_NETWORK;
+
+class WiFiManager {
+public:
+  void begin();                       // 저장된 네트워크 로드 + WiFi 이벤트 등록 + 첫 연결 시작 (대기 없음)
+  void loop();                        // 재시도/스캔 상태 머신 (loop()에서 호출, 차단 없음)
+  bool isConnected();
+  WIFI_LINK_STATE state();
+  bool subscribe(WiFiLinkCallback cb, void* arg = nullptr);
+  bool addNetwork(const char* ssid, const char* pass);  // slot 0에 저장 (기존 항목은 뒤로)
+  void reconnect();                   // 백오프 리셋 후 즉시 재연결
+  void pause(bool paused);            // SmartConfig 등 외부에서 WiFi 제어 중일 때 재시도 중지
+  void linkStats(WIFI_LINK_STATS& out, bool resetWindow = false);  // RSSI 구간 통계는 resetWindow 시 초기화
+
+private:
+  enum Phase {
+    PHASE_IDLE = 0,     // 다음 시도 대기 (백오프)
+    PHASE_CONNECTING,   // WiFi.begin() 후 결과 대기
+    PHASE_SCANNING,     // 비동기 스캔 중
+    PHASE_UP,           // 연결됨
+  };
+
+  static void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+  void setLinkState(WIFI_LINK_STATE st);
+  void loadNetworks();
+  void saveNetworks();
+  void loadCache();
+  void saveCache();
+  void startFastConnect();
+  void startScan();
+  void processScan();
+  bool connectNextCandidate();
+  void scheduleRetry();
+  void beginAttempt();
+  void sampleRssi(uint32_t now);
+
+  Preferences _prefs;
+  WIFI_NETWORK _networks[WIFI_MAX_NETWORKS];
+  uint8_t _networkCount = 0;
+
+  // 스캔 결과 기반 연결 후보 (RSSI 내림차순)
+  struct Candidate {
+    uint8_t slot;
+    int32_t channel;
+    uint8_t bssid[6];
+  };
+  Candidate _candidates[WIFI_MAX_NETWORKS];
+  uint8_t _candidateCount = 0;
+  uint8_t _candidateIdx = 0;
+
+  // 빠른 재연결 캐시 (마지막 성공 AP)
+  uint8_t _cacheSlot = 0;
+  uint8_t _cacheBssid[6] = {0};
+  uint8_t _cacheChannel = 0;
+  bool _cacheValid = false;
+
+  Phase _phase = PHASE_IDLE;
+  bool _paused = false;
+  uint32_t _attemptStart = 0;
+  uint32_t _nextAttempt = 0;
+  uint32_t _backoffMs = WIFI_BACKOFF_MIN_MS;
+  uint8_t _currentSlot = 0;
+
+  volatile WIFI_LINK_STATE _linkState = WIFI_LINK_DOWN;
+  volatile bool _evtGotIp = false;
+  volatile bool _evtDisconnected = false;
+  volatile uint32_t _evtAssocAt = 0;  // STA_CONNECTED 시각 (이벤트 Task에서 기록)
+  
+  // 링크 통계
+  portMUX_TYPE _statsMux = portMUX_INITIALIZER_UNLOCKED;
+  WIFI_LINK_STATS _stats = {};
+  uint32_t _downSince = 0;            // 현재 끊김 시작 시각 (연결 중이면 미사용)
+  uint32_t _lastRssiSample = 0;
+  int32_t _rssiSum = 0;
+  uint16_t _rssiCount = 0;
+
+  WiFiLinkCallback _subscribers[WIFI_MAX_SUBSCRIBERS] = {nullptr};
+  void* _subscriberArgs[WIFI_MAX_SUBSCRIBERS] = {nullptr};
+  uint8_t _subscriberCount = 0;
+};
+
+extern WiFiManager gWiFi;
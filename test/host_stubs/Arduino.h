@@ -0,0 +1,25 @@
+// Arduino.h - 호스트 테스트용 스텁 (test/host_stubs)
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define LOW     0
+#define HIGH    1
+
+typedef void* TaskHandle_t;
+
+// 시간/핀 함수는 각 테스트의 모델이 정의
+uint32_t millis();
+void pinMode(uint8_t pin, uint8_t mode);
+uint32_t getCpuFrequencyMhz();
+
+// 사이클 카운터는 테스트의 하드웨어 모델이 정의
+class EspClass {
+public:
+  uint32_t getCycleCount();
+};
+extern EspClass ESP;
@@ -0,0 +1,10 @@
+// PubSubClient.h - 호스트 테스트용 스텁 (test/host_stubs)
+#pragma once
+
+#include <Arduino.h>
+
+// MQTTPublisher가 쓰는 원시 쓰기만 - 테스트의 브로커 모델이 정의
+class PubSubClient {
+public:
+  size_t write(const uint8_t* buffer, size_t size);
+};
@@ -0,0 +1,6 @@
+// driver/gpio.h - 호스트 테스트용 스텁
+#pragma once
+
+typedef int gpio_num_t;
+typedef enum { GPIO_MODE_INPUT = 1, GPIO_MODE_OUTPUT = 2, GPIO_MODE_INPUT_OUTPUT = 3 } gpio_mode_t;
+int gpio_set_direction(gpio_num_t pin, gpio_mode_t mode);
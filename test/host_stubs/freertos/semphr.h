@@ -0,0 +1,11 @@
+// freertos/semphr.h - 호스트 테스트용 스텁 (단일 스레드: 잠금은 항상 성공)
+#pragma once
+
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define pdTRUE 1
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { static int m; return &m; }
+inline int xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline int xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
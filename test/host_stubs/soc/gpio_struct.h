@@ -0,0 +1,53 @@
+// soc/gpio_struct.h - 호스트 테스트용 스텁: 레지스터 쓰기/읽기를 모델 함수로 전달
+#pragma once
+
+#include <stdint.h>
+
+enum GpioRegId : uint8_t {
+  GPIO_REG_OUT_W1TS = 0,
+  GPIO_REG_OUT_W1TC,
+  GPIO_REG_ENABLE_W1TS,
+  GPIO_REG_ENABLE_W1TC,
+  GPIO_REG_OUT1_W1TS,
+  GPIO_REG_OUT1_W1TC,
+  GPIO_REG_ENABLE1_W1TS,
+  GPIO_REG_ENABLE1_W1TC,
+};
+
+void gpioModelWrite(GpioRegId reg, uint32_t value);
+uint32_t gpioModelRead(bool bank1);
+
+template <GpioRegId R>
+struct GpioWReg {
+  GpioWReg& operator=(uint32_t v) { gpioModelWrite(R, v); return *this; }
+};
+
+template <GpioRegId R>
+struct GpioWReg1 {
+  GpioWReg<R> val;
+};
+
+struct GpioInReg {
+  operator uint32_t() const { return gpioModelRead(false); }
+};
+
+struct GpioIn1Reg {
+  struct Data {
+    operator uint32_t() const { return gpioModelRead(true); }
+  } data;
+};
+
+struct gpio_dev_t {
+  GpioWReg<GPIO_REG_OUT_W1TS> out_w1ts;
+  GpioWReg<GPIO_REG_OUT_W1TC> out_w1tc;
+  GpioWReg<GPIO_REG_ENABLE_W1TS> enable_w1ts;
+  GpioWReg<GPIO_REG_ENABLE_W1TC> enable_w1tc;
+  GpioWReg1<GPIO_REG_OUT1_W1TS> out1_w1ts;
+  GpioWReg1<GPIO_REG_OUT1_W1TC> out1_w1tc;
+  GpioWReg1<GPIO_REG_ENABLE1_W1TS> enable1_w1ts;
+  GpioWReg1<GPIO_REG_ENABLE1_W1TC> enable1_w1tc;
+  GpioInReg in;
+  GpioIn1Reg in1;
+};
+
+extern gpio_dev_t GPIO;
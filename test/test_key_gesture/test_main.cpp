@@ -0,0 +1,114 @@
+// test_main.cpp - 키 제스처 상태 기계 테스트: 디바운스, 자동 반복, 3초 길게 누름 (pio test -e native)
+
+#include <unity.h>
+#include "keyScan/keyGesture.h"
+
+static KeyGesture g;
+static KEY_EVENT events[64];
+static uint8_t count;
+
+// from ~ to 구간을 KEY_SCAN_PERIOD_MS 간격으로 raw 샘플 입력, 이벤트 누적
+static void feed(uint8_t raw, uint32_t from, uint32_t to, uint32_t period = KEY_SCAN_PERIOD_MS) {
+  for (uint32_t t = from; t < to; t += period) {
+    KEY_EVENT out[2];
+    uint8_t n = g.step(raw, t, out);
+    for (uint8_t i = 0; i < n && count < 64; i++) events[count++] = out[i];
+  }
+}
+
+static uint8_t countType(uint8_t type) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < count; i++) n += (events[i].type == type);
+  return n;
+}
+
+void setUp() {
+  g.reset();
+  count = 0;
+}
+
+void tearDown() {}
+
+void test_debounce_rejects_single_sample_glitch() {
+  feed(KEY_NULL, 0, 50);
+  feed(KEY_TEMP_UP, 50, 60);             // 1샘플 노이즈
+  feed(KEY_NULL, 60, 200);
+  TEST_ASSERT_EQUAL(0, count);
+}
+
+void test_press_after_debounce_samples() {
+  feed(KEY_TEMP_UP, 0, 100);
+  TEST_ASSERT_TRUE(count >= 1);
+  TEST_ASSERT_EQUAL(KEY_EVT_PRESS, events[0].type);
+  TEST_ASSERT_EQUAL(KEY_TEMP_UP, events[0].key);
+  TEST_ASSERT_EQUAL((KEY_DEBOUNCE_SAMPLES - 1) * KEY_SCAN_PERIOD_MS, events[0].ts_ms);
+}
+
+void test_repeat_300_then_every_100() {
+  feed(KEY_TIME_UP, 0, 1000);            // PRESS at (KEY_DEBOUNCE_SAMPLES - 1) 주기
+  feed(KEY_NULL, 1000, 1100);
+  TEST_ASSERT_EQUAL(KEY_EVT_PRESS, events[0].type);
+  uint32_t press = events[0].ts_ms;
+  // 누른 뒤 300, 400, ..., 900ms 시점 (1000ms 전) → 7회, 하나도 빠지지 않음
+  TEST_ASSERT_EQUAL(7, countType(KEY_EVT_REPEAT));
+  uint8_t r = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (events[i].type != KEY_EVT_REPEAT) continue;
+    TEST_ASSERT_EQUAL(press + KEY_REPEAT_DELAY_MS + r * KEY_REPEAT_RATE_MS, events[i].ts_ms);
+    r++;
+  }
+  TEST_ASSERT_EQUAL(KEY_EVT_RELEASE, events[count - 1].type);
+}
+
+void test_repeat_not_lost_with_jittery_period() {
+  // 샘플 간격 30ms (유휴 주기 등) - 누적 기준 시각이라 반복 수가 줄지 않음
+  feed(KEY_TEMP_DN, 0, 1030, 30);
+  TEST_ASSERT_EQUAL(KEY_EVT_PRESS, events[0].type);
+  uint32_t held = 1000 - events[0].ts_ms;
+  TEST_ASSERT_EQUAL((held - KEY_REPEAT_DELAY_MS) / KEY_REPEAT_RATE_MS + 1, countType(KEY_EVT_REPEAT));
+}
+
+void test_power_long_press_fires_once_at_3s() {
+  feed(KEY_PWR, 0, 5000);
+  TEST_ASSERT_EQUAL(0, countType(KEY_EVT_REPEAT));
+  TEST_ASSERT_EQUAL(1, countType(KEY_EVT_LONG));
+  uint32_t press = events[0].ts_ms;
+  TEST_ASSERT_EQUAL(KEY_EVT_LONG, events[1].type);
+  TEST_ASSERT_EQUAL(press + KEY_LONG_PRESS_MS, events[1].ts_ms);
+  TEST_ASSERT_EQUAL(KEY_LONG_PRESS_MS, events[1].held_ms);
+  feed(KEY_NULL, 5000, 5100);
+  TEST_ASSERT_EQUAL(KEY_EVT_RELEASE, events[count - 1].type);
+  TEST_ASSERT_TRUE(events[count - 1].held_ms >= KEY_LONG_PRESS_MS);
+}
+
+void test_power_short_press_release_held_below_long() {
+  feed(KEY_PWR, 0, 500);
+  feed(KEY_NULL, 500, 600);
+  TEST_ASSERT_EQUAL(2, count);
+  TEST_ASSERT_EQUAL(KEY_EVT_PRESS, events[0].type);
+  TEST_ASSERT_EQUAL(KEY_EVT_RELEASE, events[1].type);
+  TEST_ASSERT_TRUE(events[1].held_ms < KEY_LONG_PRESS_MS);
+}
+
+void test_key_change_emits_release_then_press() {
+  feed(KEY_TEMP_UP, 0, 100);
+  feed(KEY_123, 100, 200);               // 조합키로 전환
+  TEST_ASSERT_EQUAL(3, count);
+  TEST_ASSERT_EQUAL(KEY_EVT_RELEASE, events[1].type);
+  TEST_ASSERT_EQUAL(KEY_TEMP_UP, events[1].key);
+  TEST_ASSERT_EQUAL(KEY_EVT_PRESS, events[2].type);
+  TEST_ASSERT_EQUAL(KEY_123, events[2].key);
+  TEST_ASSERT_EQUAL(events[1].ts_ms, events[2].ts_ms);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_debounce_rejects_single_sample_glitch);
+  RUN_TEST(test_press_after_debounce_samples);
+  RUN_TEST(test_repeat_300_then_every_100);
+  RUN_TEST(test_repeat_not_lost_with_jittery_period);
+  RUN_TEST(test_power_long_press_fires_once_at_3s);
+  RUN_TEST(test_power_short_press_release_held_below_long);
+  RUN_TEST(test_key_change_emits_release_then_press);
+  return UNITY_END();
+}
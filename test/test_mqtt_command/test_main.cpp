@@ -0,0 +1,304 @@
+// test_main.cpp - MQTT 명령 파서 단위 테스트 + 퍼즈/벤치마크 (pio test -e native)
+//
+// 기준: 이전 파서 (onMessage의 strtok 분리 + atoi + 핸들러별 범위 검사).
+// atoi는 ESP32 newlib 동작(32비트 long strtol - 범위 밖은 포화)으로 재현한다.
+// 동작 차이(의도된 것): 범위를 벗어난 값이 하나라도 있으면 배치 전체 거부,
+// MQTT_CMD_BATCH_MAX개를 넘는 명령은 배치 전체 거부.
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "mqtt/mqttCommand.h"
+
+// 펌웨어 테이블과 같은 이름/타입/범위 (핸들러는 테스트에서 쓰지 않음)
+static const MQTT_COMMAND s_table[] = {
+  { mqttCmdKey("PWR"), "PWR", MQTT_VAL_INT, INT32_MIN, INT32_MAX, nullptr },
+  { mqttCmdKey("TMP"), "TMP", MQTT_VAL_INT, 0,         999,       nullptr },
+  { mqttCmdKey("JSP"), "JSP", MQTT_VAL_INT, 0,         1440,      nullptr },
+  { mqttCmdKey("JSD"), "JSD", MQTT_VAL_INT, 0,         60,        nullptr },
+  { mqttCmdKey("JSF"), "JSF", MQTT_VAL_INT, INT32_MIN, INT32_MAX, nullptr },
+  { mqttCmdKey("RES"), "RES", MQTT_VAL_INT, INT32_MIN, INT32_MAX, nullptr },
+  { mqttCmdKey("CGI"), "CGI", MQTT_VAL_STR, 0,         0,         nullptr },
+};
+static const uint8_t NUM_CMDS = sizeof(s_table) / sizeof(s_table[0]);
+
+static MqttParseResult parse(const char* s, MQTT_CMD_BATCH& b) {
+  return mqttParseWith(s_table, NUM_CMDS, (const uint8_t*)s, strlen(s), b);
+}
+
+// ========== 이전 파서 (기준 모델) ==========
+struct OldCmd {
+  std::string cmd;
+  std::string value;
+};
+
+static int32_t oldAtoi(const char* s) {
+  long long v = strtoll(s, nullptr, 10);   // ESP32: long = 32비트 → strtol이 포화
+  if (v > INT32_MAX) return INT32_MAX;
+  if (v < INT32_MIN) return INT32_MIN;
+  return (int32_t)v;
+}
+
+static void oldParse(const char* payload, std::vector<OldCmd>& out) {
+  char message[256];
+  size_t length = strlen(payload);
+  if (length >= sizeof(message)) length = sizeof(message) - 1;
+  memcpy(message, payload, length);
+  message[length] = '\0';
+
+  char* token = strtok(message, ",");
+  while (token != NULL) {
+    char* cmdStart = strchr(token, '"');
+    if (cmdStart != NULL) {
+      cmdStart++;
+      char* cmdEnd = strchr(cmdStart, '@');
+      if (cmdEnd != NULL) {
+        int cmdLen = cmdEnd - cmdStart;
+        char cmd[8];
+        if (cmdLen < (int)sizeof(cmd)) {
+          strncpy(cmd, cmdStart, cmdLen);
+          cmd[cmdLen] = '\0';
+          char* valueStart = strchr(cmdEnd, ':');
+          if (valueStart != NULL) {
+            valueStart++;
+            while (*valueStart == ' ' || *valueStart == '"') valueStart++;
+            char value[32];
+            int i = 0;
+            while (valueStart[i] && valueStart[i] != '"' && valueStart[i] != '}' && valueStart[i] != ',' && i < 31) {
+              value[i] = valueStart[i];
+              i++;
+            }
+            value[i] = '\0';
+            if (i > 0) out.push_back({cmd, value});
+          }
+        }
+      }
+    }
+    token = strtok(NULL, ",");
+  }
+}
+
+// 이전 파서 결과 → 새 파서가 내야 할 결과
+static MqttParseResult expected(const std::vector<OldCmd>& old, MQTT_CMD_BATCH& want) {
+  want.count = 0;
+  for (size_t k = 0; k < old.size(); k++) {
+    int idx = -1;
+    for (uint8_t i = 0; i < NUM_CMDS; i++) {
+      if (old[k].cmd == s_table[i].name) idx = i;
+    }
+    if (idx < 0) continue;
+    if (want.count >= MQTT_CMD_BATCH_MAX) return MQTT_PARSE_TOO_MANY;
+    MQTT_RX_CMD& c = want.cmd[want.count];
+    c.index = (uint8_t)idx;
+    c.ivalue = 0;
+    c.svalue[0] = '\0';
+    if (s_table[idx].type == MQTT_VAL_INT) {
+      c.ivalue = oldAtoi(old[k].value.c_str());
+      if (c.ivalue < s_table[idx].min || c.ivalue > s_table[idx].max) return MQTT_PARSE_INVALID;  // 이전: 그 명령만 무시
+    } else {
+      strcpy(c.svalue, old[k].value.c_str());
+    }
+    want.count++;
+  }
+  return MQTT_PARSE_OK;
+}
+
+static bool matchesOld(const char* payload, std::string* why) {
+  std::vector<OldCmd> old;
+  oldParse(payload, old);
+  MQTT_CMD_BATCH want, got;
+  MqttParseResult wr = expected(old, want);
+  MqttParseResult gr = parse(payload, got);
+  char buf[192];
+  if (wr != gr) {
+    snprintf(buf, sizeof(buf), "result %d, expected %d", (int)gr, (int)wr);
+    *why = buf;
+    return false;
+  }
+  if (gr != MQTT_PARSE_OK) return true;
+  if (want.count != got.count) {
+    snprintf(buf, sizeof(buf), "count %u, expected %u", got.count, want.count);
+    *why = buf;
+    return false;
+  }
+  for (uint8_t i = 0; i < got.count; i++) {
+    if (want.cmd[i].index != got.cmd[i].index || want.cmd[i].ivalue != got.cmd[i].ivalue ||
+        strcmp(want.cmd[i].svalue, got.cmd[i].svalue) != 0) {
+      snprintf(buf, sizeof(buf), "cmd %u: %s %ld '%s', expected %s %ld '%s'", i,
+               s_table[got.cmd[i].index].name, (long)got.cmd[i].ivalue, got.cmd[i].svalue,
+               s_table[want.cmd[i].index].name, (long)want.cmd[i].ivalue, want.cmd[i].svalue);
+      *why = buf;
+      return false;
+    }
+  }
+  return true;
+}
+
+// ========== 퍼즈 코퍼스 (고정 시드) ==========
+static uint32_t s_rng = 0x2545F491;
+static uint32_t rnd(uint32_t n) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng % n;
+}
+
+static std::string randomValue() {
+  static const char* SPECIAL[] = {
+    "4294967346", "2147483647", "2147483648", "-2147483648", "-2147483649",
+    "99999999999999999999", "0", "-0", "+7", " 12", "\t5", "\n65", "1e3", "0x1F",
+    "110124|espDRY", "", "  ", "-", "+", "999", "1000", "1440", "1441", "60", "61", "-1",
+  };
+  switch (rnd(4)) {
+    case 0: return SPECIAL[rnd(sizeof(SPECIAL) / sizeof(SPECIAL[0]))];
+    case 1: {
+      std::string v;
+      if (rnd(3) == 0) v += "-+ "[rnd(3)];
+      uint32_t n = 1 + rnd(14);
+      for (uint32_t i = 0; i < n; i++) v += (char)('0' + rnd(10));
+      return v;
+    }
+    case 2: {
+      std::string v;
+      uint32_t n = rnd(40);
+      for (uint32_t i = 0; i < n; i++) v += (char)(' ' + rnd(95));
+      return v;
+    }
+    default: return std::to_string((long long)(int32_t)(rnd(0xFFFFFFFFu) ^ (rnd(2) << 31)));
+  }
+}
+
+static std::string randomPayload() {
+  static const char* NAMES[] = {"PWR", "TMP", "JSP", "JSD", "JSF", "RES", "CGI", "XYZ", "TM", "TMPP", "", "tmp", "TMP\"", "LONGNAME"};
+  std::string s = "{";
+  uint32_t items = rnd(11);
+  for (uint32_t i = 0; i < items; i++) {
+    if (i) s += rnd(8) ? ", " : ",,";
+    s += '"';
+    s += NAMES[rnd(sizeof(NAMES) / sizeof(NAMES[0]))];
+    s += rnd(10) ? "@\":" : "\":";
+    bool quoted = rnd(3) == 0;
+    if (quoted) s += '"';
+    s += randomValue();
+    if (quoted) s += '"';
+  }
+  s += '}';
+  // 바이트 변이 (NUL 제외 - 이전 파서는 C 문자열)
+  uint32_t mutations = rnd(3);
+  for (uint32_t m = 0; m < mutations && !s.empty(); m++) {
+    s[rnd(s.size())] = (char)(1 + rnd(255));
+  }
+  if (s.size() > 255) s.resize(255);   // 이전 파서는 255바이트에서 자름, 새 파서는 256 초과를 거부
+  return s;
+}
+
+static std::vector<std::string> corpus(size_t n) {
+  s_rng = 0x2545F491;
+  std::vector<std::string> c;
+  for (size_t i = 0; i < n; i++) c.push_back(randomPayload());
+  return c;
+}
+
+// ========== 테스트 ==========
+void setUp() {}
+void tearDown() {}
+
+void test_basic_batch() {
+  MQTT_CMD_BATCH b;
+  TEST_ASSERT_EQUAL(MQTT_PARSE_OK, parse("{\"PWR@\":1, \"TMP@\":50, \"CGI@\":\"110124|espDRY\"}", b));
+  TEST_ASSERT_EQUAL(3, b.count);
+  TEST_ASSERT_EQUAL_STRING("PWR", s_table[b.cmd[0].index].name);
+  TEST_ASSERT_EQUAL(1, b.cmd[0].ivalue);
+  TEST_ASSERT_EQUAL(50, b.cmd[1].ivalue);
+  TEST_ASSERT_EQUAL_STRING("110124|espDRY", b.cmd[2].svalue);
+}
+
+void test_overflow_saturates_and_is_rejected() {
+  MQTT_CMD_BATCH b;
+  // 2^32 + 50: 32비트 곱셈으로는 50으로 감겨 범위 검사를 통과했음
+  TEST_ASSERT_EQUAL(MQTT_PARSE_INVALID, parse("{\"TMP@\":4294967346}", b));
+  TEST_ASSERT_EQUAL(MQTT_PARSE_INVALID, parse("{\"JSP@\":-4294967296}", b));
+  TEST_ASSERT_EQUAL(MQTT_PARSE_OK, parse("{\"PWR@\":99999999999999999999}", b));
+  TEST_ASSERT_EQUAL(INT32_MAX, b.cmd[0].ivalue);
+}
+
+void test_span_to_int_limits() {
+  struct { const char* s; int32_t v; } cases[] = {
+    {"2147483647", INT32_MAX}, {"2147483648", INT32_MAX}, {"-2147483648", INT32_MIN},
+    {"-2147483649", INT32_MIN}, {"4294967346", INT32_MAX}, {"  -12x", -12}, {"\n\v\f\r7", 7},
+    {"+", 0}, {"", 0}, {"00000000000000000042", 42},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    TEST_ASSERT_EQUAL_INT32(cases[i].v, mqttSpanToInt((const uint8_t*)cases[i].s, strlen(cases[i].s)));
+    TEST_ASSERT_EQUAL_INT32(oldAtoi(cases[i].s), mqttSpanToInt((const uint8_t*)cases[i].s, strlen(cases[i].s)));
+  }
+}
+
+void test_too_many_and_too_long() {
+  MQTT_CMD_BATCH b;
+  std::string s = "{";
+  for (int i = 0; i < MQTT_CMD_BATCH_MAX + 1; i++) s += "\"PWR@\":1,";
+  s += "}";
+  TEST_ASSERT_EQUAL(MQTT_PARSE_TOO_MANY, parse(s.c_str(), b));
+  TEST_ASSERT_EQUAL(0, b.count);
+  std::string big(MQTT_CMD_PAYLOAD_MAX + 1, ' ');
+  TEST_ASSERT_EQUAL(MQTT_PARSE_TOO_LONG, parse(big.c_str(), b));
+}
+
+void test_fuzz_matches_old_parser() {
+  std::vector<std::string> c = corpus(20000);
+  for (size_t i = 0; i < c.size(); i++) {
+    std::string why;
+    if (!matchesOld(c[i].c_str(), &why)) {
+      std::string msg = "payload #" + std::to_string(i) + " '" + c[i] + "': " + why;
+      TEST_FAIL_MESSAGE(msg.c_str());
+    }
+  }
+}
+
+void test_benchmark_against_old_parser() {
+  std::vector<std::string> c = corpus(2000);
+  const int ROUNDS = 20;
+  volatile uint32_t sink = 0;
+
+  clock_t t0 = clock();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < c.size(); i++) {
+      std::vector<OldCmd> old;
+      oldParse(c[i].c_str(), old);
+      for (size_t k = 0; k < old.size(); k++) sink += (uint32_t)oldAtoi(old[k].value.c_str());
+    }
+  }
+  clock_t t1 = clock();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < c.size(); i++) {
+      MQTT_CMD_BATCH b;
+      if (mqttParseWith(s_table, NUM_CMDS, (const uint8_t*)c[i].data(), c[i].size(), b) == MQTT_PARSE_OK) {
+        sink += b.count;
+      }
+    }
+  }
+  clock_t t2 = clock();
+  (void)sink;
+
+  double n = (double)ROUNDS * c.size();
+  char msg[96];
+  snprintf(msg, sizeof(msg), "old: %.0f ns/payload, new: %.0f ns/payload (host)",
+           (t1 - t0) * 1e9 / CLOCKS_PER_SEC / n, (t2 - t1) * 1e9 / CLOCKS_PER_SEC / n);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_basic_batch);
+  RUN_TEST(test_overflow_saturates_and_is_rejected);
+  RUN_TEST(test_span_to_int_limits);
+  RUN_TEST(test_too_many_and_too_long);
+  RUN_TEST(test_fuzz_matches_old_parser);
+  RUN_TEST(test_benchmark_against_old_parser);
+  return UNITY_END();
+}
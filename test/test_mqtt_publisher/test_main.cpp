@@ -0,0 +1,270 @@
+// test_main.cpp - QoS1 발행 엔진 + 브로커 대역 (pio test -e native)
+//
+// mqttPublisher.cpp를 스텁 PubSubClient 위에서 실행한다. 브로커 대역은 PUBLISH 패킷을 해독해
+// 기록하고, 지연 후 PUBACK을 다른 패킷(PINGRESP, QoS0 PUBLISH)과 섞어 조각 단위로 rxTap에 흘린다.
+// 강제 끊김 시 전송 중인 PUBACK과 직전에 보낸 PUBLISH 일부가 사라지며, 재연결 후
+// MQTT Task와 같은 순서(resetRx → onConnected → service)로 복구한다.
+// 검사: 모든 메시지가 최소 1회 전달, 재전송은 같은 패킷 ID + DUP, 처리량/중복률 보고.
+
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "mqtt/mqttPublisher.cpp"
+
+#define SIM_STEP_MS       10
+#define PRODUCE_PERIOD_MS 50        // 생산자: 20 msg/s 시도 (송신함이 차면 대기)
+#define LOST_BEFORE_DROP_MS 100     // 끊김 직전 이 시간 안에 보낸 PUBLISH는 브로커에 도달하지 못함
+
+// ========== 호스트 스텁 정의 ==========
+static uint32_t s_now = 0;
+uint32_t millis() { return s_now; }
+
+static uint32_t s_logWarn = 0;
+static uint32_t s_logInfo = 0;
+BinLog gBinLog;
+BinLog::BinLog() {}
+bool BinLog::write(uint8_t level, const char*, uint8_t, const uint32_t*) {
+  if (level == LOG_LEVEL_WARN) s_logWarn++;
+  if (level == LOG_LEVEL_INFO) s_logInfo++;
+  return true;
+}
+
+// ========== 브로커 대역 ==========
+struct Delivery {
+  uint32_t seq;               // 페이로드 "seq=N"
+  uint16_t packetId;
+  bool dup;
+  uint32_t at;                // 수신 시각
+};
+
+struct PendingAck {
+  uint32_t due;
+  uint16_t packetId;
+};
+
+static MQTTPublisher s_pub;
+static bool s_connected = true;
+static uint32_t s_ackDelayMs = 80;
+static std::vector<Delivery> s_delivered;
+static std::vector<PendingAck> s_acks;
+static uint32_t s_rng = 0x9E3779B9;
+static uint32_t s_lostPublishes = 0;
+
+static uint32_t rnd(uint32_t n) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng % n;
+}
+
+size_t PubSubClient::write(const uint8_t* buf, size_t size) {
+  if (!s_connected) return 0;
+  TEST_ASSERT_EQUAL_HEX8(MQTT_PKT_PUBLISH, buf[0] & 0xF0);
+  uint8_t qos = (buf[0] >> 1) & 0x03;
+  bool dup = (buf[0] & MQTT_FLAG_DUP) != 0;
+  size_t n = 1;
+  uint32_t remaining = 0, mult = 1;
+  uint8_t b;
+  do {
+    b = buf[n++];
+    remaining += (b & 0x7F) * mult;
+    mult *= 128;
+  } while (b & 0x80);
+  TEST_ASSERT_EQUAL(size, n + remaining);
+  uint16_t topicLen = (uint16_t)((buf[n] << 8) | buf[n + 1]);
+  n += 2 + topicLen;
+  uint16_t packetId = 0;
+  if (qos) {
+    packetId = (uint16_t)((buf[n] << 8) | buf[n + 1]);
+    n += 2;
+  }
+  char payload[32] = {0};
+  memcpy(payload, &buf[n], size - n < sizeof(payload) - 1 ? size - n : sizeof(payload) - 1);
+  unsigned seq = 0;
+  TEST_ASSERT_EQUAL(1, sscanf(payload, "seq=%u", &seq));
+  s_delivered.push_back({seq, packetId, dup, s_now});
+  if (qos) s_acks.push_back({s_now + s_ackDelayMs + rnd(40), packetId});
+  return size;
+}
+
+// 브로커 → 장치 스트림: 만기된 PUBACK을 잡음 패킷과 섞어 1~3바이트 조각으로 전달
+static void deliverAcks() {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < s_acks.size();) {
+    if (s_acks[i].due > s_now) { i++; continue; }
+    if (rnd(4) == 0) {
+      stream.push_back(0xD0);   // PINGRESP
+      stream.push_back(0x00);
+    }
+    if (rnd(6) == 0) {
+      // QoS0 PUBLISH (명령) - 본문에 0x40 바이트를 넣어 파서가 경계를 따라가는지 확인
+      const uint8_t pub[] = {0x30, 0x07, 0x00, 0x01, 'H', 0x40, 0x02, 0x00, 0x01};
+      stream.insert(stream.end(), pub, pub + sizeof(pub));
+    }
+    stream.push_back(MQTT_PKT_PUBACK);
+    stream.push_back(0x02);
+    stream.push_back((uint8_t)(s_acks[i].packetId >> 8));
+    stream.push_back((uint8_t)s_acks[i].packetId);
+    s_acks.erase(s_acks.begin() + i);
+  }
+  size_t pos = 0;
+  while (pos < stream.size()) {
+    size_t chunk = 1 + rnd(3);
+    if (pos + chunk > stream.size()) chunk = stream.size() - pos;
+    MQTTPublisher::rxTap(&stream[pos], chunk, &s_pub);
+    pos += chunk;
+  }
+}
+
+static void disconnect() {
+  s_connected = false;
+  s_acks.clear();                      // 전송 중 PUBACK 유실
+  // 직전에 보낸 PUBLISH는 TCP 버퍼에서 사라짐 (브로커 미수신)
+  while (!s_delivered.empty() && s_now - s_delivered.back().at < LOST_BEFORE_DROP_MS) {
+    s_delivered.pop_back();
+    s_lostPublishes++;
+  }
+}
+
+static void reconnect() {
+  s_connected = true;
+  s_pub.resetRx();
+  s_pub.onConnected();
+}
+
+// ========== 시뮬레이션 ==========
+struct SimResult {
+  uint32_t produced;
+  uint32_t durationMs;
+  uint32_t duplicates;
+  uint32_t disconnects;
+};
+
+static SimResult simulate(uint32_t messages, uint32_t disconnectEveryMs, uint32_t downMs) {
+  SimResult r = {};
+  uint32_t nextProduce = 0;
+  uint32_t nextDrop = disconnectEveryMs;
+  uint32_t upAt = 0;
+  char payload[16];
+
+  while (s_now < 3600000UL) {
+    if (s_connected && disconnectEveryMs && s_now >= nextDrop) {
+      disconnect();
+      r.disconnects++;
+      upAt = s_now + downMs;
+      nextDrop = s_now + disconnectEveryMs + rnd(disconnectEveryMs);
+    }
+    if (!s_connected && s_now >= upAt) reconnect();
+
+    if (r.produced < messages && s_now >= nextProduce && s_pub.hasRoom()) {
+      snprintf(payload, sizeof(payload), "seq=%lu", (unsigned long)r.produced);
+      TEST_ASSERT_TRUE(s_pub.submit("skb", payload, 1));
+      r.produced++;
+      nextProduce = s_now + PRODUCE_PERIOD_MS;
+    }
+    if (s_connected) {
+      deliverAcks();
+      s_pub.service();
+    }
+    if (r.produced == messages && s_pub.stats().depth == 0) break;
+    s_now += SIM_STEP_MS;
+  }
+  r.durationMs = s_now;
+
+  std::vector<uint8_t> seen(messages, 0);
+  for (size_t i = 0; i < s_delivered.size(); i++) {
+    TEST_ASSERT_TRUE(s_delivered[i].seq < messages);
+    if (seen[s_delivered[i].seq]++) {
+      r.duplicates++;
+      TEST_ASSERT_TRUE(s_delivered[i].dup);   // 중복은 반드시 DUP 재전송
+    }
+  }
+  for (uint32_t i = 0; i < messages; i++) {
+    if (!seen[i]) {
+      char msg[48];
+      snprintf(msg, sizeof(msg), "seq %lu never delivered", (unsigned long)i);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+  return r;
+}
+
+void setUp() {
+  s_now = 0;
+  s_connected = true;
+  s_ackDelayMs = 80;
+  s_delivered.clear();
+  s_acks.clear();
+  s_rng = 0x9E3779B9;
+  s_lostPublishes = 0;
+  s_logWarn = 0;
+  s_logInfo = 0;
+  static PubSubClient client;
+  s_pub = MQTTPublisher();
+  s_pub.begin(&client);
+}
+
+void tearDown() {}
+
+void test_steady_link_no_retransmits() {
+  SimResult r = simulate(500, 0, 0);
+  const MQTT_PUB_STATS& st = s_pub.stats();
+  TEST_ASSERT_EQUAL(500, st.acked);
+  TEST_ASSERT_EQUAL(500, st.sent);
+  TEST_ASSERT_EQUAL(0, st.retransmits);
+  TEST_ASSERT_EQUAL(0, r.duplicates);
+  TEST_ASSERT_EQUAL(0, st.dropped);
+  TEST_ASSERT_EQUAL(0, s_logInfo + s_logWarn);
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "steady: %lu msgs in %lu ms (%.1f msg/s), %lu retransmits, %lu dup deliveries",
+           (unsigned long)r.produced, (unsigned long)r.durationMs, r.produced * 1000.0 / r.durationMs,
+           (unsigned long)st.retransmits, (unsigned long)r.duplicates);
+  TEST_MESSAGE(msg);
+}
+
+void test_forced_disconnects_lose_nothing() {
+  SimResult r = simulate(1000, 7000, 3000);
+  const MQTT_PUB_STATS& st = s_pub.stats();
+  TEST_ASSERT_TRUE(r.disconnects >= 3);
+  TEST_ASSERT_EQUAL(0, st.inflight);
+  TEST_ASSERT_EQUAL(0, st.dropped);
+  TEST_ASSERT_EQUAL(0, s_logWarn);
+  TEST_ASSERT_TRUE(s_lostPublishes > 0);
+
+  char msg[192];
+  snprintf(msg, sizeof(msg), "flaky link: %lu msgs in %lu ms (%.1f msg/s), %lu disconnects, %lu lost sends, %lu retransmits, %lu dup deliveries",
+           (unsigned long)r.produced, (unsigned long)r.durationMs, r.produced * 1000.0 / r.durationMs,
+           (unsigned long)r.disconnects, (unsigned long)s_lostPublishes, (unsigned long)st.retransmits,
+           (unsigned long)r.duplicates);
+  TEST_MESSAGE(msg);
+}
+
+void test_slow_broker_window_limits_inflight() {
+  s_ackDelayMs = 2000;
+  uint32_t maxInflight = 0;
+  char payload[16];
+  for (uint32_t i = 0; i < MQTT_OUTBOX_LEN; i++) {
+    snprintf(payload, sizeof(payload), "seq=%lu", (unsigned long)i);
+    TEST_ASSERT_TRUE(s_pub.submit("skb", payload, 1));
+  }
+  TEST_ASSERT_FALSE(s_pub.hasRoom());
+  TEST_ASSERT_FALSE(s_pub.submit("skb", "seq=99", 1));   // 가득 참 → LOGW
+  TEST_ASSERT_EQUAL(1, s_logWarn);
+  for (int step = 0; step < 1000 && s_pub.stats().depth; step++) {
+    deliverAcks();
+    s_pub.service();
+    if (s_pub.stats().inflight > maxInflight) maxInflight = s_pub.stats().inflight;
+    s_now += SIM_STEP_MS;
+  }
+  TEST_ASSERT_EQUAL(MQTT_INFLIGHT_WINDOW, maxInflight);
+  TEST_ASSERT_EQUAL(0, s_pub.stats().depth);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_steady_link_no_retransmits);
+  RUN_TEST(test_forced_disconnects_lose_nothing);
+  RUN_TEST(test_slow_broker_window_limits_inflight);
+  return UNITY_END();
+}
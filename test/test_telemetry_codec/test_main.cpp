@@ -0,0 +1,146 @@
+// test_main.cpp - 바이너리 텔레메트리 코덱 왕복/손실/중복 테스트 (pio test -e native)
+
+#include <unity.h>
+#include <string.h>
+#include "mqtt/telemetryCodec.h"
+
+static const uint8_t MAC[6] = {0x24, 0x6F, 0x28, 0x01, 0x02, 0x03};
+
+static TelemetryEncoder enc;
+static TelemetryDecoder dec;
+static uint8_t frame[TELEMETRY_FRAME_MAX];
+
+static TELEMETRY_SAMPLE sample(uint32_t sec, int16_t ntc) {
+  TELEMETRY_SAMPLE s;
+  memset(&s, 0, sizeof(s));
+  s.uptime_ms = sec * 1000;
+  s.fan_current = 120;
+  s.remaining_minute = 90;
+  s.ntc_temp_x10 = ntc;
+  s.sht30_temp_x10 = -200;     // SHT30 미연결 (-20.0℃)
+  s.humidity_x10 = 455;
+  s.seljung_temp_x10 = 600;
+  s.relay_state = 0x06;
+  s.dry_state = 1;
+  s.error_info = 0;
+  return s;
+}
+
+static void assertSame(const TELEMETRY_SAMPLE& a, const TELEMETRY_SAMPLE& b) {
+  TEST_ASSERT_EQUAL_UINT32(a.uptime_ms, b.uptime_ms);
+  TEST_ASSERT_EQUAL_UINT16(a.fan_current, b.fan_current);
+  TEST_ASSERT_EQUAL_UINT16(a.remaining_minute, b.remaining_minute);
+  TEST_ASSERT_EQUAL_INT16(a.ntc_temp_x10, b.ntc_temp_x10);
+  TEST_ASSERT_EQUAL_INT16(a.sht30_temp_x10, b.sht30_temp_x10);
+  TEST_ASSERT_EQUAL_INT16(a.humidity_x10, b.humidity_x10);
+  TEST_ASSERT_EQUAL_INT16(a.seljung_temp_x10, b.seljung_temp_x10);
+  TEST_ASSERT_EQUAL_UINT8(a.relay_state, b.relay_state);
+  TEST_ASSERT_EQUAL_UINT8(a.dry_state, b.dry_state);
+  TEST_ASSERT_EQUAL_UINT8(a.error_info, b.error_info);
+}
+
+// 인코드 → (전송 성공 가정) commit
+static size_t send(const TELEMETRY_SAMPLE& s) {
+  size_t len = enc.encode(s, frame, sizeof(frame));
+  TEST_ASSERT_TRUE(len > 0);
+  enc.commit();
+  return len;
+}
+
+void setUp() {
+  enc = TelemetryEncoder();
+  dec = TelemetryDecoder();
+  enc.begin(MAC, 2511, 4);
+}
+
+void tearDown() {}
+
+void test_roundtrip_keyframe_and_deltas() {
+  TELEMETRY_SAMPLE out;
+  for (uint32_t i = 0; i < 10; i++) {
+    TELEMETRY_SAMPLE s = sample(i, (int16_t)(500 + i));
+    size_t len = send(s);
+    TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+    assertSame(s, out);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(MAC, dec.mac(), 6);
+  TEST_ASSERT_EQUAL_UINT16(2511, dec.fwVersion());
+}
+
+void test_delta_is_smaller_than_keyframe() {
+  size_t key = send(sample(0, 500));
+  size_t delta = send(sample(1, 500));   // 업타임만 변경
+  TEST_ASSERT_TRUE(delta < key);
+  TEST_ASSERT_EQUAL(5 + 4 + 2, delta);
+}
+
+void test_lost_frame_drops_deltas_until_keyframe() {
+  TELEMETRY_SAMPLE out;
+  size_t len = send(sample(0, 500));
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  send(sample(1, 501));                  // 전송 중 손실
+  len = send(sample(2, 502));
+  TEST_ASSERT_EQUAL(TLM_DECODE_NO_BASE, dec.decode(frame, len, out));
+  len = send(sample(3, 503));
+  TEST_ASSERT_EQUAL(TLM_DECODE_NO_BASE, dec.decode(frame, len, out));
+  TELEMETRY_SAMPLE s = sample(4, 504);   // 키프레임 간격 4 → 복구
+  len = send(s);
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  assertSame(s, out);
+}
+
+void test_duplicate_delta_is_ignored() {
+  TELEMETRY_SAMPLE out;
+  size_t len = send(sample(0, 500));
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  TELEMETRY_SAMPLE s1 = sample(1, 510);
+  len = send(s1);
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  TEST_ASSERT_EQUAL(TLM_DECODE_DUPLICATE, dec.decode(frame, len, out));  // QoS1 DUP
+  TELEMETRY_SAMPLE s2 = sample(2, 520);
+  len = send(s2);
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  assertSame(s2, out);
+}
+
+void test_failed_submit_does_not_advance_base() {
+  TELEMETRY_SAMPLE out;
+  size_t len = send(sample(0, 500));
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  enc.encode(sample(1, 510), frame, sizeof(frame));  // submit 실패 → commit 없음
+  TELEMETRY_SAMPLE s = sample(2, 520);
+  len = send(s);
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, dec.decode(frame, len, out));
+  assertSame(s, out);
+}
+
+void test_reset_forces_keyframe() {
+  TELEMETRY_SAMPLE out;
+  send(sample(0, 500));
+  enc.encode(sample(1, 501), frame, sizeof(frame));
+  enc.reset();                           // 재연결
+  TelemetryDecoder fresh;
+  size_t len = send(sample(2, 502));
+  TEST_ASSERT_EQUAL(TLM_DECODE_OK, fresh.decode(frame, len, out));
+  TEST_ASSERT_EQUAL_UINT8(TLM_FLAG_KEYFRAME, frame[1]);
+}
+
+void test_corrupt_frame_rejected() {
+  TELEMETRY_SAMPLE out;
+  size_t len = send(sample(0, 500));
+  frame[6] ^= 0x01;
+  TEST_ASSERT_EQUAL(TLM_DECODE_CRC, dec.decode(frame, len, out));
+  TEST_ASSERT_EQUAL(TLM_DECODE_SHORT, dec.decode(frame, 3, out));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_roundtrip_keyframe_and_deltas);
+  RUN_TEST(test_delta_is_smaller_than_keyframe);
+  RUN_TEST(test_lost_frame_drops_deltas_until_keyframe);
+  RUN_TEST(test_duplicate_delta_is_ignored);
+  RUN_TEST(test_failed_submit_does_not_advance_base);
+  RUN_TEST(test_reset_forces_keyframe);
+  RUN_TEST(test_corrupt_frame_rejected);
+  return UNITY_END();
+}
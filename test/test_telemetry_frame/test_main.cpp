@@ -0,0 +1,148 @@
+// test_main.cpp - zz 프레임 템플릿이 기존 snprintf 출력과 바이트 단위로 같은지 확인 + 속도 비교 (pio test -e native)
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "mqtt/telemetryFrame.h"
+
+static const char* CPUID = "0302016F28240302016F2824";
+
+// 기존 MQTTClient::sendData()의 snprintf 경로 (기준 출력)
+static size_t legacy(const TELEMETRY_SAMPLE& s, char* payload, size_t size) {
+  char zz[256];
+  snprintf(zz, sizeof(zz),
+    "01252769611|770186056655075|%s|01|%04X|%04X|%04X|%04X|00|00|%04X|0000|001E|0032|%02X|0000|%04X|%04X|0000|%04X|0000|%04X|03E8|0000|%04X|",
+    CPUID, 0x0000, 0x0000, s.fan_current, 2511, s.remaining_minute, s.relay_state,
+    (int)s.ntc_temp_x10, (int)s.sht30_temp_x10, (int)s.humidity_x10, (int)s.seljung_temp_x10, 0x0000);
+  uint8_t sum = 0;
+  for (int i = 0; zz[i] != '\0'; i++) sum += zz[i];
+  return snprintf(payload, size, "{\"idx\":0,\"zz\":\"%s%02X\"}", zz, sum);
+}
+
+static TELEMETRY_SAMPLE sample(int16_t ntc, int16_t sht, int16_t hum, int16_t sel) {
+  TELEMETRY_SAMPLE s;
+  memset(&s, 0, sizeof(s));
+  s.fan_current = 0x0123;
+  s.remaining_minute = 90;
+  s.relay_state = 0x06;
+  s.ntc_temp_x10 = ntc;
+  s.sht30_temp_x10 = sht;
+  s.humidity_x10 = hum;
+  s.seljung_temp_x10 = sel;
+  return s;
+}
+
+static TelemetryFrame frame;
+
+void setUp() {
+  frame.begin(CPUID, 2511);
+}
+
+void tearDown() {}
+
+static void assertLegacy(const TELEMETRY_SAMPLE& s) {
+  char expected[384];
+  size_t expLen = legacy(s, expected, sizeof(expected));
+  size_t len;
+  const char* got = frame.build(s, len);
+  TEST_ASSERT_EQUAL(expLen, len);
+  TEST_ASSERT_EQUAL_STRING(expected, got);
+}
+
+void test_positive_values_match_legacy() {
+  assertLegacy(sample(523, 251, 455, 600));
+}
+
+void test_missing_sht30_matches_legacy() {
+  // SHT30 미연결 = -20.0℃ → "FFFFFF38"
+  assertLegacy(sample(523, -200, 0, 600));
+}
+
+void test_width_changes_back_and_forth() {
+  assertLegacy(sample(-15, -200, -1, 600));
+  assertLegacy(sample(12, 300, 455, 600));
+  assertLegacy(sample(-15, 300, 455, -10));
+  assertLegacy(sample(0, 0, 0, 0));
+}
+
+// 무작위 샘플 묶음 (SHT30 미연결 -200 포함, 음수/폭 변화 섞음)
+static std::vector<TELEMETRY_SAMPLE> corpus(int n) {
+  std::vector<TELEMETRY_SAMPLE> c;
+  srand(1234);
+  for (int i = 0; i < n; i++) {
+    TELEMETRY_SAMPLE s = sample((int16_t)(rand() % 2000 - 500), (int16_t)(rand() % 2 ? -200 : rand() % 900),
+                                (int16_t)(rand() % 1100 - 50), (int16_t)(rand() % 800));
+    s.fan_current = (uint16_t)rand();
+    s.remaining_minute = (uint16_t)(rand() % 12001);
+    s.relay_state = (uint8_t)rand();
+    c.push_back(s);
+  }
+  return c;
+}
+
+void test_random_samples_match_legacy() {
+  std::vector<TELEMETRY_SAMPLE> c = corpus(2000);
+  for (size_t i = 0; i < c.size(); i++) assertLegacy(c[i]);
+}
+
+void test_aged_frame_carries_same_zz() {
+  TELEMETRY_SAMPLE s = sample(523, -200, 0, 600);
+  char expected[384];
+  legacy(s, expected, sizeof(expected));
+  char aged[TELEMETRY_FRAME_LEN + 32];
+  size_t len = frame.buildAged(s, 42, aged, sizeof(aged));
+  TEST_ASSERT_EQUAL(strlen(aged), len);
+  const char* prefix = "{\"idx\":0,\"age\":42,\"zz\":\"";
+  TEST_ASSERT_EQUAL_STRING_LEN(prefix, aged, strlen(prefix));
+  TEST_ASSERT_EQUAL_STRING(strstr(expected, "\"zz\":\""), strstr(aged, "\"zz\":\""));
+}
+
+void test_benchmark_against_legacy() {
+  std::vector<TELEMETRY_SAMPLE> c = corpus(2000);
+  const int ROUNDS = 20;
+  volatile uint32_t sink = 0;
+  char payload[TELEMETRY_FRAME_LEN + 32];
+
+  clock_t t0 = clock();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < c.size(); i++) {
+      sink += (uint32_t)legacy(c[i], payload, sizeof(payload));
+    }
+  }
+  clock_t t1 = clock();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < c.size(); i++) {
+      size_t len;
+      sink += (uint32_t)len + (uint8_t)frame.build(c[i], len)[len - 3];
+    }
+  }
+  clock_t t2 = clock();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < c.size(); i++) {
+      sink += (uint32_t)frame.buildAged(c[i], (long)i, payload, sizeof(payload));
+    }
+  }
+  clock_t t3 = clock();
+  (void)sink;
+
+  double n = (double)ROUNDS * c.size();
+  char msg[128];
+  snprintf(msg, sizeof(msg), "legacy: %.0f ns/frame, build: %.0f ns/frame, buildAged: %.0f ns/frame (host)",
+           (t1 - t0) * 1e9 / CLOCKS_PER_SEC / n, (t2 - t1) * 1e9 / CLOCKS_PER_SEC / n,
+           (t3 - t2) * 1e9 / CLOCKS_PER_SEC / n);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_positive_values_match_legacy);
+  RUN_TEST(test_missing_sht30_matches_legacy);
+  RUN_TEST(test_width_changes_back_and_forth);
+  RUN_TEST(test_random_samples_match_legacy);
+  RUN_TEST(test_aged_frame_carries_same_zz);
+  RUN_TEST(test_benchmark_against_legacy);
+  return UNITY_END();
+}
@@ -0,0 +1,325 @@
+// test_main.cpp - TM1638 버스 트레이스 모델 (pio test -e native)
+//
+// tm1638Bus.cpp를 스텁 GPIO 레지스터/사이클 카운터 위에서 실행하고, 핀 변화를 시각과 함께 기록한다.
+// 기록된 파형을 TM1638 수신 모델로 해독해 명령/데이터가 맞는지, 데이터시트 타이밍
+// (CLK 펄스폭 ≥ 400ns, 셋업/홀드 ≥ 100ns, STB 펄스폭 ≥ 1us, CLK↑→STB↑ ≥ 1us, Twait ≥ 1us)을
+// 지키는지 확인하고, 프레임당 버스 시간을 보고한다.
+//
+// 시간 모델 (240MHz): getCycleCount() 호출 1회 = 2사이클, GPIO 레지스터 접근 1회 = 12사이클 (~50ns)
+
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "TM1638Display/tm1638Bus.cpp"
+
+#define PIN_STB 27
+#define PIN_CLK 14
+#define PIN_DIO 15
+
+#define CPU_MHZ       240
+#define CYCLES_CCOUNT 2
+#define CYCLES_GPIO   12
+
+// 데이터시트 최소값 (ns)
+#define T_PW_CLK      400
+#define T_SETUP       100
+#define T_HOLD        100
+#define T_PW_STB      1000
+#define T_CLK_STB     1000
+#define T_WAIT        1000
+
+// ========== 하드웨어 모델 ==========
+struct Edge {
+  uint64_t cycle;
+  uint8_t pin;
+  bool level;
+};
+
+static uint64_t s_cycle = 0;
+static uint32_t s_out = 0;          // 출력 래치
+static uint32_t s_enable = 0;       // 출력 활성
+static std::vector<Edge> s_trace;
+
+// TM1638 수신 모델
+static std::vector<std::vector<uint8_t>> s_transactions;  // STB low 구간별 수신 바이트
+static uint8_t s_shift = 0;
+static uint8_t s_bits = 0;
+static bool s_reading = false;       // 0x42 이후 키 데이터 출력 중
+static uint8_t s_keys[4] = {0};
+static uint8_t s_readBit = 0;
+static bool s_chipDio = true;        // 칩이 내보내는 DIO (풀업 기본 HIGH)
+
+EspClass ESP;
+gpio_dev_t GPIO;
+
+uint32_t EspClass::getCycleCount() {
+  s_cycle += CYCLES_CCOUNT;
+  return (uint32_t)s_cycle;
+}
+
+uint32_t getCpuFrequencyMhz() { return CPU_MHZ; }
+void pinMode(uint8_t pin, uint8_t mode) { if (mode & 0x02) s_enable |= (1UL << pin); }
+int gpio_set_direction(gpio_num_t pin, gpio_mode_t mode) {
+  if (mode & GPIO_MODE_OUTPUT) s_enable |= (1UL << pin);
+  return 0;
+}
+
+static bool level(uint8_t pin) {
+  if (pin == PIN_DIO && !(s_enable & (1UL << PIN_DIO))) return s_chipDio;
+  return (s_out >> pin) & 1;
+}
+
+static void onEdge(uint8_t pin, bool lvl) {
+  s_trace.push_back({s_cycle, pin, lvl});
+  if (pin == PIN_STB) {
+    if (!lvl) {
+      s_transactions.push_back(std::vector<uint8_t>());
+      s_bits = 0;
+      s_readBit = 0;
+    } else {
+      s_reading = false;
+      s_chipDio = true;
+    }
+    return;
+  }
+  if (pin != PIN_CLK || level(PIN_STB)) return;
+  if (s_reading) {
+    // 칩은 CLK 하강 에지에서 다음 비트를 내보냄 (LSB 먼저)
+    if (!lvl && s_readBit < 32) {
+      s_chipDio = (s_keys[s_readBit / 8] >> (s_readBit % 8)) & 1;
+      s_readBit++;
+    }
+    return;
+  }
+  if (lvl) {
+    // CLK 상승 에지에서 DIO 래치 (LSB 먼저)
+    s_shift = (uint8_t)((s_shift >> 1) | (level(PIN_DIO) ? 0x80 : 0));
+    if (++s_bits == 8) {
+      s_transactions.back().push_back(s_shift);
+      s_bits = 0;
+      if (s_transactions.back().size() == 1 && s_shift == 0x42) s_reading = true;
+    }
+  }
+}
+
+void gpioModelWrite(GpioRegId reg, uint32_t value) {
+  s_cycle += CYCLES_GPIO;
+  uint32_t before = 0;
+  for (uint8_t pin = 0; pin < 32; pin++) before |= (uint32_t)level(pin) << pin;
+  switch (reg) {
+    case GPIO_REG_OUT_W1TS: s_out |= value; break;
+    case GPIO_REG_OUT_W1TC: s_out &= ~value; break;
+    case GPIO_REG_ENABLE_W1TS: s_enable |= value; break;
+    case GPIO_REG_ENABLE_W1TC: s_enable &= ~value; break;
+    default: break;                  // 핀 32 이상은 사용하지 않음
+  }
+  for (uint8_t pin = 0; pin < 32; pin++) {
+    bool now = level(pin);
+    if (now != (bool)((before >> pin) & 1)) onEdge(pin, now);
+  }
+}
+
+uint32_t gpioModelRead(bool bank1) {
+  s_cycle += CYCLES_GPIO;
+  if (bank1) return 0;
+  uint32_t v = 0;
+  for (uint8_t pin = 0; pin < 32; pin++) v |= (uint32_t)level(pin) << pin;
+  return v;
+}
+
+static uint32_t ns(uint64_t cycles) { return (uint32_t)(cycles * 1000 / CPU_MHZ); }
+
+// ========== 타이밍 검사 ==========
+struct Timing {
+  uint32_t clkLowMin = UINT32_MAX, clkHighMin = UINT32_MAX;
+  uint32_t setupMin = UINT32_MAX, holdMin = UINT32_MAX;
+  uint32_t stbHighMin = UINT32_MAX, clkStbMin = UINT32_MAX;
+  uint32_t waitMin = UINT32_MAX;
+  uint32_t clkRises = 0, stbCycles = 0;
+};
+
+static Timing analyze() {
+  Timing t;
+  uint64_t lastClk = 0, lastClkRise = 0, lastDio = 0, lastStbHigh = 0;
+  bool haveClk = false, haveDio = false, haveStbHigh = false, pendingHold = false;
+  bool stbLow = false, readPhase = false, waitPending = false;
+  uint32_t bitsInTx = 0;
+  size_t tx = 0;                     // 현재 STB 구간 (s_transactions 인덱스)
+  for (size_t i = 0; i < s_trace.size(); i++) {
+    const Edge& e = s_trace[i];
+    if (e.pin == PIN_CLK) {
+      if (haveClk) {
+        uint32_t w = ns(e.cycle - lastClk);
+        if (e.level) t.clkLowMin = (w < t.clkLowMin) ? w : t.clkLowMin;
+        else t.clkHighMin = (w < t.clkHighMin) ? w : t.clkHighMin;
+      }
+      if (!e.level && waitPending) {
+        uint32_t w = ns(e.cycle - lastClkRise);   // 0x42 마지막 CLK↑ → 첫 읽기 CLK↓
+        t.waitMin = (w < t.waitMin) ? w : t.waitMin;
+        waitPending = false;
+      }
+      if (e.level && stbLow) {
+        t.clkRises++;
+        bitsInTx++;
+        if (haveDio && !readPhase) {
+          uint32_t w = ns(e.cycle - lastDio);
+          t.setupMin = (w < t.setupMin) ? w : t.setupMin;
+        }
+        lastClkRise = e.cycle;
+        pendingHold = !readPhase;
+        if (bitsInTx == 8 && tx < s_transactions.size() && s_transactions[tx][0] == 0x42) {
+          readPhase = true;
+          waitPending = true;
+        }
+      }
+      lastClk = e.cycle;
+      haveClk = true;
+    } else if (e.pin == PIN_DIO) {
+      if (pendingHold && stbLow) {
+        uint32_t w = ns(e.cycle - lastClkRise);
+        t.holdMin = (w < t.holdMin) ? w : t.holdMin;
+      }
+      pendingHold = false;
+      lastDio = e.cycle;
+      haveDio = true;
+    } else if (e.pin == PIN_STB) {
+      if (!e.level) {
+        if (haveStbHigh) {
+          uint32_t w = ns(e.cycle - lastStbHigh);
+          t.stbHighMin = (w < t.stbHighMin) ? w : t.stbHighMin;
+          tx++;
+        }
+        stbLow = true;
+        bitsInTx = 0;
+        t.stbCycles++;
+      } else {
+        if (bitsInTx) {
+          uint32_t w = ns(e.cycle - lastClkRise);
+          t.clkStbMin = (w < t.clkStbMin) ? w : t.clkStbMin;
+        }
+        readPhase = false;
+        waitPending = false;
+        pendingHold = false;
+        stbLow = false;
+        lastStbHigh = e.cycle;
+        haveStbHigh = true;
+      }
+    }
+  }
+  return t;
+}
+
+static void assertDatasheet(const Timing& t) {
+  TEST_ASSERT_GREATER_OR_EQUAL(T_PW_CLK, t.clkLowMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_PW_CLK, t.clkHighMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_SETUP, t.setupMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_HOLD, t.holdMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_PW_STB, t.stbHighMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_CLK_STB, t.clkStbMin);
+}
+
+static TM1638Bus bus;
+
+void setUp() {
+  s_cycle = 0;
+  s_out = 0;
+  s_enable = 0;
+  s_trace.clear();
+  s_transactions.clear();
+  s_reading = false;
+  s_chipDio = true;
+  bus.begin(PIN_STB, PIN_CLK, PIN_DIO);
+  s_trace.clear();
+  s_transactions.clear();
+}
+
+void tearDown() {}
+
+void test_burst_decodes_and_meets_timing() {
+  uint8_t grid[16];
+  for (uint8_t i = 0; i < 16; i++) grid[i] = (uint8_t)(0x11 * i + 3);
+  uint64_t start = s_cycle;
+  bus.writeBurst(0, grid, 16);
+  uint32_t frameNs = ns(s_cycle - start);
+
+  TEST_ASSERT_EQUAL(2, s_transactions.size());
+  TEST_ASSERT_EQUAL(1, s_transactions[0].size());
+  TEST_ASSERT_EQUAL_HEX8(0x40, s_transactions[0][0]);
+  TEST_ASSERT_EQUAL(17, s_transactions[1].size());
+  TEST_ASSERT_EQUAL_HEX8(0xC0, s_transactions[1][0]);
+  TEST_ASSERT_EQUAL_MEMORY(grid, &s_transactions[1][1], 16);
+
+  Timing t = analyze();
+  assertDatasheet(t);
+  TEST_ASSERT_EQUAL(144, t.clkRises);
+  TEST_ASSERT_EQUAL(2, t.stbCycles);
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "burst frame: %u ns, clk low/high min %u/%u ns, setup %u, hold %u, stb high %u, clk->stb %u",
+           (unsigned)frameNs, (unsigned)t.clkLowMin, (unsigned)t.clkHighMin, (unsigned)t.setupMin,
+           (unsigned)t.holdMin, (unsigned)t.stbHighMin, (unsigned)t.clkStbMin);
+  TEST_MESSAGE(msg);
+}
+
+void test_per_digit_path_cost_for_comparison() {
+  // 이전 방식과 같은 구성 (주소+데이터 트랜잭션 16회) - 같은 클록 타이밍에서 버스 시간 비교
+  uint64_t start = s_cycle;
+  for (uint8_t i = 0; i < 16; i++) bus.writeFixed(i, i);
+  uint32_t perDigitNs = ns(s_cycle - start);
+  Timing t = analyze();
+  assertDatasheet(t);
+  TEST_ASSERT_EQUAL(16 * 3 * 8, t.clkRises);   // writeFixed는 0x44 명령 포함
+
+  s_trace.clear();
+  s_transactions.clear();
+  uint8_t grid[16] = {0};
+  start = s_cycle;
+  bus.writeBurst(0, grid, 16);
+  uint32_t burstNs = ns(s_cycle - start);
+  TEST_ASSERT_TRUE(burstNs * 2 < perDigitNs);
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "16 x fixed-address: %u ns, 1 x burst: %u ns", (unsigned)perDigitNs, (unsigned)burstNs);
+  TEST_MESSAGE(msg);
+}
+
+void test_fixed_write_decodes() {
+  bus.writeFixed(6, 0x5B);
+  TEST_ASSERT_EQUAL(2, s_transactions.size());
+  TEST_ASSERT_EQUAL_HEX8(0x44, s_transactions[0][0]);
+  TEST_ASSERT_EQUAL_HEX8(0xC6, s_transactions[1][0]);
+  TEST_ASSERT_EQUAL_HEX8(0x5B, s_transactions[1][1]);
+  assertDatasheet(analyze());
+}
+
+void test_read_keys_returns_chip_bytes_and_waits() {
+  s_keys[0] = 0x22;
+  s_keys[1] = 0x04;
+  s_keys[2] = 0x00;
+  s_keys[3] = 0x81;
+  uint8_t out[4] = {0};
+  uint64_t start = s_cycle;
+  bus.readKeys(out);
+  uint32_t readNs = ns(s_cycle - start);
+  TEST_ASSERT_EQUAL_MEMORY(s_keys, out, 4);
+  TEST_ASSERT_EQUAL_HEX8(0x42, s_transactions[0][0]);
+  TEST_ASSERT_TRUE((s_enable >> PIN_DIO) & 1);   // 읽기 후 DIO 출력 복귀
+
+  Timing t = analyze();
+  TEST_ASSERT_GREATER_OR_EQUAL(T_WAIT, t.waitMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_PW_CLK, t.clkLowMin);
+  TEST_ASSERT_GREATER_OR_EQUAL(T_PW_CLK, t.clkHighMin);
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "key read: %u ns, Twait %u ns", (unsigned)readNs, (unsigned)t.waitMin);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_burst_decodes_and_meets_timing);
+  RUN_TEST(test_per_digit_path_cost_for_comparison);
+  RUN_TEST(test_fixed_write_decodes);
+  RUN_TEST(test_read_keys_returns_chip_bytes_and_waits);
+  return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# binlog_decode.py - BINLOG_OUTPUT_BINARY=1 시리얼 출력을 텍스트로 복원
+#
+# 레코드: A5 5A + <ts_ms u32><fmt u32><level u8><nargs u8><reserved u16><args u32 x BINLOG_MAX_ARGS>
+# fmt와 %s 인자는 펌웨어 주소이므로 빌드한 ELF에서 문자열을 읽는다 (pyelftools 필요).
+#
+# 사용법:
+#   python3 tools/binlog_decode.py .pio/build/<env>/firmware.elf capture.bin
+#   python3 tools/binlog_decode.py .pio/build/<env>/firmware.elf /dev/ttyUSB0 --baud 115200
+
+import re
+import struct
+import sys
+import argparse
+
+from elftools.elf.elffile import ELFFile
+
+MAX_ARGS = 6                      # config.h BINLOG_MAX_ARGS
+RECORD = struct.Struct('<IIBBH%dI' % MAX_ARGS)
+SYNC = b'\xA5\x5A'
+LEVELS = {1: 'E', 2: 'W', 3: 'I', 4: 'D', 5: 'V'}
+SPEC = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(?:hh|h|ll|l|z)?([diouxXcsfFeEgGp%])')
+
+
+class Image:
+    def __init__(self, path):
+        self.sections = []
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            for sec in elf.iter_sections():
+                if sec['sh_addr'] and sec['sh_type'] == 'SHT_PROGBITS':
+                    self.sections.append((sec['sh_addr'], sec.data()))
+
+    def cstr(self, addr):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                return data[addr - base:end].decode('utf-8', 'replace')
+        return '<0x%08x>' % addr
+
+
+def render(img, fmt, args):
+    it = iter(args)
+
+    def conv(m):
+        flags, width, prec, c = m.groups()
+        if c == '%':
+            return '%'
+        if width == '*':
+            width = str(struct.unpack('<i', struct.pack('<I', next(it, 0)))[0])
+        if prec == '*':
+            prec = str(struct.unpack('<i', struct.pack('<I', next(it, 0)))[0])
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        a = next(it, 0)
+        if c in 'fFeEgG':
+            return (spec + c) % struct.unpack('<f', struct.pack('<I', a))[0]
+        if c == 's':
+            return (spec + 's') % img.cstr(a)
+        if c in 'di':
+            return (spec + 'd') % struct.unpack('<i', struct.pack('<I', a))[0]
+        if c == 'u':
+            return (spec + 'd') % a
+        if c == 'c':
+            return chr(a & 0xFF)
+        if c == 'p':
+            return '0x%08x' % a
+        return (spec + c) % a
+
+    return SPEC.sub(conv, fmt)
+
+
+def records(stream):
+    buf = b''
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            i = buf.find(SYNC)
+            if i < 0 or len(buf) < i + 2 + RECORD.size:
+                buf = buf[i:] if i >= 0 else buf[-1:]
+                break
+            yield RECORD.unpack_from(buf, i + 2)
+            buf = buf[i + 2 + RECORD.size:]
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Decode binLog binary records')
+    ap.add_argument('elf')
+    ap.add_argument('input', help='capture file or serial port')
+    ap.add_argument('--baud', type=int, default=115200)
+    opt = ap.parse_args()
+
+    img = Image(opt.elf)
+    if opt.input.startswith('/dev/') or opt.input.upper().startswith('COM'):
+        import serial
+        stream = serial.Serial(opt.input, opt.baud)
+    else:
+        stream = open(opt.input, 'rb')
+
+    for ts, fmt, level, nargs, _, *args in records(stream):
+        text = render(img, img.cstr(fmt), args[:nargs])
+        sys.stdout.write('%6d.%03d %s %s' % (ts // 1000, ts % 1000, LEVELS.get(level, '?'), text))
+        if not text.endswith('\n'):
+            sys.stdout.write('\n')
+
+
+if __name__ == '__main__':
+    main()